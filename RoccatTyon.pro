@@ -1,26 +1,8 @@
-# List all modules that Xcode need for embedding
+# List all modules that Xcode need for embedding. The protocol core
+# in rtcore.pri depends on QtCore only, the UI adds Gui and Widgets.
 QT  += core
 QT  += gui
 QT  += widgets
-QT  += concurrent
-QT  += network
-QT  += dbus
-QT  += opengl
-QT  += svg
-QT  += quick
-QT  += quick3d
-QT  += quick3dutils
-QT  += quick3druntimerender
-#QT  += quickshapes
-QT  += qml
-QT  += qmlmodels
-QT  += qmlworkerscript
-mac {
-    greaterThan(QT_MAJOR_VERSION, 5) {
-        #QT  += core5compats
-        QT  += qmlmeta
-    }
-}
 
 CONFIG += c++17
 CONFIG += lrelease
@@ -60,23 +42,6 @@ mac {
     QMAKE_RPATHDIR += @executable_path/../lib
 
     LIBS += -framework QtCore
-    LIBS += -framework QtConcurrent
-    LIBS += -framework QtCore5Compat
-    LIBS += -framework QtNetwork
-    LIBS += -framework QtDBus
-    LIBS += -framework QtShaderTools
-    LIBS += -framework QtOpenGL
-    LIBS += -framework QtGraphs
-    LIBS += -framework QtSvg
-    LIBS += -framework QtQuick
-    LIBS += -framework QtQuick3D
-    LIBS += -framework QtQuick3DUtils
-    LIBS += -framework QtQuick3DRuntimeRender
-    LIBS += -framework QtQuickShapes
-    LIBS += -framework QtQml
-    LIBS += -framework QtQmlMeta
-    LIBS += -framework QtQmlModels
-    LIBS += -framework QtQmlWorkerScript
     LIBS += -framework QtGui
     LIBS += -framework QtWidgets
 
@@ -103,48 +68,6 @@ mac {
     platforms.path = Contents/PlugIns/platforms
     QMAKE_BUNDLE_DATA += platforms
 
-    # Added to Xcode project
-    canbus.files = \
-        $$QTDIR/plugins/canbus/libqtpassthrucanbus.dylib \
-        $$QTDIR/plugins/canbus/libqtpeakcanbus.dylib \
-        $$QTDIR/plugins/canbus/libqttinycanbus.dylib \
-        $$QTDIR/plugins/canbus/libqtvirtualcanbus.dylib
-    canbus.path = Contents/PlugIns/canbus
-    QMAKE_BUNDLE_DATA += canbus
-
-    # Added to Xcode project
-    generic.files = \
-        $$QTDIR/plugins/generic/libqinsighttracker.dylib \
-        $$QTDIR/plugins/generic/libqtuiotouchplugin.dylib
-    generic.path = Contents/PlugIns/canbus
-    QMAKE_BUNDLE_DATA += generic
-
-    # Added to Xcode project
-    geometryloaders.files = \
-        $$QTDIR/plugins/geometryloaders/libdefaultgeometryloader.dylib \
-        $$QTDIR/plugins/geometryloaders/libgltfgeometryloader.dylib
-    geometryloaders.path = Contents/PlugIns/geometryloaders
-    QMAKE_BUNDLE_DATA += geometryloaders
-
-    # Added to Xcode project
-    geoservices.files = \
-        $$QTDIR/plugins/geoservices/libqtgeoservices_itemsoverlay.dylib \
-        $$QTDIR/plugins/geoservices/libqtgeoservices_osm.dylib
-    geoservices.path = Contents/PlugIns/geoservices
-    QMAKE_BUNDLE_DATA += geoservices
-
-    # Added to Xcode project
-    help.files = \
-        $$QTDIR/plugins/help/libhelpplugin.dylib
-    help.path = Contents/PlugIns/help
-    QMAKE_BUNDLE_DATA += help
-
-    # Added to Xcode project
-    iconengines.files = \
-        $$QTDIR/plugins/iconengines/libqsvgicon.dylib
-    iconengines.path = Contents/PlugIns/iconengines
-    QMAKE_BUNDLE_DATA += iconengines
-
     # Added to Xcode project
     imageformats.files = \
         $$QTDIR/plugins/imageformats/libqgif.dylib \
@@ -154,7 +77,6 @@ mac {
         $$QTDIR/plugins/imageformats/libqmacheif.dylib \
         $$QTDIR/plugins/imageformats/libqmacjp2.dylib \
         $$QTDIR/plugins/imageformats/libqpdf.dylib \
-        $$QTDIR/plugins/imageformats/libqsvg.dylib \
         $$QTDIR/plugins/imageformats/libqtga.dylib \
         $$QTDIR/plugins/imageformats/libqtiff.dylib \
         $$QTDIR/plugins/imageformats/libqwbmp.dylib \
@@ -162,94 +84,17 @@ mac {
     imageformats.path = Contents/PlugIns/imageformats
     QMAKE_BUNDLE_DATA += imageformats
 
-    # Added to Xcode project
-    networkinformation.files = \
-        $$QTDIR/plugins/networkinformation/libqscnetworkreachability.dylib
-    networkinformation.path = Contents/PlugIns/networkinformation
-    QMAKE_BUNDLE_DATA += networkinformation
-
-    # Added to Xcode project
-    platforminputcontexts.files = \
-        $$QTDIR/plugins/platforminputcontexts/libqtvirtualkeyboardplugin.dylib
-    platforminputcontexts.path = Contents/PlugIns/platforminputcontexts
-    QMAKE_BUNDLE_DATA += platforminputcontexts
-
-    # Added to Xcode project
-    renderers.files = \
-        $$QTDIR/plugins/renderers/libopenglrenderer.dylib \
-        $$QTDIR/plugins/renderers/librhirenderer.dylib
-    renderers.path = Contents/PlugIns/renderers
-    QMAKE_BUNDLE_DATA += renderers
-
-    # Added to Xcode project
-    renderplugins.files = \
-        $$QTDIR/plugins/renderplugins/libscene2d.dylib
-    renderplugins.path = Contents/PlugIns/renderplugins
-    QMAKE_BUNDLE_DATA += renderplugins
-
-    # Added to Xcode project
-    sceneparsers.files = \
-        $$QTDIR/plugins/sceneparsers/libassimpsceneimport.dylib \
-        $$QTDIR/plugins/sceneparsers/libgltfsceneexport.dylib \
-        $$QTDIR/plugins/sceneparsers/libgltfsceneimport.dylib
-    sceneparsers.path = Contents/PlugIns/sceneparsers
-    QMAKE_BUNDLE_DATA += sceneparsers
-
-    # Added to Xcode project
-    scxmldatamodel.files = \
-        $$QTDIR/plugins/scxmldatamodel/libqscxmlecmascriptdatamodel.dylib
-    scxmldatamodel.path = Contents/PlugIns/scxmldatamodel
-    QMAKE_BUNDLE_DATA += scxmldatamodel
-
-    # Added to Xcode project
-    sensors.files = \
-        $$QTDIR/plugins/sensors/libqtsensors_generic.dylib
-    sensors.path = Contents/PlugIns/sensors
-    QMAKE_BUNDLE_DATA += sensors
-
     # Added to Xcode project
     styles.files = \
         $$QTDIR/plugins/styles/libqmacstyle.dylib
     styles.path = Contents/PlugIns/styles
     QMAKE_BUNDLE_DATA += styles
 
-    # Added to Xcode project
-    texttospeech.files = \
-        $$QTDIR/plugins/texttospeech/libqtexttospeech_mock.dylib \
-        $$QTDIR/plugins/texttospeech/libqtexttospeech_speechdarwin.dylib
-    texttospeech.path = Contents/PlugIns/texttospeech
-    QMAKE_BUNDLE_DATA += texttospeech
-
-    # Added to Xcode project
-    tls.files = \
-        $$QTDIR/plugins/tls/libqcertonlybackend.dylib \
-        $$QTDIR/plugins/tls/libqopensslbackend.dylib \
-        $$QTDIR/plugins/tls/libqsecuretransportbackend.dylib
-    tls.path = Contents/PlugIns/tls
-    QMAKE_BUNDLE_DATA += tls
-
     # Added to Xcode project
     frameworks.files = \
         $$QTDIR/lib/QtCore.framework \
-        $$QTDIR/lib/QtConcurrent.framework \
-        $$QTDIR/lib/QtNetwork.framework \
-        $$QTDIR/lib/QtDBus.framework \
-        $$QTDIR/lib/QtCore5Compat.framework \
-        $$QTDIR/lib/QtOpenGL.framework \
-        $$QTDIR/lib/QtShaderTools.framework \
-        $$QTDIR/lib/QtSvg.framework \
-        $$QTDIR/lib/QtGraphs.framework \
         $$QTDIR/lib/QtGui.framework \
-        $$QTDIR/lib/QtWidgets.framework \
-        $$QTDIR/lib/QtQuick.framework \
-        $$QTDIR/lib/QtQuickShapes.framework \
-        $$QTDIR/lib/QtQuick3D.framework \
-        $$QTDIR/lib/QtQuick3DRuntimeRender.framework \
-        $$QTDIR/lib/QtQuick3DUtils.framework \
-        $$QTDIR/lib/QtQml.framework  \
-        $$QTDIR/lib/QtQmlMeta.framework \
-        $$QTDIR/lib/QtQmlModels.framework \
-        $$QTDIR/lib/QtQmlWorkerScript.framework
+        $$QTDIR/lib/QtWidgets.framework
     frameworks.path = Contents/Frameworks
     QMAKE_BUNDLE_DATA += frameworks
 
@@ -280,20 +125,15 @@ mac {
     OBJECTIVE_SOURCES += $$PWD/rtmacoshelper.mm
     OBJECTIVE_HEADERS += $$PWD/rtmacoshelper.h
 
-    SOURCES += rthidmacos.cpp
-    HEADERS += rthidmacos.h
-
     # Default rules for deployment.
     target.path = /Application
     INSTALLS += target
 }
 
 linux {
-    LIBS += -lhidapi-hidraw
-    LIBS += -lhidapi-libusb
-    LIBS += -lusb-1.0
-    SOURCES += rthidlinux.cpp
-    HEADERS += rthidlinux.h
+    LIBS += -lxcb
+    SOURCES += $$PWD/rtfocuswatcherx11.cpp
+    HEADERS += $$PWD/rtfocuswatcherx11.h
 
     # Default rules for deployment.
     target.path = /usr/local/bin
@@ -304,34 +144,43 @@ linux {
 #
 ##############################################
 
+include(rtcore.pri)
+
 SOURCES += \
     main.cpp \
-    rtabstractdevice.cpp \
     rtcalibratetcudialog.cpp \
     rtcalibratexcdialog.cpp \
+    rtcalibrationsweep.cpp \
     rtcolordialog.cpp \
-    rtcontroller.cpp \
+    rtfocuswatcher.cpp \
     rtmainwindow.cpp \
+    rtpollrateanalyzer.cpp \
+    rtpollratedialog.cpp \
+    rtpollratewidget.cpp \
+    rtprofilerules.cpp \
     rtprogress.cpp \
     rtshortcutdialog.cpp \
+    rtstartupmetrics.cpp \
     rttablemodel.cpp \
     rttcuimagewidget.cpp \
     rtxceleratorwidget.cpp
 
 HEADERS += \
-    hid_uid.h \
-    rtabstractdevice.h \
     rtcalibratetcudialog.h \
     rtcalibratexcdialog.h \
+    rtcalibrationsweep.h \
     rtcolordialog.h \
-    rtcontroller.h \
-    rthiddevicedbg.hpp \
+    rtfocuswatcher.h \
     rtmainwindow.h \
+    rtpollrateanalyzer.h \
+    rtpollratedialog.h \
+    rtpollratewidget.h \
+    rtprofilerules.h \
     rtprogress.h \
     rtshortcutdialog.h \
+    rtstartupmetrics.h \
     rttablemodel.h \
     rttcuimagewidget.h \
-    rttypedefs.h \
     rtxceleratorwidget.h
 
 FORMS += \
@@ -339,6 +188,7 @@ FORMS += \
     rtcalibratexcdialog.ui \
     rtcolordialog.ui \
     rtmainwindow.ui \
+    rtpollratedialog.ui \
     rtshortcutdialog.ui
 
 TRANSLATIONS += \
@@ -6,6 +6,7 @@
 // SPDX-License-Identifier: GPL-3.0
 // ********************************************************************
 #include "rtmainwindow.h"
+#include "rtstartupmetrics.h"
 #include <QApplication>
 #include <QFile>
 #include <QFileInfo>
@@ -75,6 +76,7 @@ public:
         }
 
         m_window = new RTMainWindow(/*projectFile*/);
+        RTStartupMetrics::watch(m_window);
         m_window->show();
 
         int rc = QApplication::exec();
@@ -135,6 +137,8 @@ private:
 
 int main(int argc, char *argv[])
 {
+    RTStartupMetrics::start();
+
 #ifdef Q_OS_LINUX
     ::setenv("QT_QPA_PLATFORM", "xcb", 0);
 #endif
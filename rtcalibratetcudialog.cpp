@@ -16,15 +16,14 @@ RTCalibrateTcuDialog::RTCalibrateTcuDialog(RTController *device, QWidget *parent
     : QDialog(parent)
     , ui(new Ui::RTCalibrateTcuDialog)
     , m_device(device)
-    , m_timer()
-    , m_image()
     , m_sensor()
     , m_dcu(TYON_DISTANCE_CONTROL_UNIT_OFF)
     , m_tcu(TYON_TRACKING_CONTROL_UNIT_OFF)
     , m_median(0)
-    , m_imageChanged(false)
+    , m_isSaved(false)
     , m_hasError(false)
     , m_count(0)
+    , m_sweep(nullptr)
 {
     ui->setupUi(this);
 
@@ -45,34 +44,51 @@ RTCalibrateTcuDialog::RTCalibrateTcuDialog(RTController *device, QWidget *parent
     ui->progressBar->setMaximum(TCU_MAX_TESTS);
     ui->progressBar->setValue(0);
 
-    m_timer.setTimerType(Qt::PreciseTimer);
-    m_timer.setInterval(300);
-
     m_median = m_device->tcuMedian();
     m_dcu = m_device->dcuState();
     m_tcu = m_device->tcuState();
 
-    connect(&m_timer, &QTimer::timeout, this, &RTCalibrateTcuDialog::onTimer);
     connect(m_device, &RTController::deviceError, this, &RTCalibrateTcuDialog::onDeviceError, Qt::QueuedConnection);
     connect(m_device, &RTController::sensorChanged, this, &RTCalibrateTcuDialog::onSensorChanged, Qt::QueuedConnection);
-    connect(m_device, &RTController::sensorImageChanged, this, &RTCalibrateTcuDialog::onSensorImageChanged, Qt::QueuedConnection);
+
+    // frames arrive from the capture thread by shared reference
+    RTSensorCapture *capture = m_device->sensorCapture();
+    connect(capture, &RTSensorCapture::frameReady, this, &RTCalibrateTcuDialog::onSensorFrame, Qt::QueuedConnection);
+    connect(capture, &RTSensorCapture::statisticsChanged, this, &RTCalibrateTcuDialog::onCaptureStatistics, Qt::QueuedConnection);
 
     connect(ui->pbNextPage, &QPushButton::clicked, this, [this, parent]() { //
         ui->swWizzard->setCurrentIndex(1);
         ui->pbNextPage->setVisible(false);
+        ui->pbSweep->setVisible(false);
+        ui->progressBar->setVisible(true);
+        setParentEnabled(parent, false);
+        m_device->tcuSensorStartCapture();
+    });
+
+    connect(ui->pbSweep, &QPushButton::clicked, this, [this, parent]() { //
+        ui->swWizzard->setCurrentIndex(1);
+        ui->pbNextPage->setVisible(false);
+        ui->pbSweep->setVisible(false);
+        ui->tcuImage->setVisible(false);
         ui->progressBar->setVisible(true);
+        ui->progressBar->setMaximum(RTCalibrationSweep::steps());
+        ui->progressBar->setFormat(tr("Setting %v of %m"));
+        ui->txInstruction->setText(tr("Testing all DCU and TCU settings. Do not move the mouse."));
         setParentEnabled(parent, false);
-        m_timer.start();
+        m_sweep = new RTCalibrationSweep(m_device);
+        connect(m_sweep, &RTCalibrationSweep::sweepProgress, this, &RTCalibrateTcuDialog::onSweepProgress, Qt::QueuedConnection);
+        connect(m_sweep, &QThread::finished, this, &RTCalibrateTcuDialog::onSweepFinished, Qt::QueuedConnection);
+        m_sweep->start(QThread::HighPriority);
     });
 
     connect(ui->pbCancel, &QPushButton::clicked, this, [this, parent]() { //
-        setParentEnabled(parent, true);
         if (!m_isSaved) {
-            m_device->tcuSensorCancel(m_dcu);
             reject();
-        } else {
-            accept();
+            return;
         }
+        m_device->tcuSensorStopCapture();
+        setParentEnabled(parent, true);
+        accept();
     });
 
     connect(ui->pbApply, &QPushButton::clicked, this, [this, parent]() { //
@@ -80,6 +96,16 @@ RTCalibrateTcuDialog::RTCalibrateTcuDialog(RTController *device, QWidget *parent
         const QString msg = tr("Do you want to apply the calibration to the device?\n");
 
         ui->pbApply->setVisible(false);
+        m_device->tcuSensorStopCapture();
+
+        if (m_sweep) {
+            m_isSaved = applySweepResult();
+            setParentEnabled(parent, true);
+            ui->progressBar->setVisible(false);
+            ui->pbCancel->setText(tr("Close"));
+            ui->pbCancel->setDefault(true);
+            return;
+        }
 
         m_device->tcuSensorTest(m_dcu, m_median);
 
@@ -104,10 +130,39 @@ RTCalibrateTcuDialog::RTCalibrateTcuDialog(RTController *device, QWidget *parent
 
 RTCalibrateTcuDialog::~RTCalibrateTcuDialog()
 {
+    stopSweep();
+    m_device->tcuSensorStopCapture();
+    m_device->sensorCapture()->disconnect(this);
     m_device->disconnect(this);
     delete ui;
 }
 
+void RTCalibrateTcuDialog::reject()
+{
+    // 'Cancel', Esc and the window close button leave the previous setting
+    m_device->tcuSensorStopCapture();
+    setParentEnabled(parentWidget(), true);
+    if (m_sweep) {
+        stopSweep();
+    } else if (!m_isSaved) {
+        m_device->tcuSensorCancel(m_dcu);
+    }
+    QDialog::reject();
+}
+
+inline void RTCalibrateTcuDialog::stopSweep()
+{
+    if (!m_sweep) {
+        return;
+    }
+    delete m_sweep;
+    m_sweep = nullptr;
+    // sweep leaves the last tested setting, store the previous one
+    if (!m_isSaved) {
+        m_device->deviceWriteControlUnit(m_dcu, m_tcu == TYON_TRACKING_CONTROL_UNIT_ON, m_median);
+    }
+}
+
 inline void RTCalibrateTcuDialog::setParentEnabled(QWidget *parent, bool enable)
 {
     QMainWindow *mw;
@@ -124,9 +179,7 @@ inline void RTCalibrateTcuDialog::setParentEnabled(QWidget *parent, bool enable)
 
 void RTCalibrateTcuDialog::onDeviceError(int error, const QString &message)
 {
-    if (m_timer.isActive()) {
-        m_timer.stop();
-    }
+    m_device->sensorCapture()->stop();
     ui->txInstruction->setText(tr("ERROR %1: %2").arg(error, 8, 16, QChar('0')).arg(message));
     m_hasError = true;
 }
@@ -139,47 +192,86 @@ void RTCalibrateTcuDialog::onSensorChanged(const TyonSensor &sensor)
     m_sensor = sensor;
 }
 
-void RTCalibrateTcuDialog::onSensorImageChanged(const TyonSensorImage &image)
+void RTCalibrateTcuDialog::onSensorMedianChanged(int median)
 {
 #ifdef QT_DEBUG
-    const int size = TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE;
-    QByteArray d((char *) image.data, size);
-    qDebug("[TCUCAL] onSensorImageChanged: action=%d unused1=%d | image=%s", image.action, image.unused1, qPrintable(d.toHex(' ')));
+    qDebug("[TCUCAL] onSensorMedianChanged: median=%d", median);
 #endif
-    m_imageChanged = true;
-    m_image = image;
+    m_median = median;
 }
 
-void RTCalibrateTcuDialog::onSensorMedianChanged(int median)
+void RTCalibrateTcuDialog::onCaptureStatistics(double fps, quint64 frames, quint64 dropped)
 {
 #ifdef QT_DEBUG
-    qDebug("[TCUCAL] onSensorMedianChanged: median=%d", median);
+    qDebug("[TCUCAL] capture: %.1f fps frames=%llu dropped=%llu", fps, (unsigned long long) frames, (unsigned long long) dropped);
+#else
+    Q_UNUSED(frames);
 #endif
-    m_median = median;
+    ui->progressBar->setFormat(tr("%p% (%1 fps, %2 dropped)").arg(fps, 0, 'f', 1).arg(dropped));
+}
+
+void RTCalibrateTcuDialog::onSweepProgress(int step, int steps)
+{
+    Q_UNUSED(steps);
+    ui->progressBar->setValue(step);
 }
 
-void RTCalibrateTcuDialog::onTimer()
+void RTCalibrateTcuDialog::onSweepFinished()
 {
-    const int imgSize = TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE;
+    static const char *const dcuNames[] = {
+        QT_TR_NOOP("Off"),
+        QT_TR_NOOP("Extra low"),
+        QT_TR_NOOP("Low"),
+        QT_TR_NOOP("Normal"),
+    };
 
-    if (m_hasError) {
+    ui->progressBar->setVisible(false);
+    const RTCalibrationSweep::TResults results = m_sweep->results();
+    if (results.isEmpty() || m_hasError) {
+        ui->txInstruction->setText(tr("Sweep failed. Click 'Cancel' to restore the previous setting."));
         return;
     }
 
-    m_device->tcuSensorCaptureImage();
-    m_device->tcuSensorReadImage();
+    QString text = tr("Ranking (score, contrast, noise):\n");
+    for (int i = 0; i < results.size() && i < 4; i++) {
+        const RTCalibrationSweep::TResult &r = results.at(i);
+        text += tr("%1. DCU %2, TCU %3: %4 (%5, %6)\n")
+                    .arg(i + 1)
+                    .arg(tr(dcuNames[r.dcu]), r.tcu ? tr("on") : tr("off"))
+                    .arg(r.score, 0, 'f', 2)
+                    .arg(r.contrast, 0, 'f', 1)
+                    .arg(r.temporalNoise, 0, 'f', 2);
+    }
+    text += tr("\nPress 'Apply' to store the first setting or 'Cancel' to keep the previous one.");
+    ui->txInstruction->setText(text);
+    ui->pbApply->setVisible(true);
+    ui->pbApply->setDefault(true);
+    ui->pbApply->setFocus();
+}
 
-    ++m_count;
-    ui->progressBar->setValue(m_count);
+inline bool RTCalibrateTcuDialog::applySweepResult()
+{
+    const RTCalibrationSweep::TResults results = m_sweep->results();
+    if (results.isEmpty()) {
+        return false;
+    }
+    const RTCalibrationSweep::TResult &best = results.first();
+    if (!m_device->deviceWriteControlUnit(best.dcu, best.tcu, best.median)) {
+        return false;
+    }
+    ui->txInstruction->setText(tr("Well done! Click 'Close' button."));
+    return true;
+}
 
-    m_imageChanged = false;
-    QVector<quint8> data = QVector<quint8>();
-    for (int i = 0; i < imgSize; i++) {
-        data.append(m_image.data[i]);
+void RTCalibrateTcuDialog::onSensorFrame(const TSensorFrameRef &frame)
+{
+    // frames queued before the capture stopped
+    if (m_hasError || m_count >= TCU_MAX_TESTS) {
+        return;
     }
-    ui->tcuImage->setImageData(data, imgSize);
 
-    m_median = m_device->tcuSensorReadMedian(&m_image);
+    ui->tcuImage->setImageData(frame->image.data, TYON_SENSOR_IMAGE_SIZE);
+    m_median = frame->median;
 
     ++m_count;
     ui->progressBar->setValue(m_count);
@@ -192,6 +284,6 @@ void RTCalibrateTcuDialog::onTimer()
         ui->pbApply->setVisible(true);
         ui->pbApply->setDefault(true);
         ui->pbApply->setFocus();
-        m_timer.stop();
+        m_device->sensorCapture()->stop();
     }
 }
@@ -7,9 +7,9 @@
 // ********************************************************************
 #pragma once
 
+#include "rtcalibrationsweep.h"
 #include "rtcontroller.h"
 #include <QDialog>
-#include <QTimer>
 
 namespace Ui {
 class RTCalibrateTcuDialog;
@@ -23,27 +23,32 @@ public:
     explicit RTCalibrateTcuDialog(RTController *device, QWidget *parent = nullptr);
     ~RTCalibrateTcuDialog();
 
+public slots:
+    void reject() override;
+
 private slots:
     void onDeviceError(int error, const QString &message);
     void onSensorChanged(const TyonSensor &sensor);
-    void onSensorImageChanged(const TyonSensorImage &image);
+    void onSensorFrame(const TSensorFrameRef &frame);
+    void onCaptureStatistics(double fps, quint64 frames, quint64 dropped);
     void onSensorMedianChanged(int median);
-    void onTimer();
+    void onSweepProgress(int step, int steps);
+    void onSweepFinished();
 
 private:
     Ui::RTCalibrateTcuDialog *ui;
     RTController *m_device;
-    QTimer m_timer;
-    TyonSensorImage m_image;
     TyonSensor m_sensor;
     TyonControlUnitDcu m_dcu;
     TyonControlUnitTcu m_tcu;
     int m_median;
     bool m_isSaved;
-    bool m_imageChanged;
     bool m_hasError;
     int m_count;
+    RTCalibrationSweep *m_sweep;
 
 private:
     inline void setParentEnabled(QWidget *parent, bool enable = true);
+    inline void stopSweep();
+    inline bool applySweepResult();
 };
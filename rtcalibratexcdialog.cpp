@@ -11,46 +11,20 @@
 #include <QMainWindow>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QScreen>
 #include <QThread>
 
-enum {
-    PHASE_MID = 0,
-    PHASE_WAIT_CHANGE_MAX,
-    PHASE_WAIT_TIME_MAX,
-    PHASE_MAX,
-    PHASE_WAIT_CHANGE_MIN,
-    PHASE_WAIT_TIME_MIN,
-    PHASE_MIN,
-    PHASE_END,
-};
-
-static const uint next_phases[] = {
-    PHASE_WAIT_CHANGE_MAX,
-    PHASE_WAIT_TIME_MAX,
-    PHASE_MAX,
-    PHASE_WAIT_CHANGE_MIN,
-    PHASE_WAIT_TIME_MIN,
-    PHASE_MIN,
-    PHASE_END,
-    PHASE_END,
-};
-
-#define AVERAGE_SHIFT 7;
-static uint const validCount = 1 << AVERAGE_SHIFT;
-
 RTCalibrateXCDialog::RTCalibrateXCDialog(RTController *device, QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::RTCalibrateXCDialog)
     , m_device(device)
     , m_instructions()
     , m_isSaved(false)
-    , m_stage(0)
-    , m_count(0)
-    , m_start()
-    , m_lastValue(0)
+    , m_stage(RTXCCalibrator::PhaseMid)
     , m_min(255)
     , m_max(0)
     , m_mid(0)
+    , m_frameTimer()
 {
     ui->setupUi(this);
     ui->swWizzard->setCurrentIndex(0);
@@ -73,13 +47,18 @@ RTCalibrateXCDialog::RTCalibrateXCDialog(RTController *device, QWidget *parent)
     m_instructions.append(tr("Calibration completed.\n\nClick button 'Apply' to save the calibration or button 'Cancel' to close without saving."));
 
     connect(m_device, &RTController::deviceError, this, &RTCalibrateXCDialog::onDeviceError, Qt::QueuedConnection);
-    connect(m_device, &RTController::specialReport, this, &RTCalibrateXCDialog::onSpecialReport, Qt::QueuedConnection);
+
+    // paddle values are pulled once per display frame, see startFrameTimer()
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameTimer, &QTimer::timeout, this, &RTCalibrateXCDialog::onFrameTimer);
 
     connect(ui->pbNextPage, &QPushButton::clicked, this, [this, parent]() { //
         ui->swWizzard->setCurrentIndex(1);
         ui->pbNextPage->setVisible(false);
+        m_device->xcStream()->reset();
         m_device->xcStartCalibration();
         setParentEnabled(parent, false);
+        startFrameTimer();
     });
 
     connect(ui->pbApply, &QPushButton::clicked, this, [this, parent]() { //
@@ -101,6 +80,7 @@ RTCalibrateXCDialog::RTCalibrateXCDialog(RTController *device, QWidget *parent)
     });
 
     connect(ui->pbCancel, &QPushButton::clicked, this, [this, parent]() { //
+        m_frameTimer.stop();
         m_device->xcStopCalibration();
         setParentEnabled(parent, true);
         if (!m_isSaved) {
@@ -113,6 +93,7 @@ RTCalibrateXCDialog::RTCalibrateXCDialog(RTController *device, QWidget *parent)
 
 RTCalibrateXCDialog::~RTCalibrateXCDialog()
 {
+    m_frameTimer.stop();
     m_device->disconnect(this);
     delete ui;
 }
@@ -122,96 +103,33 @@ void RTCalibrateXCDialog::onDeviceError(int error, const QString &message)
     ui->txInstruction->setText(tr("ERROR %1: %2").arg(error, 8, 16, QChar('0')).arg(message));
 }
 
-void RTCalibrateXCDialog::onSpecialReport(uint, const QByteArray &report)
+void RTCalibrateXCDialog::onFrameTimer()
 {
-    TyonSpecial *p = (TyonSpecial *) report.constData();
+    // latest paddle value since the previous frame, for the indicator
+    const RTXCeleratorStream::TSample s = m_device->xcStream()->take();
+    if (s.count > 0) {
+        ui->vslXCelerate->setValue(s.value);
+    }
 
-    // sane check
-    if ((ulong) report.length() < sizeof(TyonSpecial)) {
+    // the calibrator runs on the input thread with every value
+    const RTXCCalibrator::TProgress p = m_device->xcCalibrator()->progress();
+    if (p.phase == m_stage) {
         return;
     }
 
-    int value = p->action;
-
-    switch (m_stage) {
-        case PHASE_MID: {
-            if (inRange(value, m_lastValue, 10)) {
-                m_count += 1;
-                m_mid += value;
-                ui->vslXCelerate->setValue(value);
-                if (m_count == validCount) {
-                    m_mid = m_mid >> AVERAGE_SHIFT;
-                    nextPhase();
-                }
-            } else {
-                m_mid = 0;
-                m_count = 0;
-            }
-            break;
-        }
-        case PHASE_MAX: {
-            if (inRange(value, m_lastValue, 10)) {
-                m_count += 1;
-                m_max += value;
-                if (value > ui->vslXCelerate->maximum()) {
-                    ui->vslXCelerate->setMaximum(value);
-                    ui->vslXCelerate->setValue(m_max);
-                }
-                if (m_count == validCount) {
-                    m_max = m_max >> AVERAGE_SHIFT;
-                    nextPhase();
-                }
-            } else {
-                m_max = 0;
-                m_count = 0;
-            }
-            break;
-        }
-        case PHASE_MIN: {
-            if (inRange(value, m_lastValue, 10)) {
-                m_count += 1;
-                m_min += value;
-                if (value < ui->vslXCelerate->minimum()) {
-                    ui->vslXCelerate->setMinimum(value);
-                    ui->vslXCelerate->setValue(value);
-                }
-                if (m_count == validCount) {
-                    m_min = m_min >> AVERAGE_SHIFT;
-                    nextPhase();
-                }
-            } else {
-                m_min = 0;
-                m_count = 0;
-            }
-            break;
-        }
-        case PHASE_WAIT_TIME_MAX:
-        case PHASE_WAIT_TIME_MIN: {
-            /* 1 second grace period */
-            if (m_start.msecsTo(QTime::currentTime()) >= 1000) {
-                nextPhase();
-            }
-            break;
-        }
-        case PHASE_WAIT_CHANGE_MAX: { /* values < mid */
-            if ((value + 20) < m_mid)
-                nextPhase();
-            break;
-        }
-        case PHASE_WAIT_CHANGE_MIN: { /* values > mid */
-            if (value > (m_mid + 20))
-                nextPhase();
-            break;
-        }
-        case PHASE_END:
-            ui->vslXCelerate->setVisible(false);
-            ui->txInstruction->setText(m_instructions[3]);
-            ui->pbNextPage->setVisible(false);
-            ui->pbApply->setVisible(true);
-            m_stage += 1;
-            break;
-        default:
-            break;
+    setPhase(p.phase);
+
+    if (p.phase == RTXCCalibrator::PhaseDone) {
+        m_frameTimer.stop();
+        m_mid = p.mid;
+        m_max = p.max;
+        m_min = p.min;
+#ifdef QT_DEBUG
+        qDebug("[XCCAL] mid=%d max=%d min=%d rejected=%u", m_mid, m_max, m_min, p.rejected);
+#endif
+        ui->vslXCelerate->setVisible(false);
+        ui->pbNextPage->setVisible(false);
+        ui->pbApply->setVisible(true);
     }
 }
 
@@ -229,21 +147,16 @@ inline void RTCalibrateXCDialog::setParentEnabled(QWidget *parent, bool enable)
     }
 }
 
-inline bool RTCalibrateXCDialog::inRange(qint32 a, qint32 b, qint32 range)
+inline void RTCalibrateXCDialog::startFrameTimer()
 {
-    return ((a - b) < range || (b - a) < range) ? true : false;
+    const qreal rate = (screen() ? screen()->refreshRate() : 60.0);
+    m_frameTimer.start(qMax(1, qRound(1000.0 / (rate > 0 ? rate : 60.0))));
 }
 
-inline void RTCalibrateXCDialog::setPhase(uint phase)
+inline void RTCalibrateXCDialog::setPhase(RTXCCalibrator::TPhase phase)
 {
-    const uint phaseidx[] = {0, 1, 1, 1, 2, 2, 2, 3};
-    m_start = QTime::currentTime();
+    // mid, up (max) and down (min) instruction per calibrator phase
+    const uint phaseidx[] = {0, 1, 1, 2, 2, 3};
     m_stage = phase;
-    m_count = 0;
     ui->txInstruction->setText(m_instructions[phaseidx[phase]]);
 }
-
-inline void RTCalibrateXCDialog::nextPhase()
-{
-    setPhase(next_phases[m_stage]);
-}
@@ -9,7 +9,7 @@
 
 #include "rtcontroller.h"
 #include <QDialog>
-#include <QTime>
+#include <QTimer>
 
 namespace Ui {
 class RTCalibrateXCDialog;
@@ -25,24 +25,21 @@ public:
 
 private slots:
     void onDeviceError(int error, const QString &message);
-    void onSpecialReport(uint reportId, const QByteArray &report);
+    void onFrameTimer();
 
 private:
     Ui::RTCalibrateXCDialog *ui;
     RTController *m_device;
     QStringList m_instructions;
     bool m_isSaved;
-    uint m_stage;
-    uint m_count;
-    QTime m_start;
-    qint32 m_lastValue;
+    RTXCCalibrator::TPhase m_stage;
     qint32 m_min;
     qint32 m_max;
     qint32 m_mid;
+    QTimer m_frameTimer;
 
 private:
     inline void setParentEnabled(QWidget *parent, bool enable = true);
-    inline bool inRange(qint32 a, qint32 b, qint32 range);
-    inline void setPhase(uint phase);
-    inline void nextPhase();
+    inline void setPhase(RTXCCalibrator::TPhase phase);
+    inline void startFrameTimer();
 };
@@ -0,0 +1,155 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtcalibrationsweep.h"
+#include "rtcontroller.h"
+#include "rtsensorstats.h"
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include <math.h>
+
+#define RT_PIXELS (TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE)
+
+// DCU levels swept, in order
+static const TyonControlUnitDcu s_dcuLevels[] = {
+    TYON_DISTANCE_CONTROL_UNIT_OFF,
+    TYON_DISTANCE_CONTROL_UNIT_EXTRA_LOW,
+    TYON_DISTANCE_CONTROL_UNIT_LOW,
+    TYON_DISTANCE_CONTROL_UNIT_NORMAL,
+};
+
+// Score the frames of one setting. Texture contrast over temporal noise,
+// reduced for images close to black or saturation.
+static void scoreFrames(const QVector<TyonSensorImage> *frames, RTCalibrationSweep::TResult *r)
+{
+    quint64 sum[RT_PIXELS] = {};
+    quint64 sumSquares[RT_PIXELS] = {};
+    double mean = 0, contrast = 0;
+
+    for (const TyonSensorImage &image : *frames) {
+        TSensorStats stats;
+        RTSensorStats::compute(&image, &stats);
+        mean += stats.mean;
+        contrast += sqrt(stats.variance);
+        for (int p = 0; p < RT_PIXELS; p++) {
+            const quint32 v = image.data[p];
+            sum[p] += v;
+            sumSquares[p] += v * v;
+        }
+    }
+
+    const double n = frames->size();
+    double noise = 0;
+    for (int p = 0; p < RT_PIXELS; p++) {
+        const double m = sum[p] / n;
+        noise += sqrt(qMax(0.0, sumSquares[p] / n - m * m));
+    }
+
+    r->frames = (int) n;
+    r->mean = mean / n;
+    r->contrast = contrast / n;
+    r->temporalNoise = noise / RT_PIXELS;
+
+    const double exposure = 1.0 - qMin(1.0, fabs(r->mean - 128.0) / 128.0);
+    r->score = r->contrast / (r->temporalNoise + 1.0) * (0.5 + 0.5 * exposure);
+}
+
+// -------------------------------------------------------------
+
+RTCalibrationSweep::RTCalibrationSweep(RTController *controller, int frames)
+    : QThread(nullptr)
+    , m_controller(controller)
+    , m_frames(qMax(frames, 2))
+    , m_results()
+{}
+
+RTCalibrationSweep::~RTCalibrationSweep()
+{
+    requestInterruption();
+    wait();
+}
+
+int RTCalibrationSweep::steps()
+{
+    return (int) (sizeof(s_dcuLevels) / sizeof(s_dcuLevels[0])) * 2;
+}
+
+inline bool RTCalibrationSweep::configure(TyonControlUnitDcu dcu, bool tcu, uint median)
+{
+    if (isInterruptionRequested()) {
+        return false;
+    }
+    // TCU on is only tested, the caller stores the final setting
+    return m_controller->deviceWriteControlUnit(dcu, tcu, median, false);
+}
+
+void RTCalibrationSweep::run()
+{
+    const RTSensorStats::TMetric metric = m_controller->tcuMetric();
+    const int total = steps();
+    QVector<QVector<TyonSensorImage>> frames(total);
+    TResults results(total);
+    // own pool, waitForDone() must not wait for tasks of other modules
+    QThreadPool pool;
+    bool ok = true;
+    int step = 0;
+
+    // TCU test needs a median, start with the stored one
+    uint median = m_controller->tcuMedian();
+
+    for (const TyonControlUnitDcu dcu : s_dcuLevels) {
+        for (const bool tcu : {false, true}) {
+            TResult *r = &results[step];
+            r->dcu = dcu;
+            r->tcu = tcu;
+            // the value written and tested, applied as is
+            r->median = median;
+
+            if (!(ok = configure(dcu, tcu, median))) {
+                break;
+            }
+
+            QVector<TyonSensorImage> *buffer = &frames[step];
+            buffer->resize(m_frames);
+            for (int i = 0; i < m_frames && ok; i++) {
+                ok = m_controller->tcuSensorCaptureFrame(&(*buffer)[i]);
+            }
+            if (!ok) {
+                break;
+            }
+
+            // the TCU off capture provides the median for the TCU on test
+            if (!tcu) {
+                TSensorStats stats;
+                RTSensorStats::compute(&buffer->last(), &stats);
+                median = RTSensorStats::metric(stats, metric);
+            }
+
+            // score while the next setting is captured
+            pool.start([buffer, r]() { //
+                scoreFrames(buffer, r);
+            });
+            emit sweepProgress(++step, total);
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    pool.waitForDone();
+
+    if (!ok) {
+        emit sweepFailed();
+        return;
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const TResult &a, const TResult &b) { //
+        return a.score > b.score;
+    });
+    m_results = results;
+}
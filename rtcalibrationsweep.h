@@ -0,0 +1,82 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rttypedefs.h"
+#include <QList>
+#include <QMetaType>
+#include <QThread>
+#include <QtCore/QtGlobal>
+
+class RTController;
+
+/**
+ * @brief The RTCalibrationSweep thread captures sensor frames for every
+ * DCU level with TCU on and off, scores the surface quality of each
+ * setting and ranks them. Frame statistics are computed on a pool of the
+ * sweep while the next setting is captured. The device is left in
+ * the last tested setting, the caller stores either the recommendation or
+ * the previous setting with one RTController::deviceWriteControlUnit().
+ */
+class RTCalibrationSweep : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Result of one DCU/TCU setting
+     */
+    typedef struct
+    {
+        TyonControlUnitDcu dcu;
+        bool tcu;
+        int frames;           // captured frames
+        double mean;          // mean brightness
+        uint median;          // TCU median written for this setting
+        double contrast;      // mean spatial standard deviation (surface texture)
+        double temporalNoise; // mean per-pixel standard deviation over time
+        double score;         // higher is better
+    } TResult;
+    typedef QList<TResult> TResults;
+
+    /**
+     * @brief Constructor
+     * @param controller Device controller used for the HID access
+     * @param frames Frames to capture per setting
+     */
+    explicit RTCalibrationSweep(RTController *controller, int frames = 20);
+
+    /**
+     * @brief Stop the sweep and wait for the thread
+     */
+    ~RTCalibrationSweep();
+
+    /**
+     * @brief Number of settings (DCU levels x TCU on/off)
+     */
+    static int steps();
+
+    /**
+     * @brief Return the settings ordered best first, valid after finished()
+     */
+    TResults results() const { return m_results; }
+
+    void run() override;
+
+signals:
+    void sweepProgress(int step, int steps);
+    void sweepFailed();
+
+private:
+    RTController *m_controller;
+    int m_frames;
+    TResults m_results;
+
+private:
+    inline bool configure(TyonControlUnitDcu dcu, bool tcu, uint median);
+};
+Q_DECLARE_METATYPE(RTCalibrationSweep::TResult)
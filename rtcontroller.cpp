@@ -8,22 +8,15 @@
 #include "rtcontroller.h"
 #include "hid_uid.h"
 #include "rttypedefs.h"
-#include <QApplication>
-#include <QColor>
 #include <QCoreApplication>
 #include <QDeadlineTimer>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
-#include <QInputMethod>
-#include <QKeySequence>
 #include <QLocale>
 #include <QMutexLocker>
-#include <QRgb>
-#include <QRgba64>
-#include <QRgbaFloat16>
-#include <QRgbaFloat32>
 #include <QStandardPaths>
 #include <QThread>
 #include <QTimer>
@@ -40,6 +33,12 @@
 #include "rthiddevicedbg.hpp"
 #endif
 
+/* The control status is polled with an exponential backoff, a ready
+ * device answers within a few milliseconds. A reset takes longer. */
+#define RT_RESET_TIMEOUT_MS 8000
+#define RT_POLL_FIRST_MS 2
+#define RT_POLL_LAST_MS 64
+
 typedef struct
 {
     quint8 uid_key;
@@ -184,7 +183,36 @@ RTController::RTController(QObject *parent)
     , m_controlUnit()
     , m_requestedProfile(0)
     , m_initComplete(false)
-{
+    , m_slotCache()
+    , m_sensorCapture(new RTSensorCapture(this))
+    , m_sensorRegisters()
+    , m_xcStream()
+    , m_xcCalibrator()
+    , m_xcJoystick()
+    , m_hotkeys()
+    , m_hotkeyReports()
+    , m_easyshiftLocked(false)
+    , m_talkFxEngine()
+    , m_macroPlayer()
+    , m_tcuMetric(RTSensorStats::MetricMean)
+    , m_syncOnConnect(true)
+    , m_autoSave(true)
+    , m_lookupTimer()
+    , m_lookupThread(nullptr)
+    , m_syncThread(nullptr)
+    , m_jobThread(nullptr)
+    , m_jobContext(nullptr)
+    , m_syncedProfiles(RT_PROFILES_ALL)
+    , m_transactionMutex()
+    , m_transactionStats()
+    , m_scheduler()
+    , m_fastWrites(false)
+    , m_statusClock()
+    , m_statusOkAt(-1)
+    , m_keyboardLocale(QLocale::system())
+{
+    m_statusClock.start();
+
     initButtonTypes();
     initPhysicalButtons();
     initializeColorMapping();
@@ -199,10 +227,11 @@ RTController::RTController(QObject *parent)
     m_hid = new RTHidLinux(this);
 #endif
 
+    // lookup results arrive from the lookup thread on Linux
     Qt::ConnectionType ct = Qt::DirectConnection;
-    connect(m_hid, &RTAbstractDevice::lookupStarted, this, &RTController::onLookupStarted, ct);
-    connect(m_hid, &RTAbstractDevice::deviceFound, this, &RTController::onDeviceFound, ct);
-    connect(m_hid, &RTAbstractDevice::deviceRemoved, this, &RTController::onDeviceRemoved, ct);
+    connect(m_hid, &RTAbstractDevice::lookupStarted, this, &RTController::onLookupStarted, Qt::AutoConnection);
+    connect(m_hid, &RTAbstractDevice::deviceFound, this, &RTController::onDeviceFound, Qt::AutoConnection);
+    connect(m_hid, &RTAbstractDevice::deviceRemoved, this, &RTController::onDeviceRemoved, Qt::AutoConnection);
     connect(m_hid, &RTAbstractDevice::errorOccured, this, &RTController::onErrorOccured, ct);
     connect(m_hid, &RTAbstractDevice::inputReady, this, &RTController::onInputReady, ct);
         
@@ -212,7 +241,26 @@ RTController::RTController(QObject *parent)
 
 RTController::~RTController()
 {
-    internalSaveProfiles();
+    m_hotkeys.close();
+    m_talkFxEngine.close();
+    m_macroPlayer.close();
+    if (m_syncThread) {
+        m_syncThread->requestInterruption();
+        m_syncThread->wait();
+    }
+    if (m_lookupThread) {
+        m_lookupThread->wait();
+    }
+    if (m_jobThread) {
+        // queued jobs are dropped, the running one completes
+        m_jobThread->quit();
+        m_jobThread->wait();
+        delete m_jobThread;
+    }
+    delete m_sensorCapture;
+    if (m_autoSave) {
+        internalSaveProfiles();
+    }
     if (m_hid) {
         m_hid->disconnect(this);
         delete m_hid;
@@ -222,81 +270,226 @@ RTController::~RTController()
 
 void RTController::onLookupStarted()
 {
+    // periodic lookups of the HID layer start without lookupDevice()
+    if (!m_lookupTimer.isValid()) {
+        m_lookupTimer.start();
+    }
     emit lookupStarted();
 }
 
 void RTController::onDeviceFound(THidDeviceType type)
 {
-    QThread *t = new QThread();
-    connect(t, &QThread::started, this, [this, t, type]() {
-        // if misc input device channel, skip
-        if (type == THidDeviceType::HidMouseInput) {
-            goto func_exit;
-        }
+    // the misc input channel carries no profiles
+    if (type != THidDeviceType::HidMouseControl) {
+        return;
+    }
 
-        /* read device control state */
-        if (!readDeviceControl()) {
-            goto func_exit;
-        }
+    // caller reads only what it needs
+    if (!m_syncOnConnect) {
+        emit deviceFound();
+        finishLookup(true);
+        return;
+    }
 
-        /* read firmware release */
-        if (!readDeviceInfo()) {
-            goto func_exit;
-        }
+    startSync();
+}
 
-        /* read device control unit */
-        if (!readControlUnit()) {
-            goto func_exit;
-        }
+void RTController::onDeviceRemoved()
+{
+    m_syncedProfiles = RT_PROFILES_ALL;
+    emit deviceRemoved();
+}
 
-        /* read talk-fx status */
-        if (!talkRead()) {
-            goto func_exit;
-        }
+void RTController::onErrorOccured(int error, const QString &message)
+{
+    raiseError(error, message);
+}
+
+void RTController::onInputReady(quint32 rid, const QByteArray &data)
+{
+    const qint64 received = RTLatency::monotonicNs();
+    TSpecialEvent event;
+    if (rid != TYON_REPORT_ID_SPECIAL || !RTSpecialReport::decode((const quint8 *) data.constData(), data.size(), &event)) {
+        return;
+    }
 
-        /* read current profile number */
-        if (!readActiveProfile()) {
-            goto func_exit;
+    // X-Celerator paddle values stay on the input thread, one wake up per pull
+    switch (event.type) {
+        case SpecialXCeleratorCalibration: {
+            m_xcCalibrator.add(event.value, QElapsedTimer::msecsSinceReference());
+            if (m_xcStream.push(event.value)) {
+                emit xcStreamReady();
+            }
+            return;
+        }
+        case SpecialAnalogue: {
+            m_xcJoystick.forward(event.value, received);
+            if (m_xcStream.push(event.value)) {
+                emit xcStreamReady();
+            }
+            return;
+        }
+        case SpecialQuickLaunch: {
+            // host macro, the player thread takes it from here
+            if (event.pressed && m_macroPlayer.trigger(event.value)) {
+                return;
+            }
+            break;
+        }
+        default: {
+            break;
         }
+    }
 
-        /* read profile slots */
-        for (quint8 pix = 0; pix < TYON_PROFILE_NUM; pix++) {
-            if (!readProfiles(pix)) {
-                goto func_exit;
+    // profiles and talk state belong to the controller thread
+    QMetaObject::invokeMethod(
+        this,
+        [this, event]() { //
+            applySpecialEvent(event);
+        },
+        Qt::QueuedConnection);
+}
+
+inline void RTController::applySpecialEvent(const TSpecialEvent &event)
+{
+#ifdef QT_DEBUG
+    qDebug("[HIDDEV] SPECIAL: %s value=%d index=%d pressed=%d", //
+           RTSpecialReport::name(event.type),
+           event.value,
+           event.index,
+           event.pressed);
+#endif
+
+    const quint8 pix = activeProfileIndex();
+
+    switch (event.type) {
+        case SpecialProfile: {
+            // profile button on the mouse, the slot content is unchanged
+            setActiveProfile(event.value);
+            break;
+        }
+        case SpecialCpi: {
+            if (!m_profiles.contains(pix) || m_profiles[pix].settings.cpi_active == event.value) {
+                break;
+            }
+            TProfile p = m_profiles[pix];
+            p.settings.cpi_active = event.value;
+            m_profiles[pix] = p;
+            emit dpiSlotChanged(pix, event.value);
+            emit profileChanged(p);
+            break;
+        }
+        case SpecialSensitivity: {
+            if (!m_profiles.contains(pix)) {
+                break;
+            }
+            // TyonSpecial.data holds the one level 1-11 of the sensitivity
+            // buttons, roccat-tools applies it to X and Y alike
+            TProfile p = m_profiles[pix];
+            p.settings.sensitivity_x = event.value;
+            p.settings.sensitivity_y = event.value;
+            m_profiles[pix] = p;
+            emit sensitivityChanged(pix, toSensitivityXValue(&p.settings), toSensitivityYValue(&p.settings));
+            emit profileChanged(p);
+            break;
+        }
+        case SpecialTalk: {
+            switch (event.value) {
+                case TYON_BUTTON_TYPE_EASYSHIFT_OTHER:
+                case TYON_BUTTON_TYPE_EASYSHIFT_ALL: {
+                    m_talkFx.easyshift = (event.pressed ? TYON_TALK_EASYSHIFT_ON : TYON_TALK_EASYSHIFT_OFF);
+                    break;
+                }
+                case TYON_BUTTON_TYPE_EASYSHIFT_LOCK_OTHER: {
+                    if (!event.pressed) {
+                        return;
+                    }
+                    m_talkFx.easyshift_lock = (m_talkFx.easyshift_lock == TYON_TALK_EASYSHIFT_ON //
+                                                   ? TYON_TALK_EASYSHIFT_OFF
+                                                   : TYON_TALK_EASYSHIFT_ON);
+                    break;
+                }
+                case TYON_BUTTON_TYPE_EASYAIM_1:
+                case TYON_BUTTON_TYPE_EASYAIM_2:
+                case TYON_BUTTON_TYPE_EASYAIM_3:
+                case TYON_BUTTON_TYPE_EASYAIM_4:
+                case TYON_BUTTON_TYPE_EASYAIM_5: {
+                    m_talkFx.easyaim = (event.pressed ? event.value - TYON_BUTTON_TYPE_EASYAIM_1 + 1 : TYON_TALK_EASYAIM_OFF);
+                    break;
+                }
+                default: {
+                    emit specialEvent(event);
+                    return;
+                }
             }
+            emit easyshiftChanged(m_talkFx.easyshift == TYON_TALK_EASYSHIFT_ON, //
+                                  m_talkFx.easyshift_lock == TYON_TALK_EASYSHIFT_ON);
+            emit talkFxChanged(m_talkFx);
+            break;
+        }
+        default: {
+            break;
         }
+    }
 
-        emit deviceFound();
+    emit specialEvent(event);
+}
 
-    func_exit:
-        t->exit(0);
-    });
-    connect(t, &QThread::finished, this, [t]() { //
-        t->deleteLater();
-    });
-    connect(t, &QThread::destroyed, this, [](QObject *) { //
-        //emit deviceWorkerFinished();
-    });
-    t->start(QThread::IdlePriority);
-    QThread::yieldCurrentThread();
+bool RTController::deviceReadInfo()
+{
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+    return readDeviceInfo() && readControlUnit();
 }
 
-void RTController::onDeviceRemoved()
+bool RTController::deviceReadActiveProfile()
 {
-    emit deviceRemoved();
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+    return readActiveProfile();
 }
 
-void RTController::onErrorOccured(int error, const QString &message)
+bool RTController::deviceReadProfile(quint8 pix, bool withButtons)
 {
-    raiseError(error, message);
+    if (withButtons) {
+        return readProfiles(pix);
+    }
+    RTTransaction t;
+    t.readProfile(pix, false);
+    if (!runTransaction(&t)) {
+        return false;
+    }
+    dispatchTransaction(t);
+    m_slotCache.invalidate(pix);
+    return true;
 }
 
-void RTController::onInputReady(quint32 rid, const QByteArray &data)
+bool RTController::deviceWriteActiveProfile(quint8 pix)
+{
+    if (pix >= TYON_PROFILE_NUM) {
+        raiseError(EINVAL, "Invalid profile index.");
+        return false;
+    }
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Interactive);
+    if (!writeProfileIndex(pix)) {
+        return false;
+    }
+    m_activeProfile.profile_index = pix;
+    m_slotCache.touch(pix);
+    return true;
+}
+
+bool RTController::deviceWriteProfile(quint8 pix, bool withButtons)
 {
-    // X-Celerator calibration events
-    if (rid == TYON_REPORT_ID_SPECIAL) {
-        emit specialReport(rid, data);
+    if (!m_profiles.contains(pix)) {
+        raiseError(EINVAL, "Invalid profile index.");
+        return false;
+    }
+    TProfile p = m_profiles[pix];
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Interactive);
+    if (!writeProfileSlot(p, pix, withButtons)) {
+        return false;
     }
+    updateProfile(p, false);
+    return true;
 }
 
 inline void RTController::initPhysicalButtons()
@@ -486,6 +679,7 @@ inline void RTController::initializeHandlers()
             return false;
         }
         memcpy(&m_info, buffer, sizeof(TyonInfo));
+        m_xcJoystick.setCalibration(m_info.xcelerator_min, m_info.xcelerator_mid, m_info.xcelerator_max);
 #ifdef QT_DEBUG
         debugDevInfo(&m_info);
 #endif
@@ -622,124 +816,330 @@ void RTController::lookupDevice()
     products.append(USB_DEVICE_ID_ROCCAT_TYON_BLACK);
     products.append(USB_DEVICE_ID_ROCCAT_TYON_WHITE);
 
+    m_lookupTimer.start();
+
+#ifdef Q_OS_MACOS
+    // IOKit matches asynchronously on the run loop of this thread
     if (!m_hid->lookupDevices(USB_DEVICE_ID_VENDOR_ROCCAT, products)) {
         raiseError(EIO, "Unable to lookup ROCCAT Tyon device.");
+        finishLookup(false);
+    }
+#else
+    // hidapi enumerates synchronously, keep it off the GUI thread
+    if (m_lookupThread) {
+        return;
     }
+    m_lookupThread = new QThread();
+    connect(
+        m_lookupThread,
+        &QThread::started,
+        m_lookupThread,
+        [this, products]() {
+            if (!m_hid->lookupDevices(USB_DEVICE_ID_VENDOR_ROCCAT, products)) {
+                QMetaObject::invokeMethod(
+                    this,
+                    [this]() { //
+                        raiseError(EIO, "Unable to lookup ROCCAT Tyon device.");
+                        finishLookup(false);
+                    },
+                    Qt::QueuedConnection);
+            }
+            QThread::currentThread()->exit(0);
+        },
+        Qt::DirectConnection);
+    connect(m_lookupThread, &QThread::finished, this, [this]() { //
+        m_lookupThread->deleteLater();
+        m_lookupThread = nullptr;
+    });
+    m_lookupThread->start();
+#endif
 }
 
-void RTController::resetProfiles()
+inline void RTController::finishLookup(bool found)
 {
-    TyonInfo info = {};
-    info.report_id = TYON_REPORT_ID_INFO;
-    info.size = sizeof(TyonInfo);
-    info.function = TYON_INFO_FUNCTION_RESET;
-    quint8 *buffer = (quint8 *) &info;
-
-    m_profiles.clear();
-    m_activeProfile = {};
-    m_info = {};
+    if (m_lookupTimer.isValid()) {
+        qInfo("[HIDDEV] Device %s after %lld ms", found ? "synced" : "not ready", (long long) m_lookupTimer.elapsed());
+        m_lookupTimer.invalidate();
+    }
+    emit lookupFinished(found);
+}
 
-    initializeProfiles();
+inline void RTController::startSync()
+{
+    // info, control unit, talk-fx, active profile, settings and buttons
+    static const int total = 4 + 2 * TYON_PROFILE_NUM;
 
-    if (!roccatControlCheck()) {
+    if (m_syncThread) {
         return;
     }
 
-    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    if (!m_hid->writeHidMessage(hdt, info.report_id, buffer, info.size)) {
-        return;
-    }
+    m_slotCache.reset();
+    m_sensorRegisters.reset();
+    m_syncedProfiles = 0;
+    m_transactionMutex.lock();
+    m_transactionStats = {};
+    m_transactionMutex.unlock();
+    emit syncProgress(0, total);
+
+    m_syncThread = new QThread();
+    connect(
+        m_syncThread,
+        &QThread::started,
+        m_syncThread,
+        [this]() {
+            QThread *t = QThread::currentThread();
+            RTTransaction head;
+            quint8 active;
+            int done = 0;
+            bool ok = false;
+
+            /* firmware release, control unit, talk-fx and current profile number */
+            head.read(TYON_REPORT_ID_INFO, sizeof(TyonInfo));
+            head.read(TYON_REPORT_ID_CONTROL_UNIT, sizeof(TyonControlUnit));
+            head.read(TYON_REPORT_ID_TALK, sizeof(TyonTalk));
+            head.read(TYON_REPORT_ID_PROFILE, sizeof(TyonProfile));
+            if (!runTransaction(&head)) {
+                goto thread_exit;
+            }
+            syncApply(head);
+            active = ((const TyonProfile *) head.at(3).data.constData())->profile_index % TYON_PROFILE_NUM;
+            done += head.count();
+            syncStep(done, total);
+
+            /* read profile slots, the active one first */
+            for (quint8 i = 0; i < TYON_PROFILE_NUM; i++) {
+                const quint8 pix = (active + i) % TYON_PROFILE_NUM;
+                if (t->isInterruptionRequested()) {
+                    goto thread_exit;
+                }
+                // other writers run between the slots, runTransaction()
+                // skips the first check only while the status is fresh
+                RTTransaction slot;
+                slot.readProfile(pix);
+                if (!runTransaction(&slot)) {
+                    goto thread_exit;
+                }
+                syncApply(slot);
+                done += 2;
+                syncStep(done, total);
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, pix]() { //
+                        setModified(pix, false);
+                        if (m_profiles.contains(pix)) {
+                            const TProfile &p = m_profiles[pix];
+                            m_slotCache.assign(pix, RTSlotCache::contentHash(p.settings, p.buttons));
+                        }
+                        if (m_syncedProfiles == 0 && m_lookupTimer.isValid()) {
+                            qInfo("[HIDDEV] Active profile interactive after %lld ms", (long long) m_lookupTimer.elapsed());
+                        }
+                        m_syncedProfiles |= (1 << pix);
+                        emit profileSynced(pix);
+                    },
+                    Qt::QueuedConnection);
+            }
+            ok = true;
+
+        thread_exit:
+            QMetaObject::invokeMethod(
+                this,
+                [this, ok]() { //
+                    finishSync(ok);
+                },
+                Qt::QueuedConnection);
+            t->exit(0);
+        },
+        Qt::DirectConnection);
+    connect(m_syncThread, &QThread::finished, this, [this]() { //
+        m_syncThread->deleteLater();
+        m_syncThread = nullptr;
+    });
+    m_syncThread->start();
+}
 
-    // wait reset...
-    QThread::msleep(1000);
+inline void RTController::syncApply(const RTTransaction &t)
+{
+    // handlers change the controller state, run them on its thread
+    QMetaObject::invokeMethod(
+        this,
+        [this, t]() { //
+            dispatchTransaction(t);
+        },
+        Qt::QueuedConnection);
+}
 
-    // restart device lookup
-    lookupDevice();
+inline void RTController::syncStep(int done, int total)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, done, total]() { //
+            emit syncProgress(done, total);
+        },
+        Qt::QueuedConnection);
 }
 
-void RTController::updateDevice()
+inline void RTController::finishSync(bool ok)
 {
-    emit deviceWorkerStarted();
+    if (!ok) {
+        // profiles read so far stay, the others keep their defaults
+        m_syncedProfiles = RT_PROFILES_ALL;
+        finishLookup(false);
+        return;
+    }
+    const RTTransaction::TStatistics stats = transactionStatistics();
+    qInfo("[HIDDEV] Sync: %u round trips in %u transactions, %u with a check per select", //
+          stats.checks + stats.reports,
+          stats.transactions,
+          stats.legacy);
+    emit deviceFound();
+    finishLookup(true);
+}
 
-    auto writeProfileIndex = [this]() -> bool {
-        const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-        const qsizetype length = sizeof(TyonProfile);
-        const quint8 *buffer = (quint8 *) &m_activeProfile;
+void RTController::resetProfiles()
+{
+    m_profiles.clear();
+    m_activeProfile = {};
+    m_info = {};
+    m_slotCache.reset();
 
-        if (!roccatControlCheck()) {
-            return false;
-        }
+    initializeProfiles();
 
-        if (!m_hid->writeHidMessage(hdt, TYON_REPORT_ID_PROFILE, buffer, length)) {
-            return false;
-        }
+    postDeviceJob(
+        [this]() -> bool {
+            TyonInfo info = {};
+            info.report_id = TYON_REPORT_ID_INFO;
+            info.size = sizeof(TyonInfo);
+            info.function = TYON_INFO_FUNCTION_RESET;
+
+            {
+                RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+                if (!roccatControlCheck()) {
+                    return false;
+                }
 
-        return true;
-    };
+                const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+                if (!hidWrite(hdt, info.report_id, (const quint8 *) &info, info.size)) {
+                    return false;
+                }
+            }
 
-    auto writeProfile = [this](const TProfile &p) -> int {
-        const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-        qsizetype length;
-        quint8 *buffer;
+            // the device answers BUSY until the factory profiles are written
+            return waitControlReady(RT_RESET_TIMEOUT_MS, "reset");
+        },
+        [this](bool ok) {
+            emit resetFinished(ok);
+            // restart device lookup
+            if (ok) {
+                lookupDevice();
+            }
+        });
+}
 
-        length = sizeof(TyonProfileSettings);
-        buffer = (quint8 *) &p.settings;
+inline void RTController::postDeviceJob(const std::function<bool()> &job, const std::function<void(bool)> &finished)
+{
+    if (!m_jobThread) {
+        m_jobThread = new QThread();
+        m_jobContext = new QObject();
+        m_jobContext->moveToThread(m_jobThread);
+        connect(m_jobThread, &QThread::finished, m_jobContext, &QObject::deleteLater);
+        m_jobThread->start();
+    }
 
-        if (!roccatControlCheck()) {
-            return false;
-        }
-        if (!m_hid->writeHidMessage(hdt, TYON_REPORT_ID_PROFILE_SETTINGS, buffer, length)) {
-            return false;
-        }
+    // one job thread, the jobs reach the device in call order
+    QMetaObject::invokeMethod(
+        m_jobContext,
+        [this, job, finished]() {
+            const bool ok = job();
+            QMetaObject::invokeMethod(
+                this,
+                [finished, ok]() { //
+                    finished(ok);
+                },
+                Qt::QueuedConnection);
+        },
+        Qt::QueuedConnection);
+}
 
-        length = sizeof(TyonProfileButtons);
-        buffer = (quint8 *) &p.buttons;
+inline void RTController::startWorker(QThread::Priority priority, bool notify, const std::function<void()> &work)
+{
+    QThread *t = new QThread();
+    // the context lives on t, the work runs there and the scheduler
+    // steps of several workers really interleave
+    connect(
+        t,
+        &QThread::started,
+        t,
+        [t, work]() {
+            work();
+            t->exit(0);
+        },
+        Qt::DirectConnection);
+    connect(t, &QThread::finished, this, [t]() { //
+        t->deleteLater();
+    });
+    if (notify) {
+        connect(t, &QThread::destroyed, this, [this]() { //
+            emit deviceWorkerFinished();
+        });
+    }
+    t->start(priority);
+}
 
-        if (!roccatControlCheck()) {
-            return false;
-        }
-        if (!m_hid->writeHidMessage(hdt, TYON_REPORT_ID_PROFILE_BUTTONS, buffer, length)) {
-            return false;
-        }
+inline void RTController::postProfileUpdate(const TProfile &profile)
+{
+    // the profile map belongs to the controller thread
+    QMetaObject::invokeMethod(
+        this,
+        [this, profile]() {
+            TProfile p = profile;
+            updateProfile(p, false);
+        },
+        Qt::QueuedConnection);
+}
 
-        return true;
-    };
+void RTController::updateDevice()
+{
+    emit deviceWorkerStarted();
 
-    QThread *t = new QThread();
-    connect(t, &QThread::started, this, [this, t, writeProfileIndex, writeProfile]() { //
-        /* update TCU / DCU */
-        if (m_controlUnit.tcu == TYON_TRACKING_CONTROL_UNIT_OFF) {
-            if (!tcuWriteOff(m_controlUnit.dcu)) {
-                goto thread_exit;
+    // the worker writes a snapshot, edits made meanwhile stay modified
+    const TyonControlUnit controlUnit = m_controlUnit;
+    const quint8 active = activeProfileIndex();
+    const TProfiles profiles = m_profiles;
+
+    startWorker(QThread::LowPriority, true, [this, controlUnit, active, profiles]() {
+        /* one scheduler step per report group, interactive requests
+         * are served in between */
+        {
+            /* update TCU / DCU */
+            RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Bulk);
+            if (controlUnit.tcu == TYON_TRACKING_CONTROL_UNIT_OFF) {
+                if (!tcuWriteOff(controlUnit.dcu)) {
+                    return;
+                }
+            } else if (!tcuWriteAccept(controlUnit.dcu, controlUnit.median)) {
+                return;
             }
-        } else if (!tcuWriteAccept(m_controlUnit.dcu, m_controlUnit.median)) {
-            goto thread_exit;
         }
 
-        /* set active profile */
-        if (!writeProfileIndex()) {
-            goto thread_exit;
+        {
+            /* set active profile */
+            RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Bulk);
+            if (!writeProfileIndex(active)) {
+                return;
+            }
         }
 
         /* write all profiles */
-        foreach (TProfile p, m_profiles) {
+        foreach (TProfile p, profiles) {
             if (p.changed) {
-                if (!writeProfile(p)) {
-                    goto thread_exit;
+                RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Bulk);
+                if (!writeProfileSlot(p, p.index)) {
+                    return;
                 }
-                updateProfile(p, false);
+                postProfileUpdate(p);
             }
         }
-    thread_exit:
-        t->exit(0);
-    });
-    connect(t, &QThread::finished, this, [t]() { //
-        t->deleteLater();
-    });
-    connect(t, &QThread::destroyed, this, [this]() { //
-        emit deviceWorkerFinished();
     });
-    t->start(QThread::LowPriority);
 }
 
 static const quint32 FILE_BLOCK_MARKER[] = {
@@ -1158,38 +1558,6 @@ func_exit:
     }
 }
 
-void RTController::setupButton(const RoccatButton &rb, QPushButton *button)
-{
-    QKeySequence ks;
-
-    // assign ROCCAT button type to push button
-    button->setProperty("type", QVariant::fromValue(rb.type));
-    button->setProperty("modifier", QVariant::fromValue(rb.modifier));
-    button->setProperty("hiduid", QVariant::fromValue(rb.key));
-    button->setText(buttonTypes().value(rb.type));
-
-    // assign shortcut type
-    switch (rb.type) {
-        case TYON_BUTTON_TYPE_SHORTCUT: {
-            ks = toKeySequence(rb);
-            if (!ks.isEmpty()) {
-                button->setProperty("shortcut", QVariant::fromValue(ks));
-#ifndef Q_OS_MACOS
-                button->setText(ks.toString());
-#else
-                if (ks[0].keyboardModifiers().testFlag(Qt::MetaModifier)) {
-                    QString s = ks.toString().replace("Meta", "Cmd");
-                    button->setText(s);
-                } else {
-                    button->setText(ks.toString());
-                }
-#endif
-            }
-            break;
-        }
-    }
-}
-
 void RTController::assignButton(TyonButtonIndex type, TyonButtonType func, QKeyCombination kc)
 {
     if ((qint8) type > TYON_PROFILE_BUTTON_NUM) {
@@ -1207,7 +1575,7 @@ void RTController::assignButton(TyonButtonIndex type, TyonButtonType func, QKeyC
     quint8 mods = 0;
 
     if (func == TYON_BUTTON_TYPE_SHORTCUT) {
-        QLocale locale = QApplication::inputMethod()->locale();
+        const QLocale &locale = m_keyboardLocale;
         if (locale.language() == QLocale::German) {
             QString language = locale.languageToString(locale.language());
             qDebug() << "Aktuelle Tastatursprache:" << language;
@@ -1257,7 +1625,7 @@ void RTController::assignButton(TyonButtonIndex type, TyonButtonType func, QKeyC
     updateProfile(p, true);
 }
 
-const QKeySequence RTController::toKeySequence(const RoccatButton &b) const
+QKeyCombination RTController::toKeyCombination(const RoccatButton &b) const
 {
     // Translate ROCCAT Tyon key modifier to QT type
     auto toQtModifiers = [](quint8 modifier, const TUidToQtKeyMap *keymap) -> Qt::KeyboardModifiers {
@@ -1282,8 +1650,7 @@ const QKeySequence RTController::toKeySequence(const RoccatButton &b) const
     };
 
     quint8 _rbk = b.key;
-    QLocale locale = QApplication::inputMethod()->locale();
-    QString language = locale.languageToString(locale.language());
+    const QLocale &locale = m_keyboardLocale;
 
     if (locale.language() == QLocale::German) {
         // y -> z & vs.
@@ -1304,13 +1671,11 @@ const QKeySequence RTController::toKeySequence(const RoccatButton &b) const
 
     if (keymap) {
         const Qt::KeyboardModifiers km = toQtModifiers(b.modifier, keymap);
-        const QKeyCombination kc(km, keymap->qt_key);
-        const QKeySequence ks(kc);
-        return ks;
+        return QKeyCombination(km, keymap->qt_key);
     }
 
-    // not found
-    return {};
+    // not found, empty like a default QKeySequence
+    return QKeyCombination::fromCombined(0);
 }
 
 qint16 RTController::toSensitivityXValue(const TyonProfileSettings *settings) const
@@ -1334,11 +1699,95 @@ void RTController::setActiveProfile(quint8 pix)
 {
     if (m_activeProfile.profile_index != pix && pix < TYON_PROFILE_NUM) {
         m_activeProfile.profile_index = pix;
+        m_slotCache.touch(pix);
         emit profileIndexChanged(pix);
         emit profileChanged(m_profiles[pix]);
     }
 }
 
+void RTController::activateProfile(quint8 pix, qint64 timestamp)
+{
+    if (pix >= TYON_PROFILE_NUM) {
+        raiseError(EINVAL, "Invalid profile index.");
+        return;
+    }
+
+    setActiveProfile(pix);
+
+    startWorker(QThread::HighPriority, false, [this, pix, timestamp]() {
+        RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Interactive);
+        const bool ok = writeProfileIndex(pix);
+        qint64 elapsed = 0;
+        if (ok && timestamp > 0) {
+            elapsed = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs() - timestamp;
+            if (elapsed > RT_PROFILE_SWITCH_BUDGET_MS * 1000000LL) {
+                qWarning("[HIDDEV] Profile %d active after %.2f ms, over %d ms", pix + 1, elapsed / 1000000.0, RT_PROFILE_SWITCH_BUDGET_MS);
+            } else {
+                qInfo("[HIDDEV] Profile %d active after %.2f ms", pix + 1, elapsed / 1000000.0);
+            }
+        }
+        emit profileActivated(pix, ok, elapsed);
+    });
+}
+
+void RTController::switchProfile(const TProfile &profile)
+{
+    emit deviceWorkerStarted();
+
+    const quint32 pinned = pinnedSlots();
+    startWorker(QThread::HighPriority, true, [this, profile, pinned]() {
+        RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Interactive);
+        switchProfileSlot(profile, pinned);
+    });
+}
+
+void RTController::prefetchProfiles(const QList<TProfile> &profiles)
+{
+    emit deviceWorkerStarted();
+
+    const quint32 pinned = pinnedSlots();
+    startWorker(QThread::LowPriority, true, [this, profiles, pinned]() {
+        quint8 count = 0;
+        foreach (TProfile p, profiles) {
+            // keep the active slot, all others may be replaced
+            if (count >= TYON_PROFILE_NUM - 1) {
+                break;
+            }
+            count++;
+            int resident = residentSlot(p);
+            if (resident >= 0) {
+                // protect from eviction by the following ones
+                m_slotCache.touch(resident);
+                continue;
+            }
+            RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Bulk);
+            const int slot = m_slotCache.victim(pinned);
+            if (slot < 0 || !writeProfileSlot(p, slot)) {
+                break;
+            }
+            postProfileUpdate(p);
+            m_slotCache.countPrefetch();
+        }
+    });
+}
+
+inline quint32 RTController::pinnedSlots() const
+{
+    // the active slot and unsaved edits are never replaced
+    quint32 pinned = (1 << activeProfileIndex());
+    foreach (const TProfile &p, m_profiles) {
+        if (p.changed && p.index < TYON_PROFILE_NUM) {
+            pinned |= (1 << p.index);
+        }
+    }
+    return pinned;
+}
+
+int RTController::residentSlot(const TProfile &profile) const
+{
+    return m_slotCache.slotOf(RTSlotCache::contentHash(profile.settings, profile.buttons));
+}
+
 void RTController::setProfileName(const QString &name, quint8 pix)
 {
     if (m_profiles.contains(pix)) {
@@ -1567,7 +2016,7 @@ void RTController::setLightCustomColorEnabled(bool state)
     }
 }
 
-TyonLight RTController::toDeviceColor(TyonLightType target, const QColor &color) const
+TyonLight RTController::toDeviceColor(TyonLightType target, quint32 rgb) const
 {
     if ((quint8) target >= TYON_LIGHTS_NUM) {
         qWarning("[HIDDEV] toDeviceColor(): Invalid light index. 0 or 1 expected.");
@@ -1578,23 +2027,26 @@ TyonLight RTController::toDeviceColor(TyonLightType target, const QColor &color)
     TyonLight info = {};
     info.index = tl.index;
     info.unused = tl.unused;
-    info.red = color.red();
-    info.green = color.green();
-    info.blue = color.blue();
+    info.red = (rgb >> 16) & 0xff;
+    info.green = (rgb >> 8) & 0xff;
+    info.blue = rgb & 0xff;
     return info;
 }
 
-QColor RTController::toScreenColor(const TyonLight &light, bool isCustom) const
+quint32 RTController::toScreenColor(const TyonLight &light, bool isCustom) const
 {
+    auto toRgb = [](quint8 red, quint8 green, quint8 blue) -> quint32 {
+        return 0xff000000u | (quint32(red) << 16) | (quint32(green) << 8) | blue;
+    };
     if (isCustom) {
-        return QColor::fromRgb(light.red, light.green, light.blue);
+        return toRgb(light.red, light.green, light.blue);
     }
     if (light.index >= m_colors.count()) {
         qWarning("[HIDDEV] toScreenColor(): Invalid color index: %d", light.index);
-        return Qt::red;
+        return toRgb(0xff, 0x00, 0x00);
     }
     const TyonLight tci = m_colors.value(light.index).deviceColors;
-    return QColor::fromRgb(tci.red, tci.green, tci.blue);
+    return toRgb(tci.red, tci.green, tci.blue);
 }
 
 void RTController::setLightColor(TyonLightType target, const TyonLight &color)
@@ -1661,66 +2113,72 @@ quint8 RTController::middleXCelerate() const
 
 void RTController::xcStartCalibration()
 {
+    m_xcCalibrator.reset();
     emit deviceWorkerStarted();
 
-    QThread *t = new QThread();
-    connect(t, &QThread::started, this, [this, t]() { //
-        xcCalibWriteStart();
-        t->exit(0);
-    });
-    connect(t, &QThread::finished, this, [t]() { //
-        t->deleteLater();
-    });
-    connect(t, &QThread::destroyed, this, [this](QObject *) { //
-        emit deviceWorkerFinished();
-    });
-    t->start(QThread::IdlePriority);
-    QThread::yieldCurrentThread();
-    QThread::msleep(500);
+    postDeviceJob(
+        [this]() -> bool {
+            {
+                RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+                if (!xcCalibWriteStart()) {
+                    return false;
+                }
+            }
+            return waitControlReady(RT_CONTROL_TIMEOUT_MS, "X-Celerator start");
+        },
+        [this](bool ok) {
+            emit xcWriteFinished(ok);
+            emit deviceWorkerFinished();
+        });
 }
 
 void RTController::xcStopCalibration()
 {
     emit deviceWorkerStarted();
 
-    QThread *t = new QThread();
-    connect(t, &QThread::started, this, [this, t]() { //
-        xcCalibWriteEnd();
-        t->exit(0);
-    });
-    connect(t, &QThread::finished, this, [t]() { //
-        t->deleteLater();
-    });
-    connect(t, &QThread::destroyed, this, [this](QObject *) { //
-        emit deviceWorkerFinished();
-    });
-    t->start(QThread::IdlePriority);
-    QThread::yieldCurrentThread();
-    QThread::msleep(200);
+    postDeviceJob(
+        [this]() -> bool {
+            {
+                RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+                if (!xcCalibWriteEnd()) {
+                    return false;
+                }
+            }
+            return waitControlReady(RT_CONTROL_TIMEOUT_MS, "X-Celerator end");
+        },
+        [this](bool ok) {
+            emit xcWriteFinished(ok);
+            emit deviceWorkerFinished();
+        });
 }
 
 void RTController::tcuSensorTest(TyonControlUnitDcu dcu, uint median)
 {
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
     tcuWriteTest(dcu, median);
 }
 
 void RTController::tcuSensorAccept(TyonControlUnitDcu dcuState, uint median)
 {
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
     tcuWriteAccept(dcuState, median);
 }
 
 void RTController::tcuSensorCancel(TyonControlUnitDcu dcuState)
 {
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
     tcuWriteCancel(dcuState);
 }
 
 void RTController::tcuSensorCaptureImage()
 {
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
     tcuWriteSensorImageCapture();
 }
 
 void RTController::tcuSensorReadImage()
 {
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
     tcuReadSensorImage();
 }
 
@@ -1729,49 +2187,250 @@ int RTController::tcuSensorReadMedian(TyonSensorImage *image)
     return sensorMedianOfImage(image);
 }
 
-void RTController::xcApplyCalibration(quint8 min, quint8 mid, quint8 max)
+void RTController::tcuSensorStartCapture()
 {
-    emit deviceWorkerStarted();
+    if (!m_sensorCapture->isRunning()) {
+        m_sensorCapture->start(QThread::HighPriority);
+    }
+}
 
-    QThread *t = new QThread();
-    connect(t, &QThread::started, this, [this, t, min, mid, max]() { //
-        qInfo("[HIDDEV] Apply X-Celerator min=%d mid=%d max=%d", min, mid, max);
-        xcCalibWriteData(min, mid, max);
-        t->exit(0);
-    });
-    connect(t, &QThread::finished, this, [t]() { //
-        t->deleteLater();
-    });
-    connect(t, &QThread::destroyed, this, [this](QObject *) { //
-        emit deviceWorkerFinished();
+void RTController::tcuSensorStopCapture()
+{
+    m_sensorCapture->stop();
+    m_sensorCapture->wait();
+}
+
+bool RTController::deviceWriteControlUnit(TyonControlUnitDcu dcu, bool tcu, uint median, bool store)
+{
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+    bool ok;
+    if (!tcu) {
+        ok = tcuWriteOff(dcu);
+    } else if (store) {
+        ok = tcuWriteAccept(dcu, median);
+    } else {
+        ok = tcuWriteTest(dcu, median);
+    }
+    if (ok && store) {
+        m_controlUnit.dcu = dcu;
+        m_controlUnit.tcu = (tcu ? TYON_TRACKING_CONTROL_UNIT_ON : TYON_TRACKING_CONTROL_UNIT_OFF);
+        m_controlUnit.median = (tcu ? median : 0);
+        emit controlUnitChanged(m_controlUnit);
+    }
+    return ok;
+}
+
+bool RTController::setXcJoystick(bool enable, const RTXCJoystick::TConfig &config)
+{
+    if (!enable) {
+        m_xcJoystick.close();
+        return true;
+    }
+
+    m_xcJoystick.setConfig(config);
+    m_xcJoystick.setCalibration(m_info.xcelerator_min, m_info.xcelerator_mid, m_info.xcelerator_max);
+
+    QString error;
+    if (!m_xcJoystick.open(&error)) {
+        raiseError(ENODEV, error);
+        return false;
+    }
+    return true;
+}
+
+bool RTController::setHotkeys(bool enable, const RTHotkeyListener::TConfig &config)
+{
+    m_hotkeys.close();
+    if (!enable) {
+        return true;
+    }
+
+    // released / pressed, the lock key toggles between both
+    const quint8 unused = TYON_TALK_EASYSHIFT_UNUSED;
+    const quint8 states[RTHotkeyListener::ActionCount][2][3] = {
+        {{TYON_TALK_EASYSHIFT_OFF, unused, unused}, {TYON_TALK_EASYSHIFT_ON, unused, unused}},
+        {{unused, TYON_TALK_EASYSHIFT_OFF, unused}, {unused, TYON_TALK_EASYSHIFT_ON, unused}},
+        {{unused, unused, TYON_TALK_EASYAIM_OFF}, {unused, unused, config.easyAimLevel}},
+    };
+    for (int a = 0; a < RTHotkeyListener::ActionCount; a++) {
+        for (int v = 0; v < 2; v++) {
+            TyonTalk &r = m_hotkeyReports[a][v];
+            r = {};
+            r.report_id = TYON_REPORT_ID_TALK;
+            r.size = sizeof(TyonTalk);
+            r.easyshift = states[a][v][0];
+            r.easyshift_lock = states[a][v][1];
+            r.easyaim = states[a][v][2];
+            r.fx_status = TYON_TALKFX_STATE_UNUSED;
+        }
+    }
+    m_easyshiftLocked = false;
+
+    QString error;
+    const RTHotkeyListener::THandler handler = [this](RTHotkeyListener::TAction action, bool pressed) { //
+        return talkHotkey(action, pressed);
+    };
+    // a fresh status lets an isolated key press skip the control check
+    m_hotkeys.setIdleHandler([this]() { //
+        refreshStatus();
     });
-    t->start(QThread::IdlePriority);
-    QThread::yieldCurrentThread();
-    QThread::msleep(500);
+    if (!m_hotkeys.open(config, handler, &error)) {
+        raiseError(ENODEV, error);
+        return false;
+    }
+    return true;
 }
 
-inline bool RTController::readProfiles(quint8 pix)
+bool RTController::setMacros(bool enable, const RTMacroPlayer::TConfig &config)
 {
-    /* select profile settings store */
-    if (!selectProfileSettings(pix)) {
+    m_macroPlayer.close();
+    if (!enable) {
+        return true;
+    }
+
+    QString error;
+    if (!m_macroPlayer.open(config, &error)) {
+        raiseError(ENODEV, error);
         return false;
     }
+    return true;
+}
+
+bool RTController::setTalkFx(bool enable, const RTTalkFxEngine::TConfig &config)
+{
+    m_talkFxEngine.close();
+    if (!enable) {
+        return true;
+    }
 
-    /* read profile settings */
-    if (!readProfileSettings()) {
+    QString error;
+    const RTTalkFxEngine::TWriter writer = [this](const RTTalkFxEngine::TFrame *frame) { //
+        return talkFxFrame(frame);
+    };
+    if (!m_talkFxEngine.open(config, writer, &error)) {
+        raiseError(ENODEV, error);
         return false;
     }
+    return true;
+}
 
-    /* select profile buttons store */
-    if (!selectProfileButtons(pix)) {
+bool RTController::sensorRegisterBatch(TSensorRegisterBatch *batch)
+{
+    if (m_sensorCapture->isRunning()) {
+        raiseError(EBUSY, tr("Sensor capture is running."));
         return false;
     }
 
-    /* read profile buttons */
-    if (!readProfileButtons()) {
+    for (TSensorRegisterOp &op : *batch) {
+        op.ok = false;
+        op.cached = false;
+    }
+
+    // one busy wait for the whole batch instead of one per register
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+    if (!roccatControlCheck()) {
         return false;
     }
 
+    quint32 reads = 0;
+    quint32 writes = 0;
+    bool ok = true;
+
+    for (TSensorRegisterOp &op : *batch) {
+        if (op.reg >= RTSensorRegisters::RegisterCount) {
+            raiseError(EINVAL, tr("Invalid sensor register 0x%1.").arg(op.reg, 2, 16, QChar('0')));
+            ok = false;
+            break;
+        }
+        if (op.write) {
+            if (!(ok = sensorCommandWrite(TYON_SENSOR_ACTION_WRITE, op.reg, op.value))) {
+                break;
+            }
+            writes++;
+        } else if (m_sensorRegisters.lookup(op.reg, &op.value)) {
+            op.cached = true;
+        } else {
+            if (!(ok = sensorRegisterRead(op.reg, &op.value))) {
+                break;
+            }
+            m_sensorRegisters.store(op.reg, op.value);
+            reads++;
+        }
+        op.ok = true;
+    }
+
+    m_sensorRegisters.count(reads, writes);
+
+#ifdef QT_DEBUG
+    qDebug("[HIDDEV] Sensor register batch: ops=%lld reads=%u writes=%u ok=%d", //
+           (long long) batch->size(),
+           reads,
+           writes,
+           ok);
+#endif
+
+    return ok;
+}
+
+bool RTController::sensorRegisterDump(RTSensorRegisters::TSnapshot *snapshot)
+{
+    TSensorRegisterBatch batch = RTSensorRegisters::dumpBatch();
+    const bool ok = sensorRegisterBatch(&batch);
+    RTSensorRegisters::toSnapshot(batch, snapshot);
+    return ok;
+}
+
+bool RTController::tcuSensorCaptureFrame(TyonSensorImage *image)
+{
+    // one frame per step, the capture loop yields between frames
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Bulk);
+    if (!tcuWriteSensorImageCapture()) {
+        return false;
+    }
+    image->report_id = TYON_REPORT_ID_SENSOR;
+    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+    return m_hid->readHidMessage(hdt, TYON_REPORT_ID_SENSOR, (quint8 *) image, sizeof(TyonSensorImage));
+}
+
+void RTController::xcApplyCalibration(quint8 min, quint8 mid, quint8 max)
+{
+    emit deviceWorkerStarted();
+
+    postDeviceJob(
+        [this, min, mid, max]() -> bool {
+            qInfo("[HIDDEV] Apply X-Celerator min=%d mid=%d max=%d", min, mid, max);
+            {
+                RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+                if (!xcCalibWriteData(min, mid, max)) {
+                    return false;
+                }
+            }
+            // written, a missing confirmation is only logged
+            waitXCeleratorInfo(min, mid, max);
+            return true;
+        },
+        [this, min, mid, max](bool ok) {
+            if (ok) {
+                m_info.xcelerator_min = min;
+                m_info.xcelerator_mid = mid;
+                m_info.xcelerator_max = max;
+                m_xcJoystick.setCalibration(min, mid, max);
+            }
+            emit xcWriteFinished(ok);
+            emit deviceWorkerFinished();
+        });
+}
+
+inline bool RTController::readProfiles(quint8 pix)
+{
+    /* select and read profile settings and buttons */
+    RTTransaction t;
+    t.readProfile(pix);
+    if (!runTransaction(&t)) {
+        return false;
+    }
+    dispatchTransaction(t);
+
 #if 0
     /* read all button slots including combined with EasyShift */
     for (quint8 bix = 0; bix < TYON_PROFILE_BUTTON_NUM; bix++) {
@@ -1783,6 +2442,12 @@ inline bool RTController::readProfiles(quint8 pix)
 
     // reset change flag
     setModified(pix, false);
+
+    // remember slot content
+    if (m_profiles.contains(pix)) {
+        const TProfile &p = m_profiles[pix];
+        m_slotCache.assign(pix, RTSlotCache::contentHash(p.settings, p.buttons));
+    }
     return true;
 }
 
@@ -1839,28 +2504,119 @@ inline void RTController::updateProfile(TProfile &p, bool changed)
     }
 }
 
-inline bool RTController::readDeviceControl()
+inline bool RTController::readActiveProfile()
 {
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->readHidMessage(hdt, TYON_REPORT_ID_CONTROL, sizeof(RoccatControl));
+    return m_hid->readHidMessage(hdt, TYON_REPORT_ID_PROFILE, sizeof(TyonProfile));
 }
 
-inline bool RTController::readActiveProfile()
+inline bool RTController::writeProfileIndex(quint8 pix)
 {
-    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->readHidMessage(hdt, TYON_REPORT_ID_PROFILE, sizeof(TyonProfile));
+    TyonProfile profile = {};
+    profile.report_id = TYON_REPORT_ID_PROFILE;
+    profile.size = sizeof(TyonProfile);
+    profile.profile_index = pix;
+
+    RTTransaction t;
+    t.write(&profile, sizeof(TyonProfile));
+    return runTransaction(&t);
 }
 
-inline bool RTController::readProfileSettings()
+inline bool RTController::writeProfileSlot(TProfile &p, quint8 slot, bool withButtons)
 {
-    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->readHidMessage(hdt, TYON_REPORT_ID_PROFILE_SETTINGS, sizeof(TyonProfileSettings));
+    quint8 *buffer;
+
+    if (slot >= TYON_PROFILE_NUM) {
+        raiseError(EINVAL, "Invalid profile index.");
+        return false;
+    }
+
+    /* move profile into target slot */
+    p.index = slot;
+    p.settings.report_id = TYON_REPORT_ID_PROFILE_SETTINGS;
+    p.settings.size = sizeof(TyonProfileSettings);
+    p.settings.profile_index = slot;
+    p.buttons.report_id = TYON_REPORT_ID_PROFILE_BUTTONS;
+    p.buttons.size = sizeof(TyonProfileButtons);
+    p.buttons.profile_index = slot;
+
+    /* bytesum up to the checksum field */
+    quint16 checksum = 0;
+    buffer = (quint8 *) &p.settings;
+    for (size_t i = 0; i < offsetof(TyonProfileSettings, checksum); i++) {
+        checksum += buffer[i];
+    }
+    p.settings.checksum = checksum;
+
+    /* each stored report keeps the device busy, checked after each write */
+    RTTransaction t;
+    t.write(&p.settings, sizeof(TyonProfileSettings));
+    if (withButtons) {
+        t.write(&p.buttons, sizeof(TyonProfileButtons));
+    }
+    if (!runTransaction(&t)) {
+        m_slotCache.invalidate(slot);
+        return false;
+    }
+
+    if (!withButtons) {
+        // buttons on the device are unknown here
+        m_slotCache.invalidate(slot);
+        return true;
+    }
+
+    m_slotCache.assign(slot, RTSlotCache::contentHash(p.settings, p.buttons));
+    return true;
 }
 
-inline bool RTController::readProfileButtons()
+inline bool RTController::switchProfileSlot(TProfile p, quint32 pinned)
 {
-    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->readHidMessage(hdt, TYON_REPORT_ID_PROFILE_BUTTONS, sizeof(TyonProfileButtons));
+    int slot = residentSlot(p);
+    bool resident = (slot >= 0);
+
+    if (!resident) {
+        if ((slot = m_slotCache.victim(pinned)) < 0) {
+            raiseError(EBUSY, tr("All profile slots hold unsaved changes, save them first."));
+            return false;
+        }
+        if (!writeProfileSlot(p, slot)) {
+            return false;
+        }
+    } else {
+        // device already holds this content, only the index differs
+        p.index = slot;
+        p.settings.profile_index = slot;
+        p.buttons.profile_index = slot;
+    }
+
+    if (!writeProfileIndex(slot)) {
+        return false;
+    }
+
+    m_slotCache.touch(slot);
+    m_slotCache.count(resident);
+
+#ifdef QT_DEBUG
+    RTSlotCache::TStatistics stats = m_slotCache.statistics();
+    qDebug("[HIDDEV] SWITCH: slot=%d resident=%d hits=%u misses=%u prefetches=%u", //
+           slot,
+           resident,
+           stats.hits,
+           stats.misses,
+           stats.prefetches);
+#endif
+
+    // controller state is updated on its own thread
+    QMetaObject::invokeMethod(
+        this,
+        [this, p, slot]() {
+            TProfile profile = p;
+            m_activeProfile.profile_index = slot;
+            updateProfile(profile, false);
+            emit profileIndexChanged(slot);
+        },
+        Qt::QueuedConnection);
+    return true;
 }
 
 inline bool RTController::readDeviceInfo()
@@ -1894,7 +2650,7 @@ inline bool RTController::setDeviceState(bool state)
 
     const quint8 *buffer = (const quint8 *) &devstate;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, devstate.report_id, buffer, devstate.size);
+    return hidWrite(hdt, devstate.report_id, buffer, devstate.size);
 }
 
 inline bool RTController::tcuWriteTest(quint8 dcuState, uint median)
@@ -1913,7 +2669,7 @@ inline bool RTController::tcuWriteTest(quint8 dcuState, uint median)
 
     const quint8 *buffer = (const quint8 *) &control;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, control.report_id, buffer, control.size);
+    return hidWrite(hdt, control.report_id, buffer, control.size);
 }
 
 inline bool RTController::tcuWriteAccept(quint8 dcuState, uint median)
@@ -1932,7 +2688,7 @@ inline bool RTController::tcuWriteAccept(quint8 dcuState, uint median)
 
     const quint8 *buffer = (const quint8 *) &control;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, control.report_id, buffer, control.size);
+    return hidWrite(hdt, control.report_id, buffer, control.size);
 }
 
 inline bool RTController::tcuWriteOff(quint8 dcuState)
@@ -1951,7 +2707,7 @@ inline bool RTController::tcuWriteOff(quint8 dcuState)
 
     const quint8 *buffer = (const quint8 *) &control;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, control.report_id, buffer, control.size);
+    return hidWrite(hdt, control.report_id, buffer, control.size);
 }
 
 inline bool RTController::tcuWriteTry(quint8 dcuState)
@@ -1970,7 +2726,7 @@ inline bool RTController::tcuWriteTry(quint8 dcuState)
 
     const quint8 *buffer = (const quint8 *) &control;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, control.report_id, buffer, control.size);
+    return hidWrite(hdt, control.report_id, buffer, control.size);
 }
 
 inline bool RTController::tcuWriteCancel(quint8 dcuState)
@@ -1989,7 +2745,7 @@ inline bool RTController::tcuWriteCancel(quint8 dcuState)
 
     const quint8 *buffer = (const quint8 *) &control;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, control.report_id, buffer, control.size);
+    return hidWrite(hdt, control.report_id, buffer, control.size);
 }
 
 inline bool RTController::dcuWriteState(quint8 dcuState)
@@ -2008,7 +2764,7 @@ inline bool RTController::dcuWriteState(quint8 dcuState)
 
     const quint8 *buffer = (const quint8 *) &control;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, control.report_id, buffer, control.size);
+    return hidWrite(hdt, control.report_id, buffer, control.size);
 }
 
 inline bool RTController::tcuReadSensor()
@@ -2023,20 +2779,16 @@ inline bool RTController::tcuReadSensorImage()
     return m_hid->readHidMessage(hdt, TYON_REPORT_ID_SENSOR, sizeof(TyonSensorImage));
 }
 
-inline bool RTController::tcuReadSensorRegister(quint8 reg)
-{
-    if (!tcuWriteSensorCommand(TYON_SENSOR_ACTION_READ, reg, 0)) {
-        return false;
-    }
-    return tcuReadSensor();
-}
-
 inline bool RTController::tcuWriteSensorCommand(quint8 action, quint8 reg, quint8 value)
 {
     if (!roccatControlCheck()) {
         return false;
     }
+    return sensorCommandWrite(action, reg, value);
+}
 
+inline bool RTController::sensorCommandWrite(quint8 action, quint8 reg, quint8 value)
+{
     TyonSensor sensor;
     sensor.report_id = TYON_REPORT_ID_SENSOR;
     sensor.action = action;
@@ -2045,7 +2797,7 @@ inline bool RTController::tcuWriteSensorCommand(quint8 action, quint8 reg, quint
 
     const quint8 *buffer = (const quint8 *) &sensor;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, sensor.report_id, buffer, sizeof(TyonSensor));
+    return hidWrite(hdt, sensor.report_id, buffer, sizeof(TyonSensor));
 }
 
 inline bool RTController::tcuWriteSensorImageCapture()
@@ -2053,18 +2805,30 @@ inline bool RTController::tcuWriteSensorImageCapture()
     return tcuWriteSensorCommand(TYON_SENSOR_ACTION_FRAME_CAPTURE, 1, 0);
 }
 
-inline bool RTController::tcuWriteSensorRegister(quint8 reg, quint8 value)
+inline bool RTController::sensorRegisterRead(quint8 reg, quint8 *value)
 {
-    return tcuWriteSensorCommand(TYON_SENSOR_ACTION_WRITE, reg, value);
+    if (!sensorCommandWrite(TYON_SENSOR_ACTION_READ, reg, 0)) {
+        return false;
+    }
+
+    TyonSensor sensor = {};
+    sensor.report_id = TYON_REPORT_ID_SENSOR;
+
+    quint8 *buffer = (quint8 *) &sensor;
+    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+    if (!m_hid->readHidMessage(hdt, TYON_REPORT_ID_SENSOR, buffer, sizeof(TyonSensor))) {
+        return false;
+    }
+
+    *value = sensor.value;
+    return true;
 }
 
 uint RTController::sensorMedianOfImage(TyonSensorImage const *image)
 {
-    uint i;
-    ulong sum = 0;
-    for (i = 0; i < TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE; ++i)
-        sum += image->data[i];
-    return (uint) (sum / (TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE));
+    TSensorStats stats;
+    RTSensorStats::compute(image, &stats);
+    return RTSensorStats::metric(stats, m_tcuMetric);
 }
 
 inline bool RTController::xcCalibWriteStart()
@@ -2080,7 +2844,7 @@ inline bool RTController::xcCalibWriteStart()
 
     const quint8 *buffer = (const quint8 *) &info;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, info.report_id, buffer, info.size);
+    return hidWrite(hdt, info.report_id, buffer, info.size);
 }
 
 inline bool RTController::xcCalibWriteEnd()
@@ -2096,7 +2860,7 @@ inline bool RTController::xcCalibWriteEnd()
 
     const quint8 *buffer = (const quint8 *) &info;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, info.report_id, buffer, info.size);
+    return hidWrite(hdt, info.report_id, buffer, info.size);
 }
 
 inline bool RTController::xcCalibWriteData(quint8 min, quint8 mid, quint8 max)
@@ -2115,7 +2879,7 @@ inline bool RTController::xcCalibWriteData(quint8 min, quint8 mid, quint8 max)
 
     const quint8 *buffer = (const quint8 *) &info;
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
-    return m_hid->writeHidMessage(hdt, info.report_id, buffer, info.size);
+    return hidWrite(hdt, info.report_id, buffer, info.size);
 }
 
 inline bool RTController::readButtonMacro(uint pix, uint bix)
@@ -2153,42 +2917,6 @@ inline bool RTController::readButtonMacro(uint pix, uint bix)
     return true;
 }
 
-inline bool RTController::selectProfileSettings(uint pix)
-{
-    if (pix >= TYON_PROFILE_NUM) {
-        raiseError(EINVAL, tr("Invalid profile index."));
-        return false;
-    }
-
-    const quint8 _req = TYON_CONTROL_REQUEST_PROFILE_SETTINGS;
-    const quint8 _dix = (TYON_CONTROL_DATA_INDEX_NONE | pix);
-    m_requestedProfile = pix;
-
-#ifdef QT_DEBUG
-    qDebug("[HIDDEV] Select profile settings. PIX=%d DIX=0x%02x REQ=0x%02x", pix, _dix, _req);
-#endif
-
-    return roccatControlWrite(_dix, _req);
-}
-
-inline bool RTController::selectProfileButtons(uint pix)
-{
-    if (pix >= TYON_PROFILE_NUM) {
-        raiseError(EINVAL, tr("Invalid profile index."));
-        return false;
-    }
-
-    const quint8 _req = TYON_CONTROL_REQUEST_PROFILE_BUTTONS;
-    const quint8 _dix = (TYON_CONTROL_DATA_INDEX_NONE | pix);
-    m_requestedProfile = pix;
-
-#ifdef QT_DEBUG
-    qDebug("[HIDDEV] Select profile buttons. PIX=%d DIX=0x%02x REQ=0x%02x", pix, _dix, _req);
-#endif
-
-    return roccatControlWrite(_dix, _req);
-}
-
 inline bool RTController::selectMacro(uint pix, uint dix, uint bix)
 {
     if (pix >= TYON_PROFILE_NUM) {
@@ -2212,7 +2940,8 @@ inline bool RTController::selectMacro(uint pix, uint dix, uint bix)
 
 inline bool RTController::talkWriteReport(TyonTalk *tyonTalk)
 {
-    if (!roccatControlCheck()) {
+    // talk reports are not stored, no check needed while the status is fresh
+    if (!isStatusFresh() && !roccatControlCheck()) {
         return false;
     }
 
@@ -2222,6 +2951,7 @@ inline bool RTController::talkWriteReport(TyonTalk *tyonTalk)
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
     const quint8 *buffer = (const quint8 *) tyonTalk;
 
+    // applied right away and not stored, the status stays valid
     return m_hid->writeHidMessage(hdt, tyonTalk->report_id, buffer, tyonTalk->size);
 }
 
@@ -2283,11 +3013,166 @@ inline bool RTController::talkWriteFxState(quint8 state)
     return talkWriteFxData(&tyonTalk);
 }
 
-inline bool RTController::roccatControlCheck()
+inline bool RTController::talkHotkey(RTHotkeyListener::TAction action, bool pressed)
+{
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Interactive);
+    if (!hasDevice()) {
+        return false;
+    }
+
+    bool on = pressed;
+    if (action == RTHotkeyListener::EasyShiftLock) {
+        if (!pressed) {
+            return true;
+        }
+        on = (m_easyshiftLocked = !m_easyshiftLocked);
+    }
+
+    // only a stored report makes the device busy; none was written since
+    // a recent status OK, so the pre-built report goes out without a check
+    if (isStatusFresh()) {
+        const TyonTalk &r = m_hotkeyReports[action][on];
+        const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+        return m_hid->writeHidMessage(hdt, r.report_id, (const quint8 *) &r, sizeof(TyonTalk));
+    }
+
+    switch (action) {
+        case RTHotkeyListener::EasyShift: {
+            return talkWriteEasyshift(on ? TYON_TALK_EASYSHIFT_ON : TYON_TALK_EASYSHIFT_OFF);
+        }
+        case RTHotkeyListener::EasyShiftLock: {
+            return talkWriteEasyshiftLock(on ? TYON_TALK_EASYSHIFT_ON : TYON_TALK_EASYSHIFT_OFF);
+        }
+        case RTHotkeyListener::EasyAim: {
+            return talkWriteEasyAim(on ? m_hotkeyReports[action][1].easyaim : (quint8) TYON_TALK_EASYAIM_OFF);
+        }
+        default: {
+            break;
+        }
+    }
+    return false;
+}
+
+inline RTTalkFxEngine::TWrite RTController::talkFxFrame(const RTTalkFxEngine::TFrame *frame)
+{
+    if (!hasDevice()) {
+        return RTTalkFxEngine::Failed;
+    }
+
+    // switching off must reach the device, a frame is dropped while busy
+    if (!frame) {
+        RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Bulk);
+        return talkWriteFxState(ROCCAT_TALKFX_STATE_OFF) ? RTTalkFxEngine::Written : RTTalkFxEngine::Failed;
+    }
+    if (!m_scheduler.tryAcquire(RTRequestScheduler::Bulk)) {
+        return RTTalkFxEngine::Busy;
+    }
+    bool ok;
+    if (frame->effect == 0) {
+        ok = talkWriteFxState(ROCCAT_TALKFX_STATE_OFF);
+    } else {
+        ok = talkWriteFx(frame->effect, frame->ambientColor, frame->eventColor);
+    }
+    m_scheduler.release();
+    return (ok ? RTTalkFxEngine::Written : RTTalkFxEngine::Failed);
+}
+
+bool RTController::runTransaction(RTTransaction *t)
+{
+    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+    RTTransaction::TStatistics stats = {};
+    bool ok = true;
+
+    // joins the step of the caller, if any
+    RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+
+    // nothing stored since a recent status OK, whichever thread wrote last
+    t->assumeIdle(isStatusFresh());
+    stats.transactions = 1;
+    stats.legacy = t->plan().legacy;
+
+    if (m_fastWrites && t->count() == 1 && t->at(0).kind == RTTransaction::Write) {
+        ok = speculativeWrite(t, &stats);
+        QMutexLocker lock(&m_transactionMutex);
+        RTTransaction::add(&m_transactionStats, stats);
+        return ok;
+    }
+
+    for (int i = 0; ok && i < t->count(); i++) {
+        TTransactionStep &s = t->step(i);
+        if (t->needsCheck(i)) {
+            stats.checks++;
+            if (!(ok = roccatControlCheck())) {
+                break;
+            }
+        }
+        stats.reports++;
+        if (s.kind == RTTransaction::Read) {
+            ok = m_hid->readHidMessage(hdt, s.rid, (quint8 *) s.data.data(), s.data.size());
+        } else if (s.kind == RTTransaction::Write) {
+            ok = hidWrite(hdt, s.rid, (const quint8 *) s.data.constData(), s.data.size());
+        } else {
+            ok = m_hid->writeHidMessage(hdt, s.rid, (const quint8 *) s.data.constData(), s.data.size());
+        }
+        s.ok = ok;
+    }
+
+    QMutexLocker lock(&m_transactionMutex);
+    RTTransaction::add(&m_transactionStats, stats);
+    return ok;
+}
+
+RTTransaction::TStatistics RTController::transactionStatistics() const
+{
+    QMutexLocker lock(&m_transactionMutex);
+    return m_transactionStats;
+}
+
+inline bool RTController::speculativeWrite(RTTransaction *t, RTTransaction::TStatistics *stats)
+{
+    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+    TTransactionStep &s = t->step(0);
+    const quint8 *buffer = (const quint8 *) s.data.constData();
+
+    // the status check after the write keeps the status fresh for the next one
+    if (isStatusFresh()) {
+        stats->speculative++;
+        stats->reports++;
+        stats->checks++;
+        if (hidWrite(hdt, s.rid, buffer, s.data.size()) && roccatControlCheck(RT_CONTROL_TIMEOUT_MS, false)) {
+            s.ok = true;
+            return true;
+        }
+        stats->retries++;
+        qWarning("[HIDDEV] Speculative write of report 0x%02x failed, retry with status check", s.rid);
+    }
+
+    // the reports written here carry the full state, writing twice is safe
+    stats->checks += 2;
+    stats->reports++;
+    s.ok = (roccatControlCheck() && hidWrite(hdt, s.rid, buffer, s.data.size()) && roccatControlCheck());
+    return s.ok;
+}
+
+inline void RTController::dispatchTransaction(const RTTransaction &t)
+{
+    for (int i = 0; i < t.count(); i++) {
+        const TTransactionStep &s = t.at(i);
+        if (s.kind == RTTransaction::Read && s.ok && m_handlers.contains(s.rid)) {
+            m_handlers[s.rid]((const quint8 *) s.data.constData(), s.data.size());
+        }
+    }
+}
+
+inline bool RTController::roccatControlCheck(int timeoutMs, bool report)
 {
     const THidDeviceType hdt = THidDeviceType::HidMouseControl;
     const quint32 rid = TYON_REPORT_ID_CONTROL;
+    const QDeadlineTimer deadline(timeoutMs, Qt::PreciseTimer);
+    ulong backoff = RT_POLL_FIRST_MS;
 
+    int error = 0;
+    QString message;
     bool ok = true;
 
     while (ok) {
@@ -2300,25 +3185,36 @@ inline bool RTController::roccatControlCheck()
         }
         switch (ctl.value) {
             case ROCCAT_CONTROL_VALUE_STATUS_OK: {
+                m_statusOkAt.store(m_statusClock.nsecsElapsed());
                 goto func_exit;
             }
             case ROCCAT_CONTROL_VALUE_STATUS_BUSY: {
-                QThread::msleep(500);
+                if (deadline.hasExpired()) {
+                    error = ETIMEDOUT;
+                    message = tr("Device busy for more than %1 ms").arg(timeoutMs);
+                    ok = false;
+                    goto func_exit;
+                }
+                QThread::msleep(qMin<ulong>(backoff, deadline.remainingTime() + 1));
+                backoff = qMin<ulong>(backoff * 2, RT_POLL_LAST_MS);
                 break;
             }
             case ROCCAT_CONTROL_VALUE_STATUS_CRITICAL_1:
             case ROCCAT_CONTROL_VALUE_STATUS_CRITICAL_2: {
-                raiseError(ctl.value, tr("Got critical device status"));
+                error = ctl.value;
+                message = tr("Got critical device status");
                 ok = false;
                 goto func_exit;
             }
             case ROCCAT_CONTROL_VALUE_STATUS_INVALID: {
-                raiseError(ctl.value, tr("Got invalid device status"));
+                error = ctl.value;
+                message = tr("Got invalid device status");
                 ok = false;
                 goto func_exit;
             }
             default: {
-                raiseError(ctl.value, tr("Got unknown device error"));
+                error = ctl.value;
+                message = tr("Got unknown device error");
                 ok = false;
                 goto func_exit;
             }
@@ -2326,9 +3222,145 @@ inline bool RTController::roccatControlCheck()
     }
 
 func_exit:
+    // critical status 1 is 0, the message marks a device error
+    if (!message.isEmpty()) {
+        if (report) {
+            raiseError(error, message);
+        } else {
+            qWarning("[HIDDEV] Status 0x%02x: %s", error, qPrintable(message));
+        }
+    }
     return ok;
 }
 
+inline void RTController::refreshStatus()
+{
+    const qint64 okAt = m_statusOkAt.load();
+    if (okAt >= 0 && m_statusClock.nsecsElapsed() - okAt < RT_STATUS_FRESH_MS * 500000LL) {
+        return;
+    }
+    // only when the device is free, a skipped refresh costs one check
+    if (!m_scheduler.tryAcquire(RTRequestScheduler::Bulk)) {
+        return;
+    }
+    bool ready = false;
+    if (hasDevice()) {
+        pollControlReady(&ready);
+    }
+    m_scheduler.release();
+}
+
+inline bool RTController::isStatusFresh() const
+{
+    const qint64 okAt = m_statusOkAt.load();
+    return (okAt >= 0 && m_statusClock.nsecsElapsed() - okAt < RT_STATUS_FRESH_MS * 1000000LL);
+}
+
+inline bool RTController::hidWrite(THidDeviceType hdt, quint32 rid, const quint8 *buffer, qsizetype length)
+{
+    // a stored report may keep the device busy
+    m_statusOkAt.store(-1);
+    return m_hid->writeHidMessage(hdt, rid, buffer, length);
+}
+
+inline bool RTController::pollControlReady(bool *ready)
+{
+    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+    RoccatControl ctl = {};
+    ctl.report_id = TYON_REPORT_ID_CONTROL;
+    if (!m_hid->readHidMessage(hdt, TYON_REPORT_ID_CONTROL, (quint8 *) &ctl, sizeof(RoccatControl))) {
+        return false;
+    }
+    switch (ctl.value) {
+        case ROCCAT_CONTROL_VALUE_STATUS_OK: {
+            m_statusOkAt.store(m_statusClock.nsecsElapsed());
+            (*ready) = true;
+            return true;
+        }
+        case ROCCAT_CONTROL_VALUE_STATUS_BUSY: {
+            (*ready) = false;
+            return true;
+        }
+        default: {
+            break;
+        }
+    }
+    // a device error, read again to report it
+    return ((*ready) = roccatControlCheck(0));
+}
+
+inline bool RTController::waitControlReady(int timeoutMs, const char *what)
+{
+    const QDeadlineTimer deadline(timeoutMs, Qt::PreciseTimer);
+    ulong backoff = RT_POLL_FIRST_MS;
+    QElapsedTimer timer;
+    timer.start();
+
+    // one step per poll, interactive requests are served in between
+    bool ready = false;
+    for (;;) {
+        {
+            RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+            if (!pollControlReady(&ready)) {
+                break;
+            }
+        }
+        if (ready) {
+            qInfo("[HIDDEV] %s: ready after %lld ms", what, (long long) timer.elapsed());
+            return true;
+        }
+        if (deadline.hasExpired()) {
+            raiseError(ETIMEDOUT, tr("Device busy for more than %1 ms").arg(timeoutMs));
+            break;
+        }
+        QThread::msleep(qMin<ulong>(backoff, deadline.remainingTime() + 1));
+        backoff = qMin<ulong>(backoff * 2, RT_POLL_LAST_MS);
+    }
+
+    qWarning("[HIDDEV] %s: not ready after %lld ms", what, (long long) timer.elapsed());
+    return false;
+}
+
+inline bool RTController::waitXCeleratorInfo(quint8 min, quint8 mid, quint8 max)
+{
+    const THidDeviceType hdt = THidDeviceType::HidMouseControl;
+    const QDeadlineTimer deadline(RT_CONTROL_TIMEOUT_MS, Qt::PreciseTimer);
+    ulong backoff = RT_POLL_FIRST_MS;
+    QElapsedTimer timer;
+    timer.start();
+
+    // the info report shows the new end points once they are stored,
+    // one step per poll as in waitControlReady()
+    for (;;) {
+        {
+            RTRequestScheduler::Step step(&m_scheduler, RTRequestScheduler::Normal);
+            bool ready = false;
+            if (!pollControlReady(&ready)) {
+                break;
+            }
+            if (ready) {
+                TyonInfo info = {};
+                info.report_id = TYON_REPORT_ID_INFO;
+                if (!m_hid->readHidMessage(hdt, TYON_REPORT_ID_INFO, (quint8 *) &info, sizeof(TyonInfo))) {
+                    return false;
+                }
+                if (info.xcelerator_min == min && info.xcelerator_mid == mid && info.xcelerator_max == max) {
+                    qInfo("[HIDDEV] X-Celerator data: stored after %lld ms", (long long) timer.elapsed());
+                    return true;
+                }
+            }
+        }
+        if (deadline.hasExpired()) {
+            break;
+        }
+        QThread::msleep(qMin<ulong>(backoff, deadline.remainingTime() + 1));
+        backoff = qMin<ulong>(backoff * 2, RT_POLL_LAST_MS);
+    }
+
+    qWarning("[HIDDEV] X-Celerator data: not confirmed after %lld ms", (long long) timer.elapsed());
+    return false;
+}
+
 inline bool RTController::roccatControlWrite(uint pix, uint req)
 {
     if (!roccatControlCheck()) {
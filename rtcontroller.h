@@ -7,16 +7,45 @@
 // ********************************************************************
 #pragma once
 #include "rtabstractdevice.h"
+#include "rthotkeylistener.h"
+#include "rtmacroplayer.h"
+#include "rtrequestscheduler.h"
+#include "rtsensorcapture.h"
+#include "rtsensorregisters.h"
+#include "rtsensorstats.h"
+#include "rtslotcache.h"
+#include "rtspecialreport.h"
+#include "rttalkfxengine.h"
+#include "rttransaction.h"
 #include "rttypedefs.h"
+#include "rtxccalibrator.h"
+#include "rtxcjoystick.h"
+#include "rtxceleratorstream.h"
 #include <QAbstractItemModel>
-#include <QColor>
+#include <QElapsedTimer>
+#include <QKeyCombination>
+#include <QLocale>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
-#include <QPushButton>
+#include <QThread>
+#include <atomic>
+#include <functional>
 
 #define HIDAPI_MAX_STR 255
 
+/* Deadline of one device operation in milliseconds */
+#define RT_CONTROL_TIMEOUT_MS 5000
+
+/* A status OK read this recently, with no write since, is still valid */
+#define RT_STATUS_FRESH_MS 250
+
+/* Focus change to active profile on the device, longer ones are logged as warnings */
+#define RT_PROFILE_SWITCH_BUDGET_MS 20
+
+/* Bit mask of all profile slots */
+#define RT_PROFILES_ALL ((1 << TYON_PROFILE_NUM) - 1)
+
 #ifndef CB_BIND
 #define CB_BIND(o, x) std::bind(x, o, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)
 #endif
@@ -110,12 +139,26 @@ public:
      */
     inline quint8 activeProfileIndex() const { return m_activeProfile.profile_index; }
 
+    /**
+     * @brief Return firmware and X-Celerator info of the device
+     * @return TyonInfo structure
+     */
+    inline TyonInfo firmwareInfo() const { return m_info; }
+
     /**
      * @brief Return number of device profiles
      * @return 5 (TYON_PROFILE_NUM)
      */
     inline quint8 profileCount() const { return m_profiles.count(); }
 
+    /**
+     * @brief Return true if the profile is read from the device, or no
+     * device sync is running. Unsynced profiles hold defaults.
+     * @param pix Profile index 0-4
+     * @return True or False
+     */
+    inline bool isProfileSynced(quint8 pix) const { return (m_syncedProfiles & (1 << pix)) != 0; }
+
     /**
      * @brief Return a profile by given profile index
      * @param pix Profile index 0-4
@@ -142,13 +185,6 @@ public:
      */
     QString profileName() const;
 
-    /**
-     * @brief Create button mapping for ROCCAT Tyon mouse button and UI push button
-     * @param rb ROCCAT Tyon mouse button descriptor
-     * @param button QT push button
-     */
-    void setupButton(const RoccatButton &rb, QPushButton *button);
-
     /**
      * @brief Assign ROCCAT Tyon button function
      * @param type Physical button
@@ -158,11 +194,17 @@ public:
     void assignButton(TyonButtonIndex type, TyonButtonType func, QKeyCombination kc);
 
     /**
-     * @brief Translate ROCCAT Tyon shortcut to QT key sequence
+     * @brief Translate ROCCAT Tyon shortcut to QT key combination
      * @param button ROCCAT Tyon button structure
-     * @return QKeySequence object
+     * @return QKeyCombination object, combined value 0 if not found
      */
-    const QKeySequence toKeySequence(const RoccatButton &button) const;
+    QKeyCombination toKeyCombination(const RoccatButton &button) const;
+
+    /**
+     * @brief Set the keyboard layout used to translate shortcuts
+     * @param locale Input method locale, system locale by default
+     */
+    inline void setKeyboardLocale(const QLocale &locale) { m_keyboardLocale = locale; }
 
     /**
      * @brief Convert Roccat sensitivity X value to UI value
@@ -186,20 +228,20 @@ public:
     quint16 toDpiLevelValue(const TyonProfileSettings *settings, quint8 index) const;
 
     /**
-     * @brief Translte QT color to ROCCAT Tyon light info
-     * @param color QT color object
+     * @brief Translte RGB color to ROCCAT Tyon light info
+     * @param rgb Color value 0xAARRGGBB, same layout as QRgb
      * @param target ROCCAT Tyon light 0=Wheel 1=Bottom
      * @return TyonColorInfo structure
      */
-    TyonLight toDeviceColor(TyonLightType target, const QColor &color) const;
+    TyonLight toDeviceColor(TyonLightType target, quint32 rgb) const;
 
     /**
      * @brief Translte ROCCAT Tyon light to UI color
      * @param light ROCCAT Tyon light info structure
      * @param isCustomColor True for custom color
-     * @return QColor object
+     * @return Color value 0xffRRGGBB, same layout as QRgb
      */
-    QColor toScreenColor(const TyonLight &light, bool isCustomColor = false) const;
+    quint32 toScreenColor(const TyonLight &light, bool isCustomColor = false) const;
 
     /**
      * @brief Return ROCCAT Tyon light color table
@@ -241,10 +283,21 @@ public:
     /**
      * @brief Calculates the surface test median from image data
      * @param image The surface image
-     * @return Number
+     * @return Number, the statistic selected by setTcuMetric()
      */
     uint sensorMedianOfImage(TyonSensorImage const *image);
 
+    /**
+     * @brief Select the image statistic written as TCU median
+     * @param metric Mean (default, like the ROCCAT driver), median or mode
+     */
+    inline void setTcuMetric(RTSensorStats::TMetric metric) { m_tcuMetric = metric; }
+
+    /**
+     * @brief Return the image statistic written as TCU median
+     */
+    inline RTSensorStats::TMetric tcuMetric() const { return m_tcuMetric; }
+
     /**
      * @brief Return the TalkFX status
      * @param settings
@@ -277,8 +330,262 @@ public:
      */
     quint8 talkFxPollRate(const TyonProfileSettings *settings) const;
 
+    /**
+     * @brief Return the device slot holding the given profile content
+     * @param profile Library profile
+     * @return Slot index 0-4 or -1 if not resident on the device
+     */
+    int residentSlot(const TProfile &profile) const;
+
+    /**
+     * @brief Return the hit/miss counters of the device slot cache
+     * @return RTSlotCache::TStatistics structure
+     */
+    inline RTSlotCache::TStatistics slotCacheStatistics() const { return m_slotCache.statistics(); }
+
+    /**
+     * @brief Return the continuous TCU sensor capture thread. Connect to
+     * its frameReady signal, then call tcuSensorStartCapture().
+     * @return RTSensorCapture object owned by the controller
+     */
+    inline RTSensorCapture *sensorCapture() const { return m_sensorCapture; }
+
+    /**
+     * @brief Return the X-Celerator paddle stream. Paddle reports are not
+     * queued as signals, UI consumers pull the stream once per frame.
+     * @return RTXCeleratorStream object owned by the controller
+     */
+    inline RTXCeleratorStream *xcStream() { return &m_xcStream; }
+
+    /**
+     * @brief Return the X-Celerator calibrator. It is fed from the input
+     * thread with every calibration value and restarted by
+     * xcStartCalibration(). Poll its progress() for the result.
+     * @return RTXCCalibrator object owned by the controller
+     */
+    inline RTXCCalibrator *xcCalibrator() { return &m_xcCalibrator; }
+
+    /**
+     * @brief Export the X-Celerator analogue values as a virtual gamepad
+     * axis (Linux uinput). The values are forwarded on the input thread.
+     * @param enable True to create, false to remove the virtual gamepad
+     * @param config Dead zone and response curve
+     * @return True on success, deviceError is raised on failure
+     */
+    bool setXcJoystick(bool enable, const RTXCJoystick::TConfig &config = RTXCJoystick::defaultConfig());
+
+    /**
+     * @brief Return the joystick forwarding statistics
+     * @return RTXCJoystick::TStatistics structure
+     */
+    inline RTXCJoystick::TStatistics xcJoystickStatistics() const { return m_xcJoystick.statistics(); }
+
+    /**
+     * @brief Start or stop the keyboard hotkeys for Easyshift, Easyshift
+     * lock and EasyAim. The talk reports are built here, the listener
+     * thread writes them without a status check while no stored report
+     * was written since the last one (Linux evdev).
+     * @param enable True to start, false to stop
+     * @param config Key bindings
+     * @return True on success, deviceError is raised on failure
+     */
+    bool setHotkeys(bool enable, const RTHotkeyListener::TConfig &config = RTHotkeyListener::defaultConfig());
+
+    /**
+     * @brief Return the key to report latency of the hotkeys
+     * @return RTHotkeyListener::TStatistics structure
+     */
+    inline RTHotkeyListener::TStatistics hotkeyStatistics() const { return m_hotkeys.statistics(); }
+
+    /**
+     * @brief Start or stop the host macros. A Quick launch button plays
+     * the macro bound to its button index, triggered on the input thread.
+     * @param enable True to start, false to stop
+     * @param config Macro files and player thread setup
+     * @return True on success, deviceError is raised on failure
+     */
+    bool setMacros(bool enable, const RTMacroPlayer::TConfig &config = RTMacroPlayer::defaultConfig());
+
+    /**
+     * @brief Return the timing error of the host macros
+     * @return RTMacroPlayer::TStatistics structure
+     */
+    inline RTMacroPlayer::TStatistics macroStatistics() const { return m_macroPlayer.statistics(); }
+
+    /**
+     * @brief Start or stop the host driven TalkFX lights. Frames are
+     * written as bulk steps and dropped while other device I/O runs, the
+     * lights return to the profile when stopped.
+     * @param enable True to start, false to stop
+     * @param config Source, frame and write rates, colors
+     * @return True on success, deviceError is raised on failure
+     */
+    bool setTalkFx(bool enable, const RTTalkFxEngine::TConfig &config = RTTalkFxEngine::defaultConfig());
+
+    /**
+     * @brief Set the TalkFX level of the external source
+     * @param level 0 to RTTalkFxEngine::LevelMax
+     */
+    inline void setTalkFxLevel(int level) { m_talkFxEngine.setLevel(level); }
+
+    /**
+     * @brief Blink the TalkFX event color while set
+     * @param active True to blink
+     */
+    inline void setTalkFxEvent(bool active) { m_talkFxEngine.setEvent(active); }
+
+    /**
+     * @brief Set the color of the following TalkFX event flashes
+     * @param color 0xRRGGBB
+     */
+    inline void setTalkFxEventColor(quint32 color) { m_talkFxEngine.setEventColor(color); }
+
+    /**
+     * @brief Return true if the TalkFX engine runs
+     */
+    inline bool isTalkFxRunning() const { return m_talkFxEngine.isRunning(); }
+
+    /**
+     * @brief Return the TalkFX frame and write rates
+     * @return RTTalkFxEngine::TStatistics structure
+     */
+    inline RTTalkFxEngine::TStatistics talkFxStatistics() const { return m_talkFxEngine.statistics(); }
+
+    /**
+     * @brief Write DCU and TCU state in one control unit report, blocking
+     * @param dcu Distance control unit level
+     * @param tcu Tracking control unit on or off
+     * @param median TCU surface value, used if tcu is true
+     * @param store True to save the setting, false to test TCU on only
+     * @return True on success
+     */
+    bool deviceWriteControlUnit(TyonControlUnitDcu dcu, bool tcu, uint median, bool store = true);
+
+    /**
+     * @brief Run sensor register reads and writes as one batch, blocking.
+     * The device status is checked once, then all register reports are
+     * sent back to back. Identity registers are served from the cache.
+     * Fails with EBUSY while the sensor capture is running.
+     * @param batch Operations in execution order, results are stored in place
+     * @return True if all operations were executed
+     */
+    bool sensorRegisterBatch(TSensorRegisterBatch *batch);
+
+    /**
+     * @brief Read all dumpable sensor registers in one batch, blocking
+     * @param snapshot Receives the register values
+     * @return True on success
+     */
+    bool sensorRegisterDump(RTSensorRegisters::TSnapshot *snapshot);
+
+    /**
+     * @brief Return the sensor register batch counters
+     * @return RTSensorRegisters::TStatistics structure
+     */
+    inline RTSensorRegisters::TStatistics sensorRegisterStatistics() const { return m_sensorRegisters.statistics(); }
+
+    /**
+     * @brief Capture and read one TCU sensor frame, blocking
+     * @param image Buffer to receive the sensor report
+     * @return True on success
+     */
+    bool tcuSensorCaptureFrame(TyonSensorImage *image);
+
+    /**
+     * @brief Run a transaction script. The control status is checked only
+     * where RTTransaction::needsCheck() requires it. Stops at the first
+     * failing step, read reports are stored in the script.
+     * @param t Script to execute
+     * @return True if all steps are executed
+     */
+    bool runTransaction(RTTransaction *t);
+
+    /**
+     * @brief Return the round trips of all transactions since the last sync
+     * @return RTTransaction::TStatistics structure
+     */
+    RTTransaction::TStatistics transactionStatistics() const;
+
+    /**
+     * @brief Return the device wait and step times per priority class
+     * @return RTRequestScheduler::TStatistics structure
+     */
+    inline RTRequestScheduler::TStatistics requestStatistics() const { return m_scheduler.statistics(); }
+
+    /**
+     * @brief Read device info, control unit and all profiles when the
+     * device is found (default). If disabled, deviceFound is emitted
+     * right away and the caller reads what it needs.
+     * @param state True or False
+     */
+    inline void setSyncOnConnect(bool state) { m_syncOnConnect = state; }
+
+    /**
+     * @brief Save all profiles to the application config on destruction (default)
+     * @param state True or False
+     */
+    inline void setAutoSave(bool state) { m_autoSave = state; }
+
+    /**
+     * @brief Enable the fast path for scripts with a single report write
+     * (off by default). If the device reported OK within RT_STATUS_FRESH_MS
+     * and nothing was written since, the report is written without the
+     * status check before it. The status is checked after the write; on
+     * failure the write is repeated with a check before and after.
+     * @param state True or False
+     */
+    inline void setFastWrites(bool state) { m_fastWrites = state; }
+
+    /**
+     * @brief Return true if the fast write path is enabled
+     */
+    inline bool fastWrites() const { return m_fastWrites; }
+
+    /*
+     * Blocking device access for one-shot tools. Each call performs
+     * only the reports it needs. Do not call on the GUI thread.
+     */
+
+    /**
+     * @brief Read firmware info and control unit
+     * @return True if success
+     */
+    bool deviceReadInfo();
+
+    /**
+     * @brief Read the active profile index
+     * @return True if success
+     */
+    bool deviceReadActiveProfile();
+
+    /**
+     * @brief Read one profile slot
+     * @param pix Profile index 0-4
+     * @param withButtons False to read the settings only
+     * @return True if success
+     */
+    bool deviceReadProfile(quint8 pix, bool withButtons = true);
+
+    /**
+     * @brief Write the profile index report
+     * @param pix Profile index 0-4
+     * @return True if success
+     */
+    bool deviceWriteActiveProfile(quint8 pix);
+
+    /**
+     * @brief Write one profile slot from memory
+     * @param pix Profile index 0-4
+     * @param withButtons False to write the settings only
+     * @return True if success
+     */
+    bool deviceWriteProfile(quint8 pix, bool withButtons = true);
+
 signals:
     void lookupStarted();
+    void lookupFinished(bool found);
+    void syncProgress(int done, int total);
+    void profileSynced(quint8 pix);
     void deviceWorkerStarted();
     void deviceWorkerFinished();
     void deviceFound();
@@ -291,8 +598,15 @@ signals:
     void sensorChanged(const TyonSensor &sensor);
     void sensorImageChanged(const TyonSensorImage &image);
     void sensorMedianChanged(int median);
-    void specialReport(uint reportId, const QByteArray &report);
+    void specialEvent(const TSpecialEvent &event);
+    void dpiSlotChanged(quint8 pix, quint8 slot);
+    void sensitivityChanged(quint8 pix, qint16 x, qint16 y);
+    void easyshiftChanged(bool enabled, bool locked);
+    void xcStreamReady();
     void talkFxChanged(const TyonTalk &talkFx);
+    void resetFinished(bool ok);
+    void xcWriteFinished(bool ok);
+    void profileActivated(quint8 pix, bool ok, qint64 elapsedNs);
 
 public slots:
     /**
@@ -322,8 +636,8 @@ public slots:
     void loadProfilesFromFile(const QString &fileName, bool raiseEvents = true);
 
     /**
-     * @brief ROCCAT Tyon device to defaults
-     * @return True if success
+     * @brief ROCCAT Tyon device to defaults. Waits for the device on the
+     * job thread, emits resetFinished() and starts a new lookup.
      */
     void resetProfiles();
 
@@ -333,6 +647,32 @@ public slots:
      */
     void setActiveProfile(quint8 index);
 
+    /**
+     * @brief Set active profile index and write only the profile index
+     * report to the device
+     * @param index A Value of 0 - 4
+     * @param timestamp Trigger time in nanoseconds (QDeadlineTimer clock)
+     * used for latency logging, 0 to disable
+     * The write runs on its own worker thread, not on the caller's or the
+     * device job thread, and emits profileActivated() when done.
+     */
+    void activateProfile(quint8 index, qint64 timestamp = 0);
+
+    /**
+     * @brief Activate a library profile on the device. A profile already
+     * resident in one of the 5 slots costs a single profile index write,
+     * otherwise the least recently used slot is overwritten.
+     * @param profile Library profile, the index field is ignored
+     */
+    void switchProfile(const RTController::TProfile &profile);
+
+    /**
+     * @brief Load predicted library profiles into free or least recently
+     * used slots ahead of time. The active slot is never overwritten.
+     * @param profiles Library profiles, most likely first
+     */
+    void prefetchProfiles(const QList<RTController::TProfile> &profiles);
+
     /**
      * @brief Set the profile name for given profile index
      * @param name The name of the profile
@@ -430,6 +770,8 @@ public slots:
     void tcuSensorCaptureImage();
     void tcuSensorReadImage();
     int tcuSensorReadMedian(TyonSensorImage *image);
+    void tcuSensorStartCapture();
+    void tcuSensorStopCapture();
 
 private slots:
     void onDeviceFound(THidDeviceType type);
@@ -473,6 +815,34 @@ private:
     TyonControlUnit m_controlUnit;
     quint8 m_requestedProfile;
     bool m_initComplete;
+    RTSlotCache m_slotCache;
+    RTSensorCapture *m_sensorCapture;
+    RTSensorRegisters m_sensorRegisters;
+    RTXCeleratorStream m_xcStream;
+    RTXCCalibrator m_xcCalibrator;
+    RTXCJoystick m_xcJoystick;
+    RTHotkeyListener m_hotkeys;
+    TyonTalk m_hotkeyReports[RTHotkeyListener::ActionCount][2];
+    bool m_easyshiftLocked;
+    RTTalkFxEngine m_talkFxEngine;
+    RTMacroPlayer m_macroPlayer;
+    RTSensorStats::TMetric m_tcuMetric;
+    bool m_syncOnConnect;
+    bool m_autoSave;
+    QElapsedTimer m_lookupTimer;
+    QThread *m_lookupThread;
+    QThread *m_syncThread;
+    QThread *m_jobThread;
+    QObject *m_jobContext;
+    quint8 m_syncedProfiles;
+    mutable QMutex m_transactionMutex;
+    RTTransaction::TStatistics m_transactionStats;
+    RTRequestScheduler m_scheduler;
+    bool m_fastWrites;
+    // last status OK, -1 after a write; read outside the scheduler step too
+    QElapsedTimer m_statusClock;
+    std::atomic<qint64> m_statusOkAt;
+    QLocale m_keyboardLocale;
     QMap<quint8, QString> m_buttonTypes;
     QMap<quint8, RTController::TPhysicalButton> m_physButtons;
 
@@ -492,20 +862,39 @@ private:
     inline void setModified(quint8 pix, bool changed);
     inline void setModified(TProfile *p, bool changed);
     inline void updateProfile(TProfile &p, bool changed);
+    inline void applySpecialEvent(const TSpecialEvent &event);
+    inline void finishLookup(bool found);
+    // initial sync, off the controller thread
+    inline void startSync();
+    inline void syncApply(const RTTransaction &t);
+    inline void syncStep(int done, int total);
+    inline void finishSync(bool ok);
+    // device jobs that wait for the device, off the controller thread
+    inline void postDeviceJob(const std::function<bool()> &job, const std::function<void(bool)> &finished);
+    // short lived device worker, the work runs on its own thread
+    inline void startWorker(QThread::Priority priority, bool notify, const std::function<void()> &work);
+    inline void postProfileUpdate(const TProfile &profile);
     // get state of device
-    inline bool roccatControlCheck();
+    inline bool roccatControlCheck(int timeoutMs = RT_CONTROL_TIMEOUT_MS, bool report = true);
+    inline bool isStatusFresh() const;
+    inline void refreshStatus();
+    inline bool hidWrite(THidDeviceType hdt, quint32 rid, const quint8 *buffer, qsizetype length);
+    inline bool speculativeWrite(RTTransaction *t, RTTransaction::TStatistics *stats);
+    inline void dispatchTransaction(const RTTransaction &t);
+    // poll without holding a scheduler step, each poll takes its own
+    inline bool pollControlReady(bool *ready);
+    inline bool waitControlReady(int timeoutMs, const char *what);
     inline bool roccatControlWrite(uint pix, uint req);
-    inline bool readDeviceControl();
     inline bool setDeviceState(bool state);
     // get firmware,DFU,X-Celerator min/max info
     inline bool readDeviceInfo();
     // get and set device profiles
     inline bool readActiveProfile();
     inline bool readProfiles(quint8 pix);
-    inline bool selectProfileSettings(uint pix);
-    inline bool readProfileSettings();
-    inline bool selectProfileButtons(uint pix);
-    inline bool readProfileButtons();
+    inline bool writeProfileIndex(quint8 pix);
+    inline bool writeProfileSlot(TProfile &p, quint8 slot, bool withButtons = true);
+    inline bool switchProfileSlot(TProfile p, quint32 pinned);
+    inline quint32 pinnedSlots() const;
     // get and set button macros
     inline bool selectMacro(uint pix, uint dix, uint bix);
     inline bool readButtonMacro(uint pix, uint bix);
@@ -513,19 +902,20 @@ private:
     inline bool xcCalibWriteStart();
     inline bool xcCalibWriteEnd();
     inline bool xcCalibWriteData(quint8 min, quint8 mid, quint8 max);
+    inline bool waitXCeleratorInfo(quint8 min, quint8 mid, quint8 max);
     // TCU calibration
     inline bool readControlUnit();
     inline bool tcuReadSensor();
     inline bool tcuReadSensorImage();
-    inline bool tcuReadSensorRegister(quint8 reg);
     inline bool tcuWriteTest(quint8 dcuState, uint median);
     inline bool tcuWriteAccept(quint8 dcuState, uint median);
     inline bool tcuWriteCancel(quint8 dcuState);
     inline bool tcuWriteOff(quint8 dcuState);
     inline bool tcuWriteTry(quint8 dcuState);
     inline bool tcuWriteSensorCommand(quint8 action, quint8 reg, quint8 value);
-    inline bool tcuWriteSensorRegister(quint8 reg, quint8 value);
     inline bool tcuWriteSensorImageCapture();
+    inline bool sensorCommandWrite(quint8 action, quint8 reg, quint8 value);
+    inline bool sensorRegisterRead(quint8 reg, quint8 *value);
     // --
     inline bool dcuWriteState(quint8 dcuState);
     // --
@@ -538,6 +928,8 @@ private:
     inline bool talkWriteFxData(TyonTalk *tyonTalk);
     inline bool talkWriteFx(quint32 effect, quint32 ambient_color, quint32 event_color);
     inline bool talkWriteFxState(quint8 state);
+    inline bool talkHotkey(RTHotkeyListener::TAction action, bool pressed);
+    inline RTTalkFxEngine::TWrite talkFxFrame(const RTTalkFxEngine::TFrame *frame);
 };
 
 Q_DECLARE_METATYPE(TyonInfo);
@@ -0,0 +1,63 @@
+# ROCCAT Tyon protocol core: RTController, HID backends and the profile
+# types. Depends on QtCore only, included by the GUI, rtyond and rtyonctl.
+# Parts used by only some of them (focus watcher, calibration sweep,
+# analyzers) are listed in their .pro files.
+QT *= core
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+mac {
+    LIBS += -framework IOKit
+    LIBS += -framework CoreFoundation
+    SOURCES += $$PWD/rthidmacos.cpp
+    HEADERS += $$PWD/rthidmacos.h
+}
+
+linux {
+    LIBS += -lhidapi-hidraw
+    LIBS += -lhidapi-libusb
+    LIBS += -lusb-1.0
+    SOURCES += $$PWD/rthidlinux.cpp
+    HEADERS += $$PWD/rthidlinux.h
+}
+
+SOURCES += \
+    $$PWD/rtabstractdevice.cpp \
+    $$PWD/rtcontroller.cpp \
+    $$PWD/rtframelog.cpp \
+    $$PWD/rthotkeylistener.cpp \
+    $$PWD/rtmacroplayer.cpp \
+    $$PWD/rtrequestscheduler.cpp \
+    $$PWD/rtsensorcapture.cpp \
+    $$PWD/rtsensorregisters.cpp \
+    $$PWD/rtsensorstats.cpp \
+    $$PWD/rtslotcache.cpp \
+    $$PWD/rtspecialreport.cpp \
+    $$PWD/rttalkfxengine.cpp \
+    $$PWD/rttransaction.cpp \
+    $$PWD/rtxccalibrator.cpp \
+    $$PWD/rtxcjoystick.cpp \
+    $$PWD/rtxceleratorstream.cpp
+
+HEADERS += \
+    $$PWD/hid_uid.h \
+    $$PWD/rtabstractdevice.h \
+    $$PWD/rtcontroller.h \
+    $$PWD/rtframelog.h \
+    $$PWD/rthiddevicedbg.hpp \
+    $$PWD/rthotkeylistener.h \
+    $$PWD/rtlatency.h \
+    $$PWD/rtmacroplayer.h \
+    $$PWD/rtrequestscheduler.h \
+    $$PWD/rtsensorcapture.h \
+    $$PWD/rtsensorregisters.h \
+    $$PWD/rtsensorstats.h \
+    $$PWD/rtslotcache.h \
+    $$PWD/rtspecialreport.h \
+    $$PWD/rttalkfxengine.h \
+    $$PWD/rttransaction.h \
+    $$PWD/rtxccalibrator.h \
+    $$PWD/rtxcjoystick.h \
+    $$PWD/rtxceleratorstream.h \
+    $$PWD/rttypedefs.h
@@ -0,0 +1,206 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtdbusadaptor.h"
+#include <QVariantList>
+
+RTDBusAdaptor::RTDBusAdaptor(RTController *controller)
+    : QDBusAbstractAdaptor(controller)
+    , m_controller(controller)
+{
+    // relay controller events, queued to the thread of the bus connection
+    connect(m_controller, &RTController::deviceFound, this, &RTDBusAdaptor::DeviceFound);
+    connect(m_controller, &RTController::deviceRemoved, this, &RTDBusAdaptor::DeviceRemoved);
+    connect(m_controller, &RTController::deviceError, this, &RTDBusAdaptor::DeviceError);
+    connect(m_controller, &RTController::profileIndexChanged, this, [this](const quint8 pix) { //
+        emit ActiveProfileChanged(pix);
+    });
+    connect(m_controller, &RTController::profileChanged, this, [this](const RTController::TProfile &p) { //
+        emit ProfileChanged(p.index);
+    });
+    connect(m_controller, &RTController::controlUnitChanged, this, [this](const TyonControlUnit &cu) { //
+        emit ControlUnitChanged(cu.dcu, cu.tcu, cu.median);
+    });
+}
+
+bool RTDBusAdaptor::hasDevice() const
+{
+    return m_controller->hasDevice();
+}
+
+uint RTDBusAdaptor::activeProfile() const
+{
+    return m_controller->activeProfileIndex();
+}
+
+QStringList RTDBusAdaptor::profileNames() const
+{
+    QStringList names;
+    for (quint8 pix = 0; pix < TYON_PROFILE_NUM; pix++) {
+        bool found = false;
+        const RTController::TProfile p = m_controller->profile(pix, found);
+        names << (found ? p.name : QString());
+    }
+    return names;
+}
+
+uint RTDBusAdaptor::firmwareVersion() const
+{
+    return m_controller->firmwareInfo().firmware_version;
+}
+
+QVariantMap RTDBusAdaptor::Profile(uint index) const
+{
+    bool found = false;
+    const RTController::TProfile p = m_controller->profile(index, found);
+    if (!found || index >= TYON_PROFILE_NUM) {
+        return {};
+    }
+
+    const TyonProfileSettings *s = &p.settings;
+    const bool custom = (s->lights_enabled & TYON_PROFILE_SETTINGS_LIGHTS_ENABLED_BIT_CUSTOM_COLOR);
+
+    QVariantList dpi;
+    for (quint8 i = 0; i < TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM; i++) {
+        dpi << (uint) m_controller->toDpiLevelValue(s, i);
+    }
+
+    QVariantMap map;
+    map["index"] = (uint) p.index;
+    map["name"] = p.name;
+    map["changed"] = p.changed;
+    map["advancedSensitivity"] = (s->advanced_sensitivity == ROCCAT_SENSITIVITY_ADVANCED_ON);
+    map["sensitivityX"] = (int) m_controller->toSensitivityXValue(s);
+    map["sensitivityY"] = (int) m_controller->toSensitivityYValue(s);
+    map["dpiLevels"] = dpi;
+    map["dpiEnabled"] = (uint) s->cpi_levels_enabled;
+    map["dpiActive"] = (uint) s->cpi_active;
+    map["pollRate"] = (uint) m_controller->talkFxPollRate(s);
+    map["lightWheel"] = (bool) (s->lights_enabled & TYON_PROFILE_SETTINGS_LIGHTS_ENABLED_BIT_WHEEL);
+    map["lightBottom"] = (bool) (s->lights_enabled & TYON_PROFILE_SETTINGS_LIGHTS_ENABLED_BIT_BOTTOM);
+    map["lightCustomColor"] = custom;
+    map["lightEffect"] = (uint) s->light_effect;
+    map["colorFlow"] = (uint) s->color_flow;
+    map["effectSpeed"] = (uint) s->effect_speed;
+    map["colorWheel"] = (uint) (m_controller->toScreenColor(s->lights[TYON_LIGHT_WHEEL], custom) & 0xffffff);
+    map["colorBottom"] = (uint) (m_controller->toScreenColor(s->lights[TYON_LIGHT_BOTTOM], custom) & 0xffffff);
+    return map;
+}
+
+QVariantMap RTDBusAdaptor::Calibration() const
+{
+    QVariantMap map;
+    map["dcu"] = (uint) m_controller->dcuState();
+    map["tcu"] = (uint) m_controller->tcuState();
+    map["median"] = m_controller->tcuMedian();
+    map["xcMin"] = (uint) m_controller->minimumXCelerate();
+    map["xcMid"] = (uint) m_controller->middleXCelerate();
+    map["xcMax"] = (uint) m_controller->maximumXCelerate();
+    return map;
+}
+
+bool RTDBusAdaptor::SetActiveProfile(uint index)
+{
+    if (index >= TYON_PROFILE_NUM) {
+        return false;
+    }
+    m_controller->activateProfile(index);
+    return true;
+}
+
+bool RTDBusAdaptor::SetProfileName(uint index, const QString &name)
+{
+    if (index >= TYON_PROFILE_NUM || name.isEmpty()) {
+        return false;
+    }
+    m_controller->setProfileName(name, index);
+    return true;
+}
+
+bool RTDBusAdaptor::SetDpiLevel(uint slot, uint dpi)
+{
+    if (slot >= TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM || dpi < TYON_CPI_MIN || dpi > TYON_CPI_MAX) {
+        return false;
+    }
+    m_controller->setDpiLevel(slot, dpi);
+    return true;
+}
+
+bool RTDBusAdaptor::SetDpiSlotEnabled(uint slot, bool state)
+{
+    if (slot >= TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM) {
+        return false;
+    }
+    m_controller->setDpiSlot(1 << slot, state);
+    return true;
+}
+
+bool RTDBusAdaptor::SetActiveDpiSlot(uint slot)
+{
+    if (slot >= TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM) {
+        return false;
+    }
+    m_controller->setActiveDpiSlot(slot);
+    return true;
+}
+
+bool RTDBusAdaptor::SetLightColor(uint target, uint rgb)
+{
+    if (target >= TYON_LIGHTS_NUM) {
+        return false;
+    }
+    const TyonLightType tlt = static_cast<TyonLightType>(target);
+    m_controller->setLightColor(tlt, m_controller->toDeviceColor(tlt, rgb));
+    return true;
+}
+
+void RTDBusAdaptor::SetLightsEnabled(bool wheel, bool bottom, bool customColor)
+{
+    m_controller->setLightWheelEnabled(wheel);
+    m_controller->setLightBottomEnabled(bottom);
+    m_controller->setLightCustomColorEnabled(customColor);
+}
+
+void RTDBusAdaptor::SetLightsEffect(uint effect)
+{
+    m_controller->setLightsEffect(effect);
+}
+
+void RTDBusAdaptor::SetColorFlow(uint flow)
+{
+    m_controller->setColorFlow(flow);
+}
+
+void RTDBusAdaptor::SetTalkFxLevel(uint level)
+{
+    m_controller->setTalkFxLevel((int) qMin<uint>(level, RTTalkFxEngine::LevelMax));
+}
+
+void RTDBusAdaptor::SetTalkFxEvent(bool active)
+{
+    m_controller->setTalkFxEvent(active);
+}
+
+void RTDBusAdaptor::Apply()
+{
+    m_controller->updateDevice();
+}
+
+void RTDBusAdaptor::LoadProfiles(const QString &fileName)
+{
+    m_controller->loadProfilesFromFile(fileName);
+}
+
+void RTDBusAdaptor::SaveProfiles(const QString &fileName)
+{
+    m_controller->saveProfilesToFile(fileName);
+}
+
+void RTDBusAdaptor::Lookup()
+{
+    m_controller->lookupDevice();
+}
@@ -0,0 +1,106 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtcontroller.h"
+#include <QDBusAbstractAdaptor>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+
+#define RT_DBUS_SERVICE "org.eof.tools.RoccatTyon"
+#define RT_DBUS_PATH "/org/eof/tools/RoccatTyon"
+
+/**
+ * @brief The RTDBusAdaptor class exports the RTController on D-Bus.
+ * Setters operate on the active profile in memory, Apply() writes all
+ * changed profiles to the device.
+ */
+class RTDBusAdaptor : public QDBusAbstractAdaptor
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", RT_DBUS_SERVICE)
+    Q_PROPERTY(bool HasDevice READ hasDevice)
+    Q_PROPERTY(uint ActiveProfile READ activeProfile)
+    Q_PROPERTY(QStringList ProfileNames READ profileNames)
+    Q_PROPERTY(uint FirmwareVersion READ firmwareVersion)
+
+public:
+    /**
+     * @brief Constructor
+     * @param controller The exported controller, also the adaptor parent
+     */
+    explicit RTDBusAdaptor(RTController *controller);
+
+    bool hasDevice() const;
+    uint activeProfile() const;
+    QStringList profileNames() const;
+    uint firmwareVersion() const;
+
+public slots:
+    /**
+     * @brief Return the settings of a profile
+     * @param index Profile index 0-4
+     * @return name, sensitivity, dpi levels, lights and polling rate
+     */
+    QVariantMap Profile(uint index) const;
+
+    /**
+     * @brief Return the TCU/DCU and X-Celerator calibration data
+     * @return dcu, tcu, median, xcMin, xcMid, xcMax
+     */
+    QVariantMap Calibration() const;
+
+    /**
+     * @brief Activate a profile, writes the profile index report only
+     * @param index Profile index 0-4
+     * @return False on invalid index
+     */
+    bool SetActiveProfile(uint index);
+
+    bool SetProfileName(uint index, const QString &name);
+    bool SetDpiLevel(uint slot, uint dpi);
+    bool SetDpiSlotEnabled(uint slot, bool state);
+    bool SetActiveDpiSlot(uint slot);
+    bool SetLightColor(uint target, uint rgb);
+    void SetLightsEnabled(bool wheel, bool bottom, bool customColor);
+    void SetLightsEffect(uint effect);
+    void SetColorFlow(uint flow);
+
+    /**
+     * @brief Set the level of the external TalkFX source, [talkfx]
+     * source=external in settings.conf
+     * @param level 0-1000, low to high color
+     */
+    void SetTalkFxLevel(uint level);
+
+    /**
+     * @brief Blink the TalkFX event color while set
+     * @param active True to blink
+     */
+    void SetTalkFxEvent(bool active);
+
+    /**
+     * @brief Write all changed profiles and the control unit to the device
+     */
+    void Apply();
+
+    void LoadProfiles(const QString &fileName);
+    void SaveProfiles(const QString &fileName);
+    void Lookup();
+
+signals:
+    void DeviceFound();
+    void DeviceRemoved();
+    void DeviceError(int error, const QString &message);
+    void ActiveProfileChanged(uint index);
+    void ProfileChanged(uint index);
+    void ControlUnitChanged(uint dcu, uint tcu, uint median);
+
+private:
+    RTController *m_controller;
+};
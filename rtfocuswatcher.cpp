@@ -0,0 +1,22 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtfocuswatcher.h"
+
+#ifdef Q_OS_LINUX
+#include "rtfocuswatcherx11.h"
+#endif
+
+RTFocusWatcher *RTFocusWatcher::create(QObject *parent)
+{
+#ifdef Q_OS_LINUX
+    return new RTFocusWatcherX11(parent);
+#else
+    Q_UNUSED(parent)
+    return nullptr;
+#endif
+}
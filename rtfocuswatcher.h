@@ -0,0 +1,57 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The focus watcher interface. Implementations report the program
+ * owning the focused window, driven by window system events only.
+ */
+class RTFocusWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent
+     */
+    explicit RTFocusWatcher(QObject *parent = nullptr)
+        : QObject(parent)
+    {}
+
+    /**
+     * @brief Create the focus watcher of the current window system
+     * @param parent
+     * @return Watcher object or nullptr if not supported
+     */
+    static RTFocusWatcher *create(QObject *parent = nullptr);
+
+    /**
+     * @brief Start watching focus changes. The current focus is reported immediately.
+     * @return True if success
+     */
+    virtual bool start() = 0;
+
+    /**
+     * @brief Stop watching focus changes
+     */
+    virtual void stop() = 0;
+
+signals:
+    /**
+     * @brief Focused window changed
+     * @param pid Process id of the window owner
+     * @param program Absolute path of the program executable
+     * @param timestamp Monotonic event time in nanoseconds (QDeadlineTimer clock)
+     */
+    void focusChanged(qint64 pid, const QString &program, qint64 timestamp);
+    void errorOccured(int error, const QString &message);
+};
@@ -0,0 +1,184 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include <QtCore/QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include "rtfocuswatcherx11.h"
+#include <QDeadlineTimer>
+#include <QFileInfo>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+RTFocusWatcherX11::RTFocusWatcherX11(QObject *parent)
+    : RTFocusWatcher(parent)
+    , m_connection(nullptr)
+    , m_root(XCB_NONE)
+    , m_activeWindow(XCB_ATOM_NONE)
+    , m_wmPid(XCB_ATOM_NONE)
+    , m_lastWindow(XCB_NONE)
+    , m_notifier(nullptr)
+{}
+
+RTFocusWatcherX11::~RTFocusWatcherX11()
+{
+    stop();
+}
+
+bool RTFocusWatcherX11::start()
+{
+    if (m_connection) {
+        return true;
+    }
+
+    int screenNum = 0;
+    m_connection = xcb_connect(nullptr, &screenNum);
+    if (xcb_connection_has_error(m_connection)) {
+        xcb_disconnect(m_connection);
+        m_connection = nullptr;
+        emit errorOccured(ECONNREFUSED, tr("Unable to connect to X11 display."));
+        return false;
+    }
+
+    xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(m_connection));
+    for (int i = 0; i < screenNum && it.rem > 1; i++) {
+        xcb_screen_next(&it);
+    }
+    m_root = it.data->root;
+
+    m_activeWindow = internAtom("_NET_ACTIVE_WINDOW");
+    m_wmPid = internAtom("_NET_WM_PID");
+    if (m_activeWindow == XCB_ATOM_NONE || m_wmPid == XCB_ATOM_NONE) {
+        stop();
+        emit errorOccured(ENOTSUP, tr("Window manager does not support _NET_ACTIVE_WINDOW."));
+        return false;
+    }
+
+    const quint32 mask[] = {XCB_EVENT_MASK_PROPERTY_CHANGE};
+    xcb_change_window_attributes(m_connection, m_root, XCB_CW_EVENT_MASK, mask);
+    xcb_flush(m_connection);
+
+    m_notifier = new QSocketNotifier(xcb_get_file_descriptor(m_connection), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &RTFocusWatcherX11::onEventsReady);
+
+    // report the window focused right now
+    notifyActiveWindow(QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs());
+    return true;
+}
+
+void RTFocusWatcherX11::stop()
+{
+    if (m_notifier) {
+        // may be called from the notifier's own signal
+        m_notifier->setEnabled(false);
+        m_notifier->deleteLater();
+        m_notifier = nullptr;
+    }
+    if (m_connection) {
+        xcb_disconnect(m_connection);
+        m_connection = nullptr;
+    }
+    m_lastWindow = XCB_NONE;
+}
+
+void RTFocusWatcherX11::onEventsReady()
+{
+    xcb_generic_event_t *event = xcb_poll_for_event(m_connection);
+
+    while (event) {
+        const qint64 timestamp = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        bool changed = false;
+
+        do {
+            if ((event->response_type & ~0x80) == XCB_PROPERTY_NOTIFY) {
+                xcb_property_notify_event_t *pn = (xcb_property_notify_event_t *) event;
+                if (pn->window == m_root && pn->atom == m_activeWindow) {
+                    changed = true;
+                }
+            }
+            free(event);
+        } while ((event = xcb_poll_for_event(m_connection)));
+
+        if (changed) {
+            notifyActiveWindow(timestamp);
+        }
+
+        // waiting for replies may queue events without waking the notifier
+        event = xcb_poll_for_queued_event(m_connection);
+    }
+
+    if (xcb_connection_has_error(m_connection)) {
+        stop();
+        emit errorOccured(EPIPE, tr("Lost connection to X11 display."));
+    }
+}
+
+inline xcb_atom_t RTFocusWatcherX11::internAtom(const char *name)
+{
+    xcb_intern_atom_cookie_t cookie = xcb_intern_atom(m_connection, 1, strlen(name), name);
+    xcb_intern_atom_reply_t *reply = xcb_intern_atom_reply(m_connection, cookie, nullptr);
+    if (!reply) {
+        return XCB_ATOM_NONE;
+    }
+    xcb_atom_t atom = reply->atom;
+    free(reply);
+    return atom;
+}
+
+inline xcb_window_t RTFocusWatcherX11::queryActiveWindow()
+{
+    xcb_get_property_cookie_t cookie = xcb_get_property(m_connection, 0, m_root, m_activeWindow, XCB_ATOM_WINDOW, 0, 1);
+    xcb_get_property_reply_t *reply = xcb_get_property_reply(m_connection, cookie, nullptr);
+    if (!reply) {
+        return XCB_NONE;
+    }
+    xcb_window_t window = XCB_NONE;
+    if (xcb_get_property_value_length(reply) >= (int) sizeof(xcb_window_t)) {
+        window = *(xcb_window_t *) xcb_get_property_value(reply);
+    }
+    free(reply);
+    return window;
+}
+
+inline qint64 RTFocusWatcherX11::queryWindowPid(xcb_window_t window)
+{
+    xcb_get_property_cookie_t cookie = xcb_get_property(m_connection, 0, window, m_wmPid, XCB_ATOM_CARDINAL, 0, 1);
+    xcb_get_property_reply_t *reply = xcb_get_property_reply(m_connection, cookie, nullptr);
+    if (!reply) {
+        return 0;
+    }
+    qint64 pid = 0;
+    if (xcb_get_property_value_length(reply) >= (int) sizeof(quint32)) {
+        pid = *(quint32 *) xcb_get_property_value(reply);
+    }
+    free(reply);
+    return pid;
+}
+
+inline void RTFocusWatcherX11::notifyActiveWindow(qint64 timestamp)
+{
+    xcb_window_t window = queryActiveWindow();
+    if (window == XCB_NONE || window == m_lastWindow) {
+        return;
+    }
+    m_lastWindow = window;
+
+    qint64 pid = queryWindowPid(window);
+    if (pid <= 0) {
+        return;
+    }
+
+    const QString program = QFileInfo(QStringLiteral("/proc/%1/exe").arg(pid)).symLinkTarget();
+    if (program.isEmpty()) {
+        return;
+    }
+
+    emit focusChanged(pid, program, timestamp);
+}
+
+#endif // Q_OS_LINUX
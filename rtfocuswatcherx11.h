@@ -0,0 +1,61 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QtCore/QtGlobal>
+#include "rtfocuswatcher.h"
+
+#ifdef Q_OS_LINUX
+#include <QObject>
+#include <QSocketNotifier>
+
+#include <xcb/xcb.h>
+
+/**
+ * @brief X11 focus watcher. Listens for _NET_ACTIVE_WINDOW property
+ * changes on the root window using its own xcb connection.
+ */
+class RTFocusWatcherX11 : public RTFocusWatcher
+{
+    Q_OBJECT
+
+public:
+    explicit RTFocusWatcherX11(QObject *parent = nullptr);
+
+    /** */
+    ~RTFocusWatcherX11();
+
+    /**
+     * @brief Connect to the X server and subscribe root window property events
+     * @return True if success
+     */
+    bool start() override;
+
+    /**
+     * @brief Disconnect from the X server
+     */
+    void stop() override;
+
+private slots:
+    void onEventsReady();
+
+private:
+    xcb_connection_t *m_connection;
+    xcb_window_t m_root;
+    xcb_atom_t m_activeWindow;
+    xcb_atom_t m_wmPid;
+    xcb_window_t m_lastWindow;
+    QSocketNotifier *m_notifier;
+
+private:
+    inline xcb_atom_t internAtom(const char *name);
+    inline xcb_window_t queryActiveWindow();
+    inline qint64 queryWindowPid(xcb_window_t window);
+    inline void notifyActiveWindow(qint64 timestamp);
+};
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,133 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtframeanalyzer.h"
+#include "rtsensorstats.h"
+#include <QList>
+#include <QRunnable>
+#include <QThreadPool>
+#include <math.h>
+#include <string.h>
+#include <utility>
+
+#define RT_PIXELS (TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE)
+
+// frames per work item
+#define RT_ANALYZER_CHUNK 256
+
+/**
+ * Partial per-pixel sums of one chunk, merged after all chunks finished
+ */
+typedef struct
+{
+    quint64 sum[RT_PIXELS];
+    quint64 sumSquares[RT_PIXELS];
+} TPixelSums;
+
+static void analyzeChunk(const TFrameLogRecord *records, quint64 first, quint64 last, RTFrameAnalyzer::TFrameSummary *out, TPixelSums *sums)
+{
+    memset(sums, 0, sizeof(TPixelSums));
+    for (quint64 i = first; i < last; i++) {
+        const TFrameLogRecord *r = &records[i];
+        TSensorStats stats;
+        RTSensorStats::compute(r->data, RT_PIXELS, &stats);
+
+        RTFrameAnalyzer::TFrameSummary *s = &out[i];
+        s->timestamp = r->timestamp;
+        s->mean = stats.mean;
+        s->variance = stats.variance;
+        s->median = stats.median;
+        s->min = stats.min;
+        s->max = stats.max;
+        s->dcu = r->dcu;
+        s->tcu = r->tcu;
+
+        for (int p = 0; p < RT_PIXELS; p++) {
+            const quint32 v = r->data[p];
+            sums->sum[p] += v;
+            sums->sumSquares[p] += v * v;
+        }
+    }
+}
+
+bool RTFrameAnalyzer::analyze(const RTFrameLog &log, TResult *result)
+{
+    // count and mapping read once, the workers take no lock
+    const quint64 n = log.count();
+    const TFrameLogRecord *records = log.records();
+    *result = {};
+    if (n == 0 || !records) {
+        return false;
+    }
+
+    result->frames = n;
+    result->perFrame.resize(n);
+
+    const quint64 chunks = (n + RT_ANALYZER_CHUNK - 1) / RT_ANALYZER_CHUNK;
+    QList<TPixelSums> partial(chunks);
+    TFrameSummary *perFrame = result->perFrame.data();
+
+    // own pool, waitForDone() must not wait for tasks of other modules
+    QThreadPool pool;
+    for (quint64 c = 0; c < chunks; c++) {
+        const quint64 first = c * RT_ANALYZER_CHUNK;
+        const quint64 last = qMin<quint64>(first + RT_ANALYZER_CHUNK, n);
+        TPixelSums *sums = &partial[c];
+        pool.start([records, first, last, perFrame, sums]() { //
+            analyzeChunk(records, first, last, perFrame, sums);
+        });
+    }
+    pool.waitForDone();
+
+    // per-pixel temporal statistics
+    result->pixelMean.resize(RT_PIXELS);
+    result->pixelVariance.resize(RT_PIXELS);
+    double noise = 0;
+    for (int p = 0; p < RT_PIXELS; p++) {
+        quint64 sum = 0, sumSquares = 0;
+        for (const TPixelSums &s : std::as_const(partial)) {
+            sum += s.sum[p];
+            sumSquares += s.sumSquares[p];
+        }
+        const double mean = (double) sum / n;
+        const double variance = qMax(0.0, (double) sumSquares / n - mean * mean);
+        result->pixelMean[p] = mean;
+        result->pixelVariance[p] = variance;
+        noise += sqrt(variance);
+    }
+    result->temporalNoise = noise / RT_PIXELS;
+
+    // frame statistics and least squares slope of the frame mean
+    const qint64 t0 = perFrame[0].timestamp;
+    double st = 0, sm = 0, stt = 0, stm = 0, smed = 0, sdev = 0;
+    for (quint64 i = 0; i < n; i++) {
+        const double t = (perFrame[i].timestamp - t0) / 1e9;
+        const double m = perFrame[i].mean;
+        st += t;
+        sm += m;
+        stt += t * t;
+        stm += t * m;
+        smed += perFrame[i].median;
+        sdev += sqrt(perFrame[i].variance);
+    }
+    result->mean = sm / n;
+    result->median = smed / n;
+    result->spatialNoise = sdev / n;
+    result->duration = (perFrame[n - 1].timestamp - t0) / 1e9;
+    result->fps = (result->duration > 0 ? (n - 1) / result->duration : 0);
+    const double d = n * stt - st * st;
+    result->drift = (d > 0 ? (n * stm - st * sm) / d : 0);
+
+    const quint64 tenth = qMax<quint64>(n / 10, 1);
+    double head = 0, tail = 0;
+    for (quint64 i = 0; i < tenth; i++) {
+        head += perFrame[i].mean;
+        tail += perFrame[n - 1 - i].mean;
+    }
+    result->driftTotal = (tail - head) / tenth;
+    return true;
+}
@@ -0,0 +1,62 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtframelog.h"
+#include <QVector>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The RTFrameAnalyzer class computes offline surface statistics of
+ * a recorded frame log. Frames are processed in parallel on the global
+ * QThreadPool.
+ */
+class RTFrameAnalyzer
+{
+public:
+    /**
+     * @brief Statistics of one frame
+     */
+    typedef struct
+    {
+        qint64 timestamp; // ns
+        double mean;
+        double variance;
+        quint8 median;
+        quint8 min;
+        quint8 max;
+        quint8 dcu;
+        quint8 tcu;
+    } TFrameSummary;
+
+    /**
+     * @brief Analysis result of a log
+     */
+    typedef struct
+    {
+        quint64 frames;               // analyzed frames
+        double duration;              // seconds between first and last frame
+        double fps;                   // frames per second
+        double mean;                  // mean of the frame means
+        double median;                // mean of the frame medians
+        double spatialNoise;          // mean of the per-frame standard deviation
+        double temporalNoise;         // mean of the per-pixel standard deviation over time
+        double drift;                 // slope of the frame mean, per second
+        double driftTotal;            // mean of the last minus the first 10% of the frames
+        QVector<double> pixelMean;     // per-pixel mean over time
+        QVector<double> pixelVariance; // per-pixel variance over time
+        QVector<TFrameSummary> perFrame;
+    } TResult;
+
+    /**
+     * @brief Analyze all records of an open log
+     * @param log Frame log opened with openRead()
+     * @param result Analysis result
+     * @return False if the log has no frames
+     */
+    static bool analyze(const RTFrameLog &log, TResult *result);
+};
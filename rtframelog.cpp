@@ -0,0 +1,196 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtframelog.h"
+#include <QMutexLocker>
+#include <string.h>
+
+// file grows by this many records, the mapping is renewed on growth
+#define RT_FRAMELOG_GROW 4096
+
+static inline qint64 recordOffset(quint64 index)
+{
+    return sizeof(TFrameLogHeader) + (qint64) index * sizeof(TFrameLogRecord);
+}
+
+RTFrameLog::RTFrameLog()
+    : m_mutex()
+    , m_file()
+    , m_map(nullptr)
+    , m_mapSize(0)
+    , m_writable(false)
+    , m_error()
+{}
+
+RTFrameLog::~RTFrameLog()
+{
+    close();
+}
+
+inline bool RTFrameLog::mapFile(qint64 size)
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_writable && m_file.size() != size && !m_file.resize(size)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    if (!(m_map = m_file.map(0, size))) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_mapSize = size;
+    return true;
+}
+
+bool RTFrameLog::openAppend(const QString &fileName)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_map) {
+        m_error = QStringLiteral("Frame log already open");
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadWrite)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_writable = true;
+
+    quint64 count = 0;
+    if (m_file.size() >= (qint64) sizeof(TFrameLogHeader)) {
+        TFrameLogHeader h;
+        if (m_file.read((char *) &h, sizeof(h)) != sizeof(h) //
+            || memcmp(h.magic, RT_FRAMELOG_MAGIC, 4) != 0 || h.recordSize != sizeof(TFrameLogRecord)) {
+            m_error = QStringLiteral("Not a frame log: %1").arg(fileName);
+            m_file.close();
+            return false;
+        }
+        count = h.count;
+    }
+
+    const qint64 size = recordOffset(count + RT_FRAMELOG_GROW);
+    if (!mapFile(size)) {
+        m_file.close();
+        return false;
+    }
+
+    TFrameLogHeader *h = header();
+    memcpy(h->magic, RT_FRAMELOG_MAGIC, 4);
+    h->version = RT_FRAMELOG_VERSION;
+    h->edge = TYON_SENSOR_IMAGE_SIZE;
+    h->recordSize = sizeof(TFrameLogRecord);
+    h->reserved = 0;
+    h->count = count;
+    return true;
+}
+
+bool RTFrameLog::openRead(const QString &fileName)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_map) {
+        m_error = QStringLiteral("Frame log already open");
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_writable = false;
+
+    if (m_file.size() < (qint64) sizeof(TFrameLogHeader) || !mapFile(m_file.size())) {
+        m_error = QStringLiteral("Not a frame log: %1").arg(fileName);
+        m_file.close();
+        return false;
+    }
+
+    const TFrameLogHeader *h = header();
+    if (memcmp(h->magic, RT_FRAMELOG_MAGIC, 4) != 0 || h->recordSize != sizeof(TFrameLogRecord)) {
+        m_error = QStringLiteral("Not a frame log: %1").arg(fileName);
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void RTFrameLog::close()
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_map) {
+        return;
+    }
+    const quint64 count = header()->count;
+    m_file.unmap(m_map);
+    m_map = nullptr;
+    m_mapSize = 0;
+    if (m_writable) {
+        m_file.resize(recordOffset(count));
+    }
+    m_file.close();
+}
+
+bool RTFrameLog::append(const TSensorFrame &frame, quint8 dcu, quint8 tcu)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_map || !m_writable) {
+        return false;
+    }
+
+    const quint64 index = header()->count;
+    if (recordOffset(index + 1) > m_mapSize) {
+        if (!mapFile(recordOffset(index + RT_FRAMELOG_GROW))) {
+            return false;
+        }
+    }
+
+    TFrameLogRecord *r = (TFrameLogRecord *) (m_map + recordOffset(index));
+    r->timestamp = frame.timestamp;
+    r->sequence = frame.sequence;
+    r->dcu = dcu;
+    r->tcu = tcu;
+    r->median = (quint8) frame.median;
+    memset(r->reserved, 0, sizeof(r->reserved));
+    memcpy(r->data, frame.image.data, sizeof(r->data));
+
+    // publish the record after its data
+    header()->count = index + 1;
+    return true;
+}
+
+quint64 RTFrameLog::count() const
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_map) {
+        return 0;
+    }
+    // a truncated file holds fewer records than the header claims
+    const quint64 fit = (m_mapSize - sizeof(TFrameLogHeader)) / sizeof(TFrameLogRecord);
+    return qMin(header()->count, fit);
+}
+
+const TFrameLogRecord *RTFrameLog::records() const
+{
+    if (!m_map) {
+        return nullptr;
+    }
+    return (const TFrameLogRecord *) (m_map + recordOffset(0));
+}
+
+const TFrameLogRecord *RTFrameLog::record(quint64 index) const
+{
+    if (index >= count()) {
+        return nullptr;
+    }
+    return (const TFrameLogRecord *) (m_map + recordOffset(index));
+}
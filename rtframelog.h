@@ -0,0 +1,121 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtsensorcapture.h"
+#include "rttypedefs.h"
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QtCore/QtGlobal>
+
+#define RT_FRAMELOG_MAGIC "RTFL"
+#define RT_FRAMELOG_VERSION 1
+
+/**
+ * @brief Frame log file header
+ */
+struct _TFrameLogHeader
+{
+    char magic[4];      // RT_FRAMELOG_MAGIC
+    quint16 version;    // RT_FRAMELOG_VERSION
+    quint16 edge;       // image width and height (30)
+    quint32 recordSize; // sizeof(TFrameLogRecord)
+    quint32 reserved;
+    quint64 count;      // number of valid records
+} __attribute__((packed));
+typedef struct _TFrameLogHeader TFrameLogHeader;
+
+/**
+ * @brief One recorded sensor frame
+ */
+struct _TFrameLogRecord
+{
+    qint64 timestamp; // capture time in ns
+    quint64 sequence; // capture counter
+    quint8 dcu;       // distance control unit state
+    quint8 tcu;       // tracking control unit state
+    quint8 median;    // TCU value of the frame
+    quint8 reserved[5];
+    quint8 data[TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE];
+} __attribute__((packed));
+typedef struct _TFrameLogRecord TFrameLogRecord;
+
+/**
+ * @brief The RTFrameLog class is an append-only, memory-mapped log of TCU
+ * sensor frames. The record count in the header is updated after each
+ * record, so a log stays readable if the writer is killed.
+ */
+class RTFrameLog
+{
+public:
+    RTFrameLog();
+    ~RTFrameLog();
+
+    /**
+     * @brief Open a log for appending, create it if it does not exist
+     * @param fileName Path of the log file
+     * @return True on success, see errorString()
+     */
+    bool openAppend(const QString &fileName);
+
+    /**
+     * @brief Open an existing log for reading
+     * @param fileName Path of the log file
+     * @return True on success, see errorString()
+     */
+    bool openRead(const QString &fileName);
+
+    /**
+     * @brief Flush and close the log, the file is truncated to its records
+     */
+    void close();
+
+    /**
+     * @brief Append a captured frame
+     * @param frame Captured frame
+     * @param dcu Distance control unit state
+     * @param tcu Tracking control unit state
+     * @return True on success
+     */
+    bool append(const TSensorFrame &frame, quint8 dcu, quint8 tcu);
+
+    /**
+     * @brief Return the number of records
+     */
+    quint64 count() const;
+
+    /**
+     * @brief Return a record, valid until close()
+     * @param index Record index
+     * @return Pointer into the mapping or nullptr
+     */
+    const TFrameLogRecord *record(quint64 index) const;
+
+    /**
+     * @brief Return the first record without locking, for logs no longer
+     * appended to. Indexes below count() stay valid until close().
+     * @return Pointer into the mapping or nullptr
+     */
+    const TFrameLogRecord *records() const;
+
+    bool isOpen() const { return m_map != nullptr; }
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+
+private:
+    inline bool mapFile(qint64 size);
+    inline TFrameLogHeader *header() const { return (TFrameLogHeader *) m_map; }
+
+private:
+    mutable QMutex m_mutex;
+    QFile m_file;
+    uchar *m_map;
+    qint64 m_mapSize;
+    bool m_writable;
+    QString m_error;
+};
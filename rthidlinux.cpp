@@ -13,6 +13,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <getopt.h>
@@ -30,31 +31,69 @@ static inline void debugReport(const char *where, quint32 rid, const quint8 *buf
 RTHidLinux::RTHidLinux(QObject *parent)
     : RTAbstractDevice(parent)
     , m_devices()
+    , m_fds()
     , m_handlers()
     , m_monitor(nullptr)
     , m_mutex()
+    , m_lookupMutex()
+    , m_lookupThread(nullptr)
     , m_timer(this)
 {
     hid_init();
 
     m_timer.setInterval(2000);
     m_timer.setTimerType(Qt::CoarseTimer);
-    connect(&m_timer, &QTimer::timeout, this, [this](){ //
-        if (m_devices.isEmpty()) {
-            QList<quint32> products;
-            products.append(USB_DEVICE_ID_ROCCAT_TYON_BLACK);
-            products.append(USB_DEVICE_ID_ROCCAT_TYON_WHITE);
-            lookupDevices(USB_DEVICE_ID_VENDOR_ROCCAT, products);
-        }
-    });
+    connect(&m_timer, &QTimer::timeout, this, &RTHidLinux::retryLookup);
 }
 
 RTHidLinux::~RTHidLinux()
 {
+    m_timer.stop();
+    if (m_lookupThread) {
+        // the finished handler no longer runs for this object
+        m_lookupThread->wait();
+        delete m_lookupThread;
+    }
     releaseDevices();
     hid_exit();
 }
 
+inline void RTHidLinux::retryLookup()
+{
+    // a retry is still enumerating
+    if (m_lookupThread) {
+        return;
+    }
+
+    m_mutex.lock();
+    const bool found = !m_devices.isEmpty();
+    m_mutex.unlock();
+    if (found) {
+        return;
+    }
+
+    QList<quint32> products;
+    products.append(USB_DEVICE_ID_ROCCAT_TYON_BLACK);
+    products.append(USB_DEVICE_ID_ROCCAT_TYON_WHITE);
+
+    // hidapi enumerates synchronously, keep it off the GUI thread
+    m_lookupThread = new QThread();
+    connect(
+        m_lookupThread,
+        &QThread::started,
+        m_lookupThread,
+        [this, products]() {
+            lookupDevices(USB_DEVICE_ID_VENDOR_ROCCAT, products);
+            QThread::currentThread()->exit(0);
+        },
+        Qt::DirectConnection);
+    connect(m_lookupThread, &QThread::finished, this, [this]() { //
+        m_lookupThread->deleteLater();
+        m_lookupThread = nullptr;
+    });
+    m_lookupThread->start();
+}
+
 inline void RTHidLinux::releaseDevices()
 {
     if (m_monitor) {
@@ -62,6 +101,11 @@ inline void RTHidLinux::releaseDevices()
         m_monitor->wait();
         m_monitor = 0L;
     }
+
+    QMutexLocker lock(&m_mutex);
+    foreach (THidDeviceType type, m_fds.keys()) {
+        hidCloseRaw(type);
+    }
 }
 
 void RTHidLinux::registerHandlers(const TReportHandlers &handlers)
@@ -71,6 +115,7 @@ void RTHidLinux::registerHandlers(const TReportHandlers &handlers)
 
 bool RTHidLinux::hasDevice() const
 {
+    QMutexLocker lock(&m_mutex);
     return !m_devices.isEmpty();
 }
 
@@ -84,6 +129,9 @@ bool RTHidLinux::lookupDevices(quint32 vendorId, QList<quint32> products)
 {
     hid_device_info* devices;
 
+    // the controller and the retry timer enumerate on their own worker threads
+    QMutexLocker lookup(&m_lookupMutex);
+
     emit lookupStarted();
 
     // cleanup prior findings
@@ -112,14 +160,18 @@ bool RTHidLinux::lookupDevices(quint32 vendorId, QList<quint32> products)
                 THidDevice d = {};
                 d.path = QString::fromLatin1(info->path);
                 d.interface = info->interface_number;
+                m_mutex.lock();
                 m_devices[HidMouseControl] = d;
+                m_mutex.unlock();
             }
             /* X-Celerator input interface */
             else if (info->usage == kHIDUsageMisc && info->usage_page == kHIDPageMisc) {
                 THidDevice d = {};
                 d.path = QString::fromLatin1(info->path);
                 d.interface = info->interface_number;
+                m_mutex.lock();
                 m_devices[HidMouseInput] = d;
+                m_mutex.unlock();
                 hidMonitor(d);
             }
 
@@ -131,18 +183,22 @@ bool RTHidLinux::lookupDevices(quint32 vendorId, QList<quint32> products)
         hid_free_enumeration(devices);
     }
 
-    // notify if control interface found
-    foreach(auto key, m_devices.keys()) {
-        if (key == HidMouseControl) {
-            if (m_timer.isActive()) {
-                m_timer.stop();
-            }
-            emit deviceFound(key);
-            return true;
-        }
+    m_mutex.lock();
+    const bool found = m_devices.contains(HidMouseControl);
+    m_mutex.unlock();
+
+    // notify if control interface found, the timer belongs to the thread of this object
+    if (found) {
+        QMetaObject::invokeMethod(&m_timer, [this]() { //
+            m_timer.stop();
+        });
+        emit deviceFound(HidMouseControl);
+        return true;
     }
 
-    m_timer.start();
+    QMetaObject::invokeMethod(&m_timer, [this]() { //
+        m_timer.start();
+    });
     return false;
 }
 
@@ -156,21 +212,53 @@ inline THidDevice RTHidLinux::toDevice(THidDeviceType type) const
 
 bool RTHidLinux::openDevice(THidDeviceType type)
 {
-    Q_UNUSED(type)
-    return true;
+    QMutexLocker lock(&m_mutex);
+    return hidOpenRaw(type) >= 0;
 }
 
 bool RTHidLinux::closeDevice(THidDeviceType type)
 {
-    Q_UNUSED(type)
+    QMutexLocker lock(&m_mutex);
+    hidCloseRaw(type);
     return true;
 }
 
+// The hidraw node stays open between reports, a re-open costs a
+// path lookup and permission check in the kernel for every report.
+// Must be called with m_mutex locked.
+inline int RTHidLinux::hidOpenRaw(THidDeviceType type)
+{
+    if (m_fds.contains(type)) {
+        return m_fds[type];
+    }
+
+    const THidDevice d = toDevice(type);
+    if (d.path.isEmpty()) {
+        return -1;
+    }
+
+    int fd = ::open(d.path.toLatin1().constData(), O_RDWR | O_CLOEXEC);
+    if (fd != -1) {
+        m_fds[type] = fd;
+    }
+    return fd;
+}
+
+// Must be called with m_mutex locked.
+inline void RTHidLinux::hidCloseRaw(THidDeviceType type)
+{
+    if (m_fds.contains(type)) {
+        ::close(m_fds.take(type));
+    }
+}
+
 inline void RTHidLinux::hidMonitor(const THidDevice& device)
 {
     const Qt::ConnectionType ct = Qt::DirectConnection;
 
     m_monitor = new RTHidMonitor(device);
+    // created on the lookup thread, deleted from the event loop of this object
+    m_monitor->moveToThread(thread());
     connect(m_monitor, &RTHidMonitor::errorOccured, this, [this](int error, const QString &message) { //
         raiseError(error, message);
     }, ct);
@@ -194,17 +282,18 @@ inline int RTHidLinux::hidReadRaw(THidDeviceType type, qsizetype length, quint8*
 {
     QMutexLocker lock(&m_mutex);
 
-    const THidDevice d = toDevice(type);
     int retval;
     int fd;
 
-    fd = ::open(d.path.toLatin1().constData(), O_RDWR);
+    fd = hidOpenRaw(type);
     if (fd == -1) {
         return ENODEV;
     }
 
     retval = ioctl(fd, HIDIOCGFEATURE(length), buffer);
     if (retval == -1) {
+        // device may be gone, open again on next request
+        hidCloseRaw(type);
         retval = EIO;
     } else {
         retval = 0;
@@ -216,7 +305,6 @@ inline int RTHidLinux::hidReadRaw(THidDeviceType type, qsizetype length, quint8*
     }
 #endif
 
-    ::close(fd);
     return retval;
 }
 
@@ -224,7 +312,6 @@ inline int RTHidLinux::hidWriteRaw(THidDeviceType type, qsizetype length, const
 {
     QMutexLocker lock(&m_mutex);
 
-    const THidDevice d = toDevice(type);
     int retval;
     int fd;
 
@@ -232,19 +319,20 @@ inline int RTHidLinux::hidWriteRaw(THidDeviceType type, qsizetype length, const
     debugReport("hidWriteRaw", buffer[0], buffer, length);
 #endif
 
-    fd = ::open(d.path.toLatin1().constData(), O_RDWR);
+    fd = hidOpenRaw(type);
     if (fd == -1) {
         return ENODEV;
     }
 
     retval = ioctl(fd, HIDIOCSFEATURE(length), buffer);
     if (retval == -1) {
+        // device may be gone, open again on next request
+        hidCloseRaw(type);
         retval = EIO;
     } else {
         retval = 0;
     }
 
-    ::close(fd);
     return retval;
 }
 
@@ -322,16 +410,21 @@ void RTHidMonitor::run()
 
     // for select() timeout
     struct timeval tv = {};
-    tv.tv_usec = 10000;
 
     while(!isInterruptionRequested()) {
+        // Linux select() modifies the timeout, it must be set on every
+        // call. The timeout only bounds the interruption check latency.
+        tv.tv_sec = 0;
+        tv.tv_usec = 250000;
         readSet = fdSet;
         ret = ::select(fd + 1, &readSet, NULL, NULL, &tv);
         if (ret < 0) { // Error handling
+            if (errno == EINTR) {
+                continue;
+            }
             emit errorOccured(EIO, "Unable to monitor HID input interface.");
             break;
         } else if (ret == 0) { // Timeout, loop again
-            this->yieldCurrentThread();
             continue;
         } else {
             ret = ::read(fd, buffer, length);
@@ -102,15 +102,21 @@ public slots:
 private:
     friend class RTHidMonitor;
     QMap<THidDeviceType, THidDevice> m_devices;
+    QMap<THidDeviceType, int> m_fds;
     TReportHandlers m_handlers;
     RTHidMonitor* m_monitor;
-    QMutex m_mutex;
+    mutable QMutex m_mutex;
+    QMutex m_lookupMutex;
+    QThread *m_lookupThread;
     QTimer m_timer;
 
 private:
+    inline void retryLookup();
     inline void releaseDevices();
     inline THidDevice toDevice(THidDeviceType type) const;
     inline void hidMonitor(const THidDevice& device);
+    inline int hidOpenRaw(THidDeviceType type);
+    inline void hidCloseRaw(THidDeviceType type);
     inline int hidReadRaw(THidDeviceType type, qsizetype length, quint8* buffer);
     inline int hidWriteRaw(THidDeviceType type, qsizetype length, const quint8* buffer);
 };
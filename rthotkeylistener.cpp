@@ -0,0 +1,306 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rthotkeylistener.h"
+#include "rttypedefs.h"
+#include <QDir>
+#include <QMutexLocker>
+#include <QSettings>
+#include <errno.h>
+#include <string.h>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#define RT_KEY(k) {#k, k}
+
+static const struct
+{
+    const char *name;
+    int code;
+} s_keyNames[] = {
+    RT_KEY(KEY_ESC),         RT_KEY(KEY_TAB),         RT_KEY(KEY_CAPSLOCK),    RT_KEY(KEY_SPACE),
+    RT_KEY(KEY_LEFTCTRL),    RT_KEY(KEY_RIGHTCTRL),   RT_KEY(KEY_LEFTSHIFT),   RT_KEY(KEY_RIGHTSHIFT),
+    RT_KEY(KEY_LEFTALT),     RT_KEY(KEY_RIGHTALT),    RT_KEY(KEY_LEFTMETA),    RT_KEY(KEY_RIGHTMETA),
+    RT_KEY(KEY_GRAVE),       RT_KEY(KEY_COMPOSE),     RT_KEY(KEY_SCROLLLOCK),  RT_KEY(KEY_PAUSE),
+    RT_KEY(KEY_INSERT),      RT_KEY(KEY_DELETE),      RT_KEY(KEY_HOME),        RT_KEY(KEY_END),
+    RT_KEY(KEY_PAGEUP),      RT_KEY(KEY_PAGEDOWN),    RT_KEY(KEY_ENTER),       RT_KEY(KEY_BACKSPACE),
+    RT_KEY(KEY_UP),          RT_KEY(KEY_DOWN),        RT_KEY(KEY_LEFT),        RT_KEY(KEY_RIGHT),
+    RT_KEY(KEY_MINUS),       RT_KEY(KEY_EQUAL),       RT_KEY(KEY_COMMA),       RT_KEY(KEY_DOT),
+    RT_KEY(KEY_SLASH),       RT_KEY(KEY_SEMICOLON),   RT_KEY(KEY_APOSTROPHE),  RT_KEY(KEY_BACKSLASH),
+    RT_KEY(KEY_LEFTBRACE),   RT_KEY(KEY_RIGHTBRACE),  RT_KEY(KEY_A),           RT_KEY(KEY_B),
+    RT_KEY(KEY_C),           RT_KEY(KEY_D),           RT_KEY(KEY_E),           RT_KEY(KEY_F),
+    RT_KEY(KEY_G),           RT_KEY(KEY_H),           RT_KEY(KEY_I),           RT_KEY(KEY_J),
+    RT_KEY(KEY_K),           RT_KEY(KEY_L),           RT_KEY(KEY_M),           RT_KEY(KEY_N),
+    RT_KEY(KEY_O),           RT_KEY(KEY_P),           RT_KEY(KEY_Q),           RT_KEY(KEY_R),
+    RT_KEY(KEY_S),           RT_KEY(KEY_T),           RT_KEY(KEY_U),           RT_KEY(KEY_V),
+    RT_KEY(KEY_W),           RT_KEY(KEY_X),           RT_KEY(KEY_Y),           RT_KEY(KEY_Z),
+    RT_KEY(KEY_0),           RT_KEY(KEY_1),           RT_KEY(KEY_2),           RT_KEY(KEY_3),
+    RT_KEY(KEY_4),           RT_KEY(KEY_5),           RT_KEY(KEY_6),           RT_KEY(KEY_7),
+    RT_KEY(KEY_8),           RT_KEY(KEY_9),           RT_KEY(KEY_F1),          RT_KEY(KEY_F2),
+    RT_KEY(KEY_F3),          RT_KEY(KEY_F4),          RT_KEY(KEY_F5),          RT_KEY(KEY_F6),
+    RT_KEY(KEY_F7),          RT_KEY(KEY_F8),          RT_KEY(KEY_F9),          RT_KEY(KEY_F10),
+    RT_KEY(KEY_F11),         RT_KEY(KEY_F12),         RT_KEY(KEY_F13),         RT_KEY(KEY_F14),
+    RT_KEY(KEY_F15),         RT_KEY(KEY_F16),         RT_KEY(KEY_F17),         RT_KEY(KEY_F18),
+    RT_KEY(KEY_F19),         RT_KEY(KEY_F20),         RT_KEY(KEY_F21),         RT_KEY(KEY_F22),
+    RT_KEY(KEY_F23),         RT_KEY(KEY_F24),
+};
+#endif
+
+RTHotkeyListener::TConfig RTHotkeyListener::defaultConfig()
+{
+    TConfig config = {};
+    config.easyAimLevel = TYON_TALK_EASYAIM_1;
+    return config;
+}
+
+bool RTHotkeyListener::loadConfig(QSettings *settings, TConfig *config)
+{
+    static const char *const names[ActionCount] = {
+        "easyshift",
+        "easyshiftLock",
+        "easyaim",
+    };
+
+    *config = defaultConfig();
+    settings->beginGroup("hotkeys");
+    const bool enabled = settings->value("enabled", false).toBool();
+    for (int a = 0; a < ActionCount; a++) {
+        config->keys[a] = keyCode(settings->value(names[a]).toString());
+    }
+    config->easyAimLevel = qBound<int>(TYON_TALK_EASYAIM_1, settings->value("easyaimLevel", TYON_TALK_EASYAIM_1).toInt(), TYON_TALK_EASYAIM_5);
+    settings->endGroup();
+    return enabled;
+}
+
+int RTHotkeyListener::keyCode(const QString &name)
+{
+    bool ok;
+    const int code = name.toInt(&ok);
+    if (ok) {
+        return (code > 0 && code < KeyCodeCount ? code : 0);
+    }
+#ifdef Q_OS_LINUX
+    const QByteArray key = name.trimmed().toUpper().toLatin1();
+    for (const auto &k : s_keyNames) {
+        if (key == k.name) {
+            return k.code;
+        }
+    }
+#endif
+    return 0;
+}
+
+RTHotkeyListener::RTHotkeyListener(QObject *parent)
+    : QThread(parent)
+    , m_mutex()
+    , m_fds()
+    , m_wake{-1, -1}
+    , m_handler()
+    , m_idle()
+    , m_actions()
+    , m_metricsLog(qEnvironmentVariableIntValue("RT_HOTKEY_METRICS") > 0)
+    , m_failures(0)
+    , m_overBudget(0)
+    , m_latency()
+{
+    memset(m_actions, -1, sizeof(m_actions));
+}
+
+RTHotkeyListener::~RTHotkeyListener()
+{
+    close();
+}
+
+bool RTHotkeyListener::open(const TConfig &config, const THandler &handler, QString *error)
+{
+    close();
+
+    QMutexLocker lock(&m_mutex);
+    memset(m_actions, -1, sizeof(m_actions));
+    bool bound = false;
+    for (int a = 0; a < ActionCount; a++) {
+        const int code = config.keys[a];
+        if (code > 0 && code < KeyCodeCount) {
+            m_actions[code] = (qint8) a;
+            bound = true;
+        }
+    }
+    if (!bound) {
+        *error = QStringLiteral("No hotkey is bound.");
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    const QDir dir(QStringLiteral("/dev/input"));
+    const QStringList nodes = dir.entryList({QStringLiteral("event*")}, QDir::System);
+    for (const QString &node : nodes) {
+        const QByteArray path = dir.absoluteFilePath(node).toLocal8Bit();
+        const int fd = ::open(path.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        // only devices with at least one of the bound keys
+        quint8 keys[KeyCodeCount / 8] = {};
+        bool match = false;
+        if (ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) >= 0) {
+            for (int code = 1; code < KeyCodeCount && !match; code++) {
+                match = (m_actions[code] >= 0 && (keys[code / 8] & (1 << (code % 8))));
+            }
+        }
+        // event time stamps on the same clock as the measurement
+        const int clock = CLOCK_MONOTONIC;
+        if (!match || ioctl(fd, EVIOCSCLOCKID, &clock) < 0) {
+            ::close(fd);
+            continue;
+        }
+        m_fds.append(fd);
+    }
+
+    if (m_fds.isEmpty()) {
+        *error = QStringLiteral("No keyboard with the hotkeys found (needs read access to /dev/input/event*).");
+        return false;
+    }
+    if (pipe2(m_wake, O_CLOEXEC | O_NONBLOCK) < 0) {
+        *error = QStringLiteral("pipe: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        closeDevices();
+        return false;
+    }
+
+    m_handler = handler;
+    qInfo("[HOTKEY] Listening on %lld keyboards", (long long) m_fds.count());
+    lock.unlock();
+
+    // the handler writes the talk report, keep it ahead of the GUI
+    start(QThread::TimeCriticalPriority);
+    return true;
+#else
+    Q_UNUSED(handler);
+    *error = QStringLiteral("The hotkeys need Linux evdev.");
+    return false;
+#endif
+}
+
+void RTHotkeyListener::close()
+{
+    if (isRunning()) {
+        requestInterruption();
+#ifdef Q_OS_LINUX
+        const char c = 0;
+        if (::write(m_wake[1], &c, 1) < 0) {
+            qWarning("[HOTKEY] Wake up failed: %s", strerror(errno));
+        }
+#endif
+        wait();
+    }
+    QMutexLocker lock(&m_mutex);
+    closeDevices();
+}
+
+inline void RTHotkeyListener::closeDevices()
+{
+#ifdef Q_OS_LINUX
+    for (int fd : std::as_const(m_fds)) {
+        ::close(fd);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (m_wake[i] >= 0) {
+            ::close(m_wake[i]);
+        }
+    }
+#endif
+    m_fds.clear();
+    m_wake[0] = -1;
+    m_wake[1] = -1;
+}
+
+void RTHotkeyListener::run()
+{
+#ifdef Q_OS_LINUX
+    QList<struct pollfd> pfds;
+    pfds.append({m_wake[0], POLLIN, 0});
+    for (int fd : std::as_const(m_fds)) {
+        pfds.append({fd, POLLIN, 0});
+    }
+
+    struct input_event events[64];
+    qint64 idleAt = RTLatency::monotonicNs() + IdleMs * 1000000LL;
+    while (!isInterruptionRequested()) {
+        const int timeout = (m_idle ? (int) qBound<qint64>(0, (idleAt - RTLatency::monotonicNs()) / 1000000, IdleMs) : -1);
+        if (poll(pfds.data(), pfds.count(), timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qWarning("[HOTKEY] poll: %s", strerror(errno));
+            break;
+        }
+        if (pfds[0].revents) {
+            break;
+        }
+        for (qsizetype i = 1; i < pfds.count(); i++) {
+            if (pfds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                // keyboard unplugged, the others keep working
+                pfds[i].fd = -1;
+                continue;
+            }
+            if (!(pfds[i].revents & POLLIN)) {
+                continue;
+            }
+            const ssize_t n = ::read(pfds[i].fd, events, sizeof(events));
+            for (ssize_t e = 0; e < n / (ssize_t) sizeof(struct input_event); e++) {
+                const struct input_event &ev = events[e];
+                // 0 release, 1 press, 2 auto repeat
+                if (ev.type != EV_KEY || ev.value > 1 || ev.code >= KeyCodeCount || m_actions[ev.code] < 0) {
+                    continue;
+                }
+                const bool ok = m_handler((TAction) m_actions[ev.code], ev.value == 1);
+                const qint64 stamp = (qint64) ev.input_event_sec * 1000000000LL + (qint64) ev.input_event_usec * 1000;
+                if (!ok) {
+                    m_failures.fetchAndAddRelaxed(1);
+                }
+                measure(RTLatency::monotonicNs() - stamp);
+            }
+        }
+        // key events first, then the idle work
+        if (m_idle && RTLatency::monotonicNs() >= idleAt) {
+            m_idle();
+            idleAt = RTLatency::monotonicNs() + IdleMs * 1000000LL;
+        }
+    }
+#endif
+}
+
+RTHotkeyListener::TStatistics RTHotkeyListener::statistics() const
+{
+    TStatistics stats = {};
+    stats.events = m_latency.events();
+    stats.failures = m_failures.loadRelaxed();
+    stats.overBudget = m_overBudget.loadRelaxed();
+    stats.meanUs = m_latency.meanUs();
+    stats.maxUs = m_latency.maxUs();
+    stats.p99Us = m_latency.percentileUs(99);
+    return stats;
+}
+
+inline void RTHotkeyListener::measure(qint64 ns)
+{
+    ns = qMax<qint64>(ns, 0);
+    m_latency.add(ns);
+
+    if (ns > BudgetUs * 1000LL) {
+        m_overBudget.fetchAndAddRelaxed(1);
+    }
+    if (m_metricsLog) {
+        qInfo("[HOTKEY] key to report %.1f us", ns / 1000.0);
+    }
+}
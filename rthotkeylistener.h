@@ -0,0 +1,156 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtlatency.h"
+#include <QAtomicInteger>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QtCore/QtGlobal>
+#include <functional>
+
+class QSettings;
+
+/**
+ * @brief The RTHotkeyListener thread reads the keyboards (Linux evdev) and
+ * calls the handler for the keys bound to Easyshift, Easyshift lock and
+ * EasyAim directly on the listener thread, without a Qt event in between.
+ * The keys are not grabbed, other applications still receive them. The
+ * time from the kernel event time stamp to the return of the handler is
+ * measured against a budget of BudgetUs.
+ */
+class RTHotkeyListener : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum TAction {
+        EasyShift = 0, // second button layer while held
+        EasyShiftLock, // toggles the second button layer
+        EasyAim,       // sniper DPI while held
+        ActionCount,
+    };
+
+    enum {
+        KeyCodeCount = 0x300, // KEY_CNT
+        LatencyBuckets = 64,  // 50 us each, the last one collects the rest
+        LatencyBucketUs = 50,
+        BudgetUs = 2000,
+        IdleMs = 100, // idle handler period
+    };
+
+    /**
+     * @brief Key bindings, evdev key codes, 0 = unbound
+     */
+    typedef struct
+    {
+        int keys[ActionCount]; // key code per action
+        quint8 easyAimLevel;   // TYON_TALK_EASYAIM_1..5
+    } TConfig;
+
+    /**
+     * @brief Listener statistics
+     */
+    typedef struct
+    {
+        quint64 events;     // bound key presses and releases
+        quint64 failures;   // handler failures
+        quint64 overBudget; // events over BudgetUs
+        double meanUs;      // mean time from key event to handler return
+        double maxUs;       // longest event
+        double p99Us;       // 99th percentile, 50 us resolution
+    } TStatistics;
+
+    /**
+     * @brief Called on the listener thread for each bound key press and
+     * release. Returns true if the report was written.
+     */
+    typedef std::function<bool(TAction action, bool pressed)> THandler;
+
+    /**
+     * @brief Called on the listener thread every IdleMs, after the key
+     * events, to keep the device state needed by the handler up to date
+     */
+    typedef std::function<void()> TIdleHandler;
+
+    /**
+     * @brief Return the default bindings: all unbound, EasyAim level 1
+     * @return TConfig structure
+     */
+    static TConfig defaultConfig();
+
+    /**
+     * @brief Read the [hotkeys] group of the settings. Keys are given as
+     * evdev names (KEY_CAPSLOCK) or numbers.
+     * @param settings Application settings
+     * @param config Receives the bindings
+     * @return True if the hotkeys are enabled
+     */
+    static bool loadConfig(QSettings *settings, TConfig *config);
+
+    /**
+     * @brief Translate a key name or number into an evdev key code
+     * @param name KEY_* name or decimal code
+     * @return Key code or 0 if unknown
+     */
+    static int keyCode(const QString &name);
+
+    explicit RTHotkeyListener(QObject *parent = nullptr);
+
+    /**
+     * @brief Stop the thread and close the keyboards
+     */
+    ~RTHotkeyListener();
+
+    /**
+     * @brief Open all keyboards with at least one bound key and start the
+     * listener thread
+     * @param config Key bindings
+     * @param handler Called for bound keys on the listener thread
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(const TConfig &config, const THandler &handler, QString *error);
+
+    /**
+     * @brief Set the idle handler, takes effect with the next open()
+     * @param idle Handler or an empty function
+     */
+    inline void setIdleHandler(const TIdleHandler &idle) { m_idle = idle; }
+
+    /**
+     * @brief Stop the thread and close the keyboards
+     */
+    void close();
+
+    /**
+     * @brief Return the listener statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+protected:
+    void run() override;
+
+private:
+    QMutex m_mutex;
+    QList<int> m_fds;
+    int m_wake[2];
+    THandler m_handler;
+    TIdleHandler m_idle;
+    qint8 m_actions[KeyCodeCount];
+    bool m_metricsLog;
+    QAtomicInteger<quint64> m_failures;
+    QAtomicInteger<quint64> m_overBudget;
+    RTLatencyHistogram<LatencyBuckets, LatencyBucketUs> m_latency;
+
+private:
+    inline void closeDevices();
+    inline void measure(qint64 ns);
+};
@@ -0,0 +1,104 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QAtomicInteger>
+#include <QtCore/QtGlobal>
+#include <time.h>
+
+/**
+ * @brief The RTLatency class reads the clock shared by the latency
+ * measurements. CLOCK_MONOTONIC is the clock of the evdev time stamps.
+ */
+class RTLatency
+{
+public:
+    /**
+     * @brief Return the monotonic clock in nanoseconds
+     */
+    static inline qint64 monotonicNs()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (qint64) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+};
+
+/**
+ * @brief The RTLatencyHistogram class collects latencies lock free from one
+ * real-time thread while another one reads them. Buckets are BucketUs
+ * wide, the last one collects the rest.
+ */
+template<int Buckets, int BucketUs>
+class RTLatencyHistogram
+{
+public:
+    RTLatencyHistogram()
+        : m_events(0)
+        , m_totalNs(0)
+        , m_maxNs(0)
+        , m_buckets()
+    {}
+
+    /**
+     * @brief Add one latency, negative values count as 0
+     * @param ns Latency in nanoseconds
+     * @return Number of latencies added so far
+     */
+    inline quint64 add(qint64 ns)
+    {
+        ns = qMax<qint64>(ns, 0);
+        const quint64 events = m_events.fetchAndAddRelaxed(1) + 1;
+        m_totalNs.fetchAndAddRelaxed(ns);
+        if ((quint64) ns > m_maxNs.loadRelaxed()) {
+            m_maxNs.storeRelaxed(ns);
+        }
+        const int bucket = qMin((int) (ns / 1000 / BucketUs), Buckets - 1);
+        m_buckets[bucket].fetchAndAddRelaxed(1);
+        return events;
+    }
+
+    inline quint64 events() const { return m_events.loadRelaxed(); }
+
+    inline double meanUs() const
+    {
+        const quint64 events = m_events.loadRelaxed();
+        return (events > 0 ? m_totalNs.loadRelaxed() / 1000.0 / events : 0);
+    }
+
+    inline double maxUs() const { return m_maxNs.loadRelaxed() / 1000.0; }
+
+    /**
+     * @brief Return the upper bucket edge that holds the given percentile
+     * @param percent Percentile 1-100
+     * @return Microseconds, 0 without latencies
+     */
+    inline double percentileUs(int percent) const
+    {
+        quint64 total = 0;
+        for (int i = 0; i < Buckets; i++) {
+            total += m_buckets[i].loadRelaxed();
+        }
+        if (total == 0) {
+            return 0;
+        }
+        quint64 n = 0;
+        for (int i = 0; i < Buckets; i++) {
+            n += m_buckets[i].loadRelaxed();
+            if (n * 100 >= total * percent) {
+                return (i + 1) * BucketUs;
+            }
+        }
+        return Buckets * BucketUs;
+    }
+
+private:
+    QAtomicInteger<quint64> m_events;
+    QAtomicInteger<quint64> m_totalNs;
+    QAtomicInteger<quint64> m_maxNs;
+    QAtomicInteger<quint32> m_buckets[Buckets];
+};
@@ -0,0 +1,486 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtmacroplayer.h"
+#include "rthotkeylistener.h"
+#include "rttypedefs.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <QSettings>
+#include <errno.h>
+#include <string.h>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#else
+#define EV_SYN 0x00
+#define EV_KEY 0x01
+#define SYN_REPORT 0
+#endif
+
+RTMacroPlayer::TConfig RTMacroPlayer::defaultConfig()
+{
+    TConfig config = {};
+    config.cpu = -1;
+    config.priority = DefaultPriority;
+    config.spinUs = DefaultSpinUs;
+    return config;
+}
+
+bool RTMacroPlayer::loadConfig(QSettings *settings, TConfig *config)
+{
+    *config = defaultConfig();
+    settings->beginGroup("macros");
+    const bool enabled = settings->value("enabled", false).toBool();
+    for (int slot = 0; slot < MacroSlots; slot++) {
+        config->files[slot] = settings->value(QStringLiteral("button%1").arg(slot)).toString();
+    }
+    config->cpu = settings->value("cpu", config->cpu).toInt();
+    config->priority = qBound(1, settings->value("priority", config->priority).toInt(), 99);
+    config->spinUs = qBound(0, settings->value("spinUs", config->spinUs).toInt(), 10000);
+    settings->endGroup();
+    return enabled;
+}
+
+bool RTMacroPlayer::compile(const QString &text, TMacro *macro, QString *error)
+{
+    macro->clear();
+    qint64 at = 0;
+    const QStringList lines = text.split('\n');
+    for (qsizetype n = 0; n < lines.count(); n++) {
+        const QString line = lines.at(n).section('#', 0, 0).simplified();
+        if (line.isEmpty()) {
+            continue;
+        }
+        const QStringList parts = line.split(' ');
+        const QString step = parts.first().toLower();
+        if (parts.count() != 2) {
+            *error = QStringLiteral("line %1: expected '<step> <argument>'").arg(n + 1);
+            return false;
+        }
+
+        if (step == QStringLiteral("wait")) {
+            // plain numbers are milliseconds like the device periods
+            QString value = parts.at(1).toLower();
+            double scale = 1e6;
+            if (value.endsWith(QStringLiteral("us"))) {
+                scale = 1e3;
+                value.chop(2);
+            } else if (value.endsWith(QStringLiteral("ms"))) {
+                value.chop(2);
+            } else if (value.endsWith('s')) {
+                scale = 1e9;
+                value.chop(1);
+            }
+            bool ok;
+            const double delay = value.toDouble(&ok);
+            if (!ok || delay < 0) {
+                *error = QStringLiteral("line %1: invalid delay '%2'").arg(n + 1).arg(parts.at(1));
+                return false;
+            }
+            at += qRound64(delay * scale);
+            continue;
+        }
+
+        const int key = RTHotkeyListener::keyCode(parts.at(1));
+        if (key == 0) {
+            *error = QStringLiteral("line %1: unknown key '%2'").arg(n + 1).arg(parts.at(1));
+            return false;
+        }
+        const bool press = (step == QStringLiteral("press") || step == QStringLiteral("tap"));
+        const bool release = (step == QStringLiteral("release") || step == QStringLiteral("tap"));
+        if (!press && !release) {
+            *error = QStringLiteral("line %1: unknown step '%2'").arg(n + 1).arg(parts.first());
+            return false;
+        }
+        // every key change is its own report, a tap reaches the clients as two
+        if (press) {
+            macro->append({at, EV_KEY, (quint16) key, 1});
+            macro->append({at, EV_SYN, SYN_REPORT, 0});
+        }
+        if (release) {
+            macro->append({at, EV_KEY, (quint16) key, 0});
+            macro->append({at, EV_SYN, SYN_REPORT, 0});
+        }
+    }
+
+    if (macro->isEmpty()) {
+        *error = QStringLiteral("The macro has no keys.");
+        return false;
+    }
+    return true;
+}
+
+RTMacroPlayer::RTMacroPlayer(QObject *parent)
+    : QThread(parent)
+    , m_mutex()
+    , m_macros()
+    , m_config(defaultConfig())
+    , m_fd(-1)
+    , m_timer(-1)
+    , m_wake{-1, -1}
+    , m_metricsLog(qEnvironmentVariableIntValue("RT_MACRO_METRICS") > 0)
+    , m_playing(0)
+    , m_realtime(0)
+    , m_plays(0)
+    , m_ignored(0)
+    , m_failures(0)
+    , m_errors()
+{}
+
+RTMacroPlayer::~RTMacroPlayer()
+{
+    close();
+}
+
+bool RTMacroPlayer::open(const TConfig &config, QString *error)
+{
+    QList<TMacro> macros(MacroSlots);
+    for (int slot = 0; slot < MacroSlots; slot++) {
+        const QString &fileName = config.files[slot];
+        if (fileName.isEmpty()) {
+            continue;
+        }
+        QFile f(fileName);
+        if (!f.open(QFile::ReadOnly | QFile::Text)) {
+            *error = QStringLiteral("%1: %2").arg(fileName, f.errorString());
+            return false;
+        }
+        QString reason;
+        if (!compile(QString::fromUtf8(f.readAll()), &macros[slot], &reason)) {
+            *error = QStringLiteral("%1: %2").arg(fileName, reason);
+            return false;
+        }
+    }
+    return open(macros, config, error);
+}
+
+bool RTMacroPlayer::open(const QList<TMacro> &macros, const TConfig &config, QString *error)
+{
+    close();
+
+    QMutexLocker lock(&m_mutex);
+    m_macros = macros;
+    m_macros.resize(MacroSlots);
+    m_config = config;
+
+#ifdef Q_OS_LINUX
+    const int fd = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        *error = QStringLiteral("/dev/uinput: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    m_fd = fd;
+
+    // only the keys the macros use
+    bool ok = (ioctl(fd, UI_SET_EVBIT, EV_KEY) >= 0);
+    int bound = 0;
+    for (const TMacro &macro : std::as_const(m_macros)) {
+        bound += (macro.isEmpty() ? 0 : 1);
+        for (const TMacroEvent &e : macro) {
+            if (ok && e.type == EV_KEY) {
+                ok = (ioctl(fd, UI_SET_KEYBIT, e.code) >= 0);
+            }
+        }
+    }
+
+    struct uinput_setup setup = {};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = USB_DEVICE_ID_VENDOR_ROCCAT;
+    setup.id.product = USB_DEVICE_ID_ROCCAT_TYON_BLACK;
+    setup.id.version = 1;
+    strncpy(setup.name, "ROCCAT Tyon Macro", UINPUT_MAX_NAME_SIZE - 1);
+
+    if (!ok //
+        || ioctl(fd, UI_DEV_SETUP, &setup) < 0
+        || ioctl(fd, UI_DEV_CREATE) < 0) {
+        *error = QStringLiteral("uinput: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        closeDevice();
+        return false;
+    }
+
+    m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (m_timer < 0 || pipe2(m_wake, O_CLOEXEC | O_NONBLOCK) < 0) {
+        *error = QStringLiteral("timerfd: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        closeDevice();
+        return false;
+    }
+
+    qInfo("[MACRO] Virtual keyboard created, %d macros", bound);
+    lock.unlock();
+
+    // raised to SCHED_FIFO by the thread itself
+    start(QThread::TimeCriticalPriority);
+    return true;
+#else
+    *error = QStringLiteral("The macro player needs Linux uinput.");
+    return false;
+#endif
+}
+
+void RTMacroPlayer::close()
+{
+    if (isRunning()) {
+        requestInterruption();
+#ifdef Q_OS_LINUX
+        const char c = 0;
+        if (::write(m_wake[1], &c, 1) < 0) {
+            qWarning("[MACRO] Wake up failed: %s", strerror(errno));
+        }
+#endif
+        wait();
+    }
+    QMutexLocker lock(&m_mutex);
+    closeDevice();
+}
+
+inline void RTMacroPlayer::closeDevice()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ioctl(m_fd, UI_DEV_DESTROY);
+        ::close(m_fd);
+    }
+    if (m_timer >= 0) {
+        ::close(m_timer);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (m_wake[i] >= 0) {
+            ::close(m_wake[i]);
+        }
+    }
+#endif
+    m_fd = -1;
+    m_timer = -1;
+    m_wake[0] = -1;
+    m_wake[1] = -1;
+}
+
+bool RTMacroPlayer::trigger(int slot)
+{
+    QMutexLocker lock(&m_mutex);
+    if (slot < 0 || slot >= m_macros.count() || m_macros.at(slot).isEmpty() || m_wake[1] < 0) {
+        return false;
+    }
+#ifdef Q_OS_LINUX
+    const quint8 c = (quint8) slot;
+    if (::write(m_wake[1], &c, 1) < 0) {
+        m_failures.fetchAndAddRelaxed(1);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void RTMacroPlayer::setupThread()
+{
+#ifdef Q_OS_LINUX
+    if (m_config.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(m_config.cpu, &set);
+        const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            qWarning("[MACRO] Pinning to CPU %d failed: %s", m_config.cpu, strerror(rc));
+        }
+    }
+
+    // needs CAP_SYS_NICE or an RLIMIT_RTPRIO of at least the priority
+    struct sched_param sp = {};
+    sp.sched_priority = m_config.priority;
+    const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+    if (rc != 0) {
+        qWarning("[MACRO] SCHED_FIFO %d not granted: %s", m_config.priority, strerror(rc));
+    }
+    m_realtime.storeRelaxed(rc == 0 ? 1 : 0);
+#endif
+}
+
+void RTMacroPlayer::run()
+{
+#ifdef Q_OS_LINUX
+    setupThread();
+
+    struct pollfd pfd = {m_wake[0], POLLIN, 0};
+    quint8 pending[16];
+    while (!isInterruptionRequested()) {
+        if (poll(&pfd, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qWarning("[MACRO] poll: %s", strerror(errno));
+            break;
+        }
+        if (isInterruptionRequested()) {
+            break;
+        }
+        const ssize_t n = ::read(m_wake[0], pending, sizeof(pending));
+        if (n <= 0) {
+            continue;
+        }
+        // one macro at a time, presses queued behind it are dropped
+        if (n > 1) {
+            m_ignored.fetchAndAddRelaxed(n - 1);
+        }
+        if (pending[0] < m_macros.count() && !m_macros.at(pending[0]).isEmpty()) {
+            play(m_macros.at(pending[0]));
+        }
+    }
+#endif
+}
+
+inline bool RTMacroPlayer::waitUntil(qint64 deadline)
+{
+#ifdef Q_OS_LINUX
+    // sleep on the timer until the spin phase, triggers are ignored meanwhile
+    const qint64 wakeAt = deadline - m_config.spinUs * 1000LL;
+    if (wakeAt > RTLatency::monotonicNs()) {
+        struct itimerspec its = {};
+        its.it_value.tv_sec = wakeAt / 1000000000LL;
+        its.it_value.tv_nsec = wakeAt % 1000000000LL;
+        timerfd_settime(m_timer, TFD_TIMER_ABSTIME, &its, nullptr);
+
+        struct pollfd pfds[2] = {{m_timer, POLLIN, 0}, {m_wake[0], POLLIN, 0}};
+        for (;;) {
+            if (poll(pfds, 2, -1) < 0 && errno != EINTR) {
+                return false;
+            }
+            if (pfds[1].revents & POLLIN) {
+                quint8 drop[16];
+                const ssize_t n = ::read(m_wake[0], drop, sizeof(drop));
+                if (isInterruptionRequested()) {
+                    return false;
+                }
+                m_ignored.fetchAndAddRelaxed(qMax<ssize_t>(n, 0));
+            }
+            if (pfds[0].revents & POLLIN) {
+                quint64 expired;
+                if (::read(m_timer, &expired, sizeof(expired)) < 0) {
+                    // spurious, the spin below keeps the deadline
+                }
+                break;
+            }
+        }
+    }
+    while (RTLatency::monotonicNs() < deadline) {
+        // spin the last microseconds, the timer wake up jitters more
+    }
+    return true;
+#else
+    Q_UNUSED(deadline);
+    return false;
+#endif
+}
+
+inline bool RTMacroPlayer::play(const TMacro &macro)
+{
+#ifdef Q_OS_LINUX
+    m_playing.storeRelaxed(1);
+    QList<quint16> held;
+    bool ok = true;
+    const qint64 start = RTLatency::monotonicNs();
+
+    qsizetype i = 0;
+    while (i < macro.count()) {
+        // events with the same offset go out in one write
+        const qint64 deadline = start + macro.at(i).atNs;
+        struct input_event ev[16];
+        qsizetype n = 0;
+        while (i + n < macro.count() && n < 16 && macro.at(i + n).atNs == macro.at(i).atNs) {
+            const TMacroEvent &e = macro.at(i + n);
+            ev[n] = {};
+            ev[n].type = e.type;
+            ev[n].code = e.code;
+            ev[n].value = e.value;
+            n++;
+        }
+
+        if (!waitUntil(deadline)) {
+            ok = false;
+            break;
+        }
+        if (::write(m_fd, ev, n * sizeof(struct input_event)) != (ssize_t) (n * sizeof(struct input_event))) {
+            m_failures.fetchAndAddRelaxed(1);
+        } else {
+            // only keys the system has seen pressed need a release
+            for (qsizetype k = 0; k < n; k++) {
+                if (ev[k].type != EV_KEY) {
+                    continue;
+                }
+                if (ev[k].value) {
+                    if (!held.contains(ev[k].code)) {
+                        held.append(ev[k].code);
+                    }
+                } else {
+                    held.removeOne(ev[k].code);
+                }
+            }
+        }
+        measure(RTLatency::monotonicNs() - deadline);
+        i += n;
+    }
+
+    // an interrupted macro must not leave keys pressed
+    if (!ok) {
+        for (quint16 code : std::as_const(held)) {
+            struct input_event up[2] = {};
+            up[0].type = EV_KEY;
+            up[0].code = code;
+            up[1].type = EV_SYN;
+            up[1].code = SYN_REPORT;
+            if (::write(m_fd, up, sizeof(up)) < 0) {
+                m_failures.fetchAndAddRelaxed(1);
+            }
+        }
+    }
+
+    m_plays.fetchAndAddRelaxed(1);
+    m_playing.storeRelaxed(0);
+    if (m_metricsLog) {
+        const TStatistics s = statistics();
+        qInfo("[MACRO] %lld events in %.3f ms, error mean %.1f us, p99 %.0f us, max %.1f us", //
+              (long long) macro.count(),
+              (RTLatency::monotonicNs() - start) / 1e6,
+              s.meanUs,
+              s.p99Us,
+              s.maxUs);
+    }
+    return ok;
+#else
+    Q_UNUSED(macro);
+    return false;
+#endif
+}
+
+RTMacroPlayer::TStatistics RTMacroPlayer::statistics() const
+{
+    TStatistics stats = {};
+    stats.plays = m_plays.loadRelaxed();
+    stats.events = m_errors.events();
+    stats.ignored = m_ignored.loadRelaxed();
+    stats.failures = m_failures.loadRelaxed();
+    stats.realtime = (m_realtime.loadRelaxed() != 0);
+    stats.meanUs = m_errors.meanUs();
+    stats.maxUs = m_errors.maxUs();
+    stats.p50Us = m_errors.percentileUs(50);
+    stats.p99Us = m_errors.percentileUs(99);
+    return stats;
+}
+
+inline void RTMacroPlayer::measure(qint64 ns)
+{
+    m_errors.add(ns);
+}
@@ -0,0 +1,183 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtlatency.h"
+#include <QAtomicInteger>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QtCore/QtGlobal>
+
+class QSettings;
+
+/**
+ * @brief The RTMacroPlayer thread replays host macros through a virtual
+ * keyboard (Linux uinput) with microsecond timing, beyond the 480
+ * keystrokes and millisecond periods of the device macros. Macros are
+ * compiled once into flat event arrays with absolute offsets. The thread
+ * runs SCHED_FIFO, optionally pinned to one CPU, sleeps on a timerfd
+ * until SpinUs before an event and spins for the rest. A Quick launch
+ * button of the mouse triggers the macro bound to its button index,
+ * trigger() runs on the HID input thread and only writes to a pipe.
+ */
+class RTMacroPlayer : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum {
+        MacroSlots = 32,      // TYON_PROFILE_BUTTON_NUM
+        ErrorBuckets = 256,   // 1 us each, the last one collects the rest
+        DefaultSpinUs = 100,  // busy wait before each event
+        DefaultPriority = 50, // SCHED_FIFO priority
+    };
+
+    /**
+     * @brief One input event at an offset from the macro start
+     */
+    typedef struct
+    {
+        qint64 atNs;  // offset from the start of the macro
+        quint16 type; // EV_KEY or EV_SYN
+        quint16 code; // key code
+        qint32 value; // 1 press, 0 release
+    } TMacroEvent;
+
+    /**
+     * @brief A compiled macro, events in time order
+     */
+    typedef QList<TMacroEvent> TMacro;
+
+    /**
+     * @brief Player configuration
+     */
+    typedef struct
+    {
+        QString files[MacroSlots]; // macro file per button index, empty = none
+        int cpu;                   // CPU to pin the thread to, -1 = any
+        int priority;              // SCHED_FIFO priority 1-99
+        int spinUs;                // busy wait before each event
+    } TConfig;
+
+    /**
+     * @brief Timing error of the written events against their deadline
+     */
+    typedef struct
+    {
+        quint64 plays;    // macros played
+        quint64 events;   // event groups written
+        quint64 ignored;  // triggers while a macro was playing
+        quint64 failures; // failed writes
+        double meanUs;    // mean error
+        double p50Us;     // median error, 1 us resolution
+        double p99Us;     // 99th percentile, 1 us resolution
+        double maxUs;     // largest error
+        bool realtime;    // SCHED_FIFO granted
+    } TStatistics;
+
+    /**
+     * @brief Return the defaults: no macros, no pinning, priority 50
+     * @return TConfig structure
+     */
+    static TConfig defaultConfig();
+
+    /**
+     * @brief Read the [macros] group of the settings. button<N> gives the
+     * macro file of the Quick launch button with index N.
+     * @param settings Application settings
+     * @param config Receives the configuration
+     * @return True if the macros are enabled
+     */
+    static bool loadConfig(QSettings *settings, TConfig *config);
+
+    /**
+     * @brief Compile a macro. One step per line: press <key>,
+     * release <key>, tap <key> or wait <n>us|ms|s; '#' starts a comment.
+     * Keys are evdev names (KEY_A) or numbers.
+     * @param text Macro source
+     * @param macro Receives the event array
+     * @param error Receives the line and reason on failure
+     * @return True on success
+     */
+    static bool compile(const QString &text, TMacro *macro, QString *error);
+
+    explicit RTMacroPlayer(QObject *parent = nullptr);
+
+    /**
+     * @brief Stop the thread and remove the virtual keyboard
+     */
+    ~RTMacroPlayer();
+
+    /**
+     * @brief Compile the macros, create the virtual keyboard and start
+     * the player thread
+     * @param config Macro files and thread setup
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(const TConfig &config, QString *error);
+
+    /**
+     * @brief Start with already compiled macros
+     * @param macros Macro per button index, empty = none
+     * @param config Thread setup, the files are ignored
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(const QList<TMacro> &macros, const TConfig &config, QString *error);
+
+    /**
+     * @brief Stop the thread and remove the virtual keyboard
+     */
+    void close();
+
+    /**
+     * @brief Play the macro of a button, returns at once. Safe to call on
+     * the HID input thread.
+     * @param slot Button index
+     * @return True if a macro is bound to the button
+     */
+    bool trigger(int slot);
+
+    /**
+     * @brief Return true while a macro plays
+     */
+    inline bool isPlaying() const { return m_playing.loadRelaxed() != 0; }
+
+    /**
+     * @brief Return the timing statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+protected:
+    void run() override;
+
+private:
+    QMutex m_mutex;
+    QList<TMacro> m_macros;
+    TConfig m_config;
+    int m_fd;
+    int m_timer;
+    int m_wake[2];
+    bool m_metricsLog;
+    QAtomicInteger<int> m_playing;
+    QAtomicInteger<int> m_realtime;
+    QAtomicInteger<quint64> m_plays;
+    QAtomicInteger<quint64> m_ignored;
+    QAtomicInteger<quint64> m_failures;
+    RTLatencyHistogram<ErrorBuckets, 1> m_errors;
+
+private:
+    inline void closeDevice();
+    inline void setupThread();
+    inline bool play(const TMacro &macro);
+    inline bool waitUntil(qint64 deadline);
+    inline void measure(qint64 ns);
+};
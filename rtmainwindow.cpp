@@ -9,8 +9,10 @@
 #include "rtcalibratetcudialog.h"
 #include "rtcalibratexcdialog.h"
 #include "rtcolordialog.h"
+#include "rtpollratedialog.h"
 #include "rtprogress.h"
 #include "rtshortcutdialog.h"
+#include "rtstartupmetrics.h"
 #include "rttablemodel.h"
 #include "rttypedefs.h"
 #include "ui_rtmainwindow.h"
@@ -24,6 +26,7 @@
 #include <QFile>
 #include <QFileDialog>
 #include <QGroupBox>
+#include <QInputMethod>
 #include <QList>
 #include <QMenu>
 #include <QMessageBox>
@@ -52,9 +55,25 @@ RTMainWindow::RTMainWindow(QWidget *parent)
     , m_buttons()
     , m_settings(nullptr)
     , m_rtpfFileName(QStringLiteral("Tyon-Profiles.rtpf"))
+    , m_profileRules()
+    , m_focusWatcher(nullptr)
+    , m_lookupDeadline(this)
+    , m_syncBar(new QProgressBar(this))
+    , m_interactive(false)
 {
     qRegisterMetaType<TyonLight>();
 
+    // macOS reports a missing device by silence only
+    m_lookupDeadline.setSingleShot(true);
+    m_lookupDeadline.setInterval(3500);
+    connect(&m_lookupDeadline, &QTimer::timeout, this, [this]() { //
+        // a found device reports its sync progress
+        if (!m_device->hasDevice()) {
+            qInfo("[APPWIN] Lookup deadline of %d ms expired", m_lookupDeadline.interval());
+            onLookupFinished(false);
+        }
+    });
+
     // --
     ui->setupUi(this);
 
@@ -74,12 +93,18 @@ RTMainWindow::RTMainWindow(QWidget *parent)
                  QApplication::organizationName(),
                  QApplication::applicationVersion()));
 
+    m_syncBar->setRange(0, 100);
+    m_syncBar->setFixedWidth(120);
+    m_syncBar->setVisible(false);
+    statusBar()->addPermanentWidget(m_syncBar);
+
     disableUserInterface();
     initializeSettings();
     initializeUiElements();
     loadSettings(m_settings);
     connectUiElements();
     connectController();
+    initializeFocusWatcher();
 
     // --
     show();
@@ -90,6 +115,10 @@ RTMainWindow::RTMainWindow(QWidget *parent)
 RTMainWindow::~RTMainWindow()
 {
     saveSettings(m_settings);
+    if (m_focusWatcher) {
+        m_focusWatcher->stop();
+        m_focusWatcher->disconnect(this);
+    }
     m_model->disconnect(this);
     m_device->disconnect(this);
     ui->tableView->setModel(nullptr);
@@ -132,6 +161,26 @@ inline void RTMainWindow::initializeSettings()
     m_settings = new QSettings(fpath, QSettings::Format::NativeFormat, this);
 }
 
+inline void RTMainWindow::initializeFocusWatcher()
+{
+    m_profileRules.load(m_settings);
+    if (m_profileRules.isEmpty()) {
+        return;
+    }
+
+    m_focusWatcher = RTFocusWatcher::create(this);
+    if (!m_focusWatcher) {
+        qWarning("[APPWIN] Automatic profile switching not supported on this system.");
+        return;
+    }
+
+    connect(m_focusWatcher, &RTFocusWatcher::focusChanged, this, &RTMainWindow::onFocusChanged);
+    connect(m_focusWatcher, &RTFocusWatcher::errorOccured, this, [](int error, const QString &message) { //
+        qWarning("[APPWIN] Focus watcher error 0x%08x: %s", error, qPrintable(message));
+    });
+    m_focusWatcher->start();
+}
+
 inline void RTMainWindow::loadSettings(QSettings *settings)
 {
     if (!settings)
@@ -154,6 +203,37 @@ inline void RTMainWindow::loadSettings(QSettings *settings)
     }
 
     m_settings->endGroup();
+
+    // statistic written as TCU median: mean, median or mode
+    const QString metric = m_settings->value("device/tcuMetric", "mean").toString();
+    m_device->setTcuMetric(RTSensorStats::metricFromName(metric));
+
+    // single report writes without the status check before (opt-in)
+    m_device->setFastWrites(m_settings->value("device/fastWrites", false).toBool());
+
+    // X-Celerator as virtual gamepad axis
+    RTXCJoystick::TConfig joystick;
+    if (RTXCJoystick::loadConfig(m_settings, &joystick)) {
+        m_device->setXcJoystick(true, joystick);
+    }
+
+    // keyboard triggered Easyshift and EasyAim
+    RTHotkeyListener::TConfig hotkeys;
+    if (RTHotkeyListener::loadConfig(m_settings, &hotkeys)) {
+        m_device->setHotkeys(true, hotkeys);
+    }
+
+    // host macros on Quick launch buttons
+    RTMacroPlayer::TConfig macros;
+    if (RTMacroPlayer::loadConfig(m_settings, &macros)) {
+        m_device->setMacros(true, macros);
+    }
+
+    // host driven TalkFX lights
+    RTTalkFxEngine::TConfig talkFx;
+    if (RTTalkFxEngine::loadConfig(m_settings, &talkFx)) {
+        m_device->setTalkFx(true, talkFx);
+    }
 }
 
 inline void RTMainWindow::saveSettings(QSettings *settings)
@@ -385,9 +465,31 @@ inline void RTMainWindow::initializeUiElements()
 inline void RTMainWindow::connectController()
 {
     Qt::ConnectionType ct = Qt::QueuedConnection;
+
+    // shortcut translation follows the keyboard layout of the input method
+    QInputMethod *im = QGuiApplication::inputMethod();
+    m_device->setKeyboardLocale(im->locale());
+    connect(im, &QInputMethod::localeChanged, this, [this, im]() { //
+        m_device->setKeyboardLocale(im->locale());
+    });
+
     connect(m_device, &RTController::deviceWorkerStarted, this, &RTMainWindow::onDeviceWorkerStarted, ct);
     connect(m_device, &RTController::deviceWorkerFinished, this, &RTMainWindow::onDeviceWorkerFinished, ct);
     connect(m_device, &RTController::lookupStarted, this, &RTMainWindow::onLookupStarted, ct);
+    connect(
+        m_device,
+        &RTController::resetFinished,
+        this,
+        [this](bool ok) {
+            // a successful reset continues with a new lookup
+            if (!ok) {
+                enableUserInterface();
+            }
+        },
+        ct);
+    connect(m_device, &RTController::lookupFinished, this, &RTMainWindow::onLookupFinished, ct);
+    connect(m_device, &RTController::syncProgress, this, &RTMainWindow::onSyncProgress, ct);
+    connect(m_device, &RTController::profileSynced, this, &RTMainWindow::onProfileSynced, ct);
     connect(m_device, &RTController::deviceFound, this, &RTMainWindow::onDeviceFound, ct);
     connect(m_device, &RTController::deviceRemoved, this, &RTMainWindow::onDeviceRemoved, ct);
     connect(m_device, &RTController::deviceError, this, &RTMainWindow::onDeviceError, ct);
@@ -505,6 +607,12 @@ inline void RTMainWindow::connectUiElements()
     connect(ui->rbPollRate1000, &QRadioButton::clicked, this, [this](bool) { //
         m_device->setTalkFxPollRate(ROCCAT_POLLING_RATE_1000);
     });
+    connect(ui->pbPollRateMeasure, &QPushButton::clicked, this, [this](bool) { //
+        if (!checkDeviceAvailable()) {
+            return;
+        }
+        doMeasurePollRate();
+    });
 
     connect(ui->cbxDpiSlot1, &QCheckBox::clicked, this, [this](bool checked) { //
         ui->edDpiSlot1->setEnabled(checked);
@@ -681,7 +789,7 @@ inline bool RTMainWindow::doSelectColor(TyonLightType target, TyonLight &color)
         d.setOption(QColorDialog::ColorDialogOption::DontUseNativeDialog);
         d.setTabletTracking(this->hasTabletTracking());
         if (d.exec() == QColorDialog::Accepted) {
-            color = m_device->toDeviceColor(target, d.selectedColor());
+            color = m_device->toDeviceColor(target, d.selectedColor().rgb());
             return true;
         }
     } else {
@@ -768,6 +876,29 @@ inline void RTMainWindow::doCalibrateTcu()
     d->raise();
 }
 
+inline void RTMainWindow::doMeasurePollRate()
+{
+    int hz = 0;
+    if (ui->rbPollRate125->isChecked()) {
+        hz = 125;
+    } else if (ui->rbPollRate250->isChecked()) {
+        hz = 250;
+    } else if (ui->rbPollRate500->isChecked()) {
+        hz = 500;
+    } else if (ui->rbPollRate1000->isChecked()) {
+        hz = 1000;
+    }
+
+    // dialog destroying on close automatically
+    RTPollRateDialog *d = new RTPollRateDialog(hz, this);
+    connect(d, &RTPollRateDialog::finished, this, [d](int) { //
+        d->deleteLater();
+    });
+
+    d->show();
+    d->raise();
+}
+
 inline QAction *RTMainWindow::linkAction(QAction *action, TyonButtonType function)
 {
     connect(action, &QAction::triggered, this, [this, action, function](bool) { //
@@ -838,25 +969,66 @@ void RTMainWindow::onLookupStarted()
 {
     RTProgress::present(tr("Please wait, searching ROCCAT Tyon..."), this);
 
-    // if device not found bring up UI
-    QTimer::singleShot(3500, this, [this]() {
-        bool found;
-        RTProgress::dismiss();
-        enableUserInterface();
-        // force profile 0
-        if (!m_device->hasDevice()) {
-            onProfileChanged(m_device->profile(0, found));
-            onProfileIndex(0);
-        }
-    });
+    // Linux retries the lookup periodically, keep the first deadline
+    if (!m_lookupDeadline.isActive()) {
+        m_lookupDeadline.start();
+    }
+}
+
+void RTMainWindow::onLookupFinished(bool found)
+{
+    m_lookupDeadline.stop();
+    m_syncBar->setVisible(false);
+    RTProgress::dismiss();
+    enableUserInterface();
+
+    // if device not found force profile 0
+    if (!found) {
+        bool exists;
+        onProfileChanged(m_device->profile(0, exists));
+        onProfileIndex(0);
+    }
+}
+
+void RTMainWindow::onSyncProgress(int done, int total)
+{
+    const int percent = (total > 0 ? done * 100 / total : 100);
+
+    if (done == 0) {
+        m_interactive = false;
+        disableUserInterface();
+        RTProgress::present(tr("Reading ROCCAT Tyon..."), this);
+    }
+
+    // the remaining profiles are read while the UI is interactive
+    m_syncBar->setValue(percent);
+    if (!m_interactive) {
+        RTProgress::setProgress(percent);
+    }
+}
+
+void RTMainWindow::onProfileSynced(quint8 pix)
+{
+    if (m_interactive || pix != m_device->activeProfileIndex()) {
+        return;
+    }
 
-    QThread::yieldCurrentThread();
+    // save and reset wait for all profiles, see onDeviceFound()
+    m_interactive = true;
+    m_lookupDeadline.stop();
+    RTProgress::dismiss();
+    ui->pnlLeft->setEnabled(true);
+    ui->tabWidget->setEnabled(true);
+    m_syncBar->setVisible(true);
+    RTStartupMetrics::mark("first interactive");
 }
 
 void RTMainWindow::onDeviceFound()
 {
+    m_syncBar->setVisible(false);
     RTProgress::dismiss();
     enableUserInterface();
+    RTStartupMetrics::mark("fully synced");
 }
 
 void RTMainWindow::onDeviceRemoved()
@@ -905,6 +1077,17 @@ void RTMainWindow::onDeviceInfo(const TyonInfo &info)
                  QString::number((qreal) (info.dfu_version * 0.01), 'f', 2)));
 }
 
+void RTMainWindow::onFocusChanged(qint64 pid, const QString &program, qint64 timestamp)
+{
+    const int pix = m_profileRules.profileOf(program);
+    if (pix < 0 || !m_device->hasDevice() || pix == m_device->activeProfileIndex()) {
+        return;
+    }
+
+    qInfo("[APPWIN] Focus pid=%lld %s -> profile %d", pid, qPrintable(program), pix + 1);
+    m_device->activateProfile(pix, timestamp);
+}
+
 void RTMainWindow::onProfileIndex(const quint8 pix)
 {
     ui->tableView->setCurrentIndex(m_model->index(pix));
@@ -1059,7 +1242,7 @@ inline void RTMainWindow::loadSettings(const TyonProfileSettings *s)
     ui->cbxLightBottom->setChecked(s->lights_enabled & TYON_PROFILE_SETTINGS_LIGHTS_ENABLED_BIT_BOTTOM);
 
     for (qint8 i = 0; i < TYON_LIGHTS_NUM; i++) {
-        QColor color = m_device->toScreenColor(s->lights[i], ui->rbLightCustomColor->isChecked());
+        const QColor color = QColor::fromRgb(m_device->toScreenColor(s->lights[i], ui->rbLightCustomColor->isChecked()));
         switch (i) {
             case 0: {
                 ui->pbLightColorWheel->setStyleSheet(        //
@@ -1081,6 +1264,38 @@ inline void RTMainWindow::loadSettings(const TyonProfileSettings *s)
     }
 }
 
+inline void RTMainWindow::setupButton(const RoccatButton &rb, QPushButton *button)
+{
+    QKeySequence ks;
+
+    // assign ROCCAT button type to push button
+    button->setProperty("type", QVariant::fromValue(rb.type));
+    button->setProperty("modifier", QVariant::fromValue(rb.modifier));
+    button->setProperty("hiduid", QVariant::fromValue(rb.key));
+    button->setText(m_device->buttonTypes().value(rb.type));
+
+    // assign shortcut type
+    switch (rb.type) {
+        case TYON_BUTTON_TYPE_SHORTCUT: {
+            ks = QKeySequence(m_device->toKeyCombination(rb));
+            if (!ks.isEmpty()) {
+                button->setProperty("shortcut", QVariant::fromValue(ks));
+#ifndef Q_OS_MACOS
+                button->setText(ks.toString());
+#else
+                if (ks[0].keyboardModifiers().testFlag(Qt::MetaModifier)) {
+                    QString s = ks.toString().replace("Meta", "Cmd");
+                    button->setText(s);
+                } else {
+                    button->setText(ks.toString());
+                }
+#endif
+            }
+            break;
+        }
+    }
+}
+
 inline void RTMainWindow::loadButtons(const TyonProfileButtons *b)
 {
     /* physical buttons and with EasyShift combined. 32 buttons (16x2) */
@@ -1101,7 +1316,7 @@ inline void RTMainWindow::loadButtons(const TyonProfileButtons *b)
     QPushButton *pb = nullptr;
     for (quint8 index = idxStart; index < idxCount; index++) {
         if ((pb = toPushButton(index)) != nullptr) {
-            m_device->setupButton(b->buttons[index], pb);
+            setupButton(b->buttons[index], pb);
         }
     }
 }
@@ -7,15 +7,19 @@
 // ********************************************************************
 #pragma once
 #include "rtcontroller.h"
+#include "rtfocuswatcher.h"
+#include "rtprofilerules.h"
 #include "rttablemodel.h"
 #include <QAction>
 #include <QActionGroup>
 #include <QMainWindow>
 #include <QMap>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QSettings>
 #include <QSlider>
 #include <QSpinBox>
+#include <QTimer>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -33,6 +37,9 @@ public:
 
 private slots:
     void onLookupStarted();
+    void onLookupFinished(bool found);
+    void onSyncProgress(int done, int total);
+    void onProfileSynced(quint8 pix);
     void onDeviceFound();
     void onDeviceRemoved();
     void onDeviceError(uint error, const QString &message);
@@ -43,6 +50,7 @@ private slots:
     void onTalkFxChanged(const TyonTalk &talkFx);
     void onDeviceWorkerStarted();
     void onDeviceWorkerFinished();
+    void onFocusChanged(qint64 pid, const QString &program, qint64 timestamp);
 
 private:
     Ui::RTMainWindow *ui;
@@ -60,10 +68,21 @@ private:
     QSettings *m_settings;
     /* last export file name */
     QString m_rtpfFileName;
+    /* Program to profile rules */
+    RTProfileRules m_profileRules;
+    /* Focused window watcher, null if no rules */
+    RTFocusWatcher *m_focusWatcher;
+    /* Brings up the UI if a lookup does not finish */
+    QTimer m_lookupDeadline;
+    /* Progress of the profiles read after the UI is interactive */
+    QProgressBar *m_syncBar;
+    /* Active profile arrived, the UI is interactive */
+    bool m_interactive;
 
 private:
     inline void initializeUiElements();
     inline void initializeSettings();
+    inline void initializeFocusWatcher();
     inline void connectController();
     inline void connectUiElements();
     inline bool checkDeviceAvailable();
@@ -76,8 +95,10 @@ private:
     inline QAction *linkAction(QAction *action, TyonButtonType function);
     inline void loadSettings(const TyonProfileSettings *settings);
     inline void loadButtons(const TyonProfileButtons *buttons);
+    inline void setupButton(const RoccatButton &rb, QPushButton *button);
     inline bool doSelectColor(TyonLightType target, TyonLight &color);
     inline bool doSelectFile(QString &file, bool isOpen = true);
     inline void doCalibrateXCelerator();
     inline void doCalibrateTcu();
+    inline void doMeasurePollRate();
 };
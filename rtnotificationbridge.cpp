@@ -0,0 +1,330 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtnotificationbridge.h"
+#include "rtcontroller.h"
+#include <QDBusArgument>
+#include <QDBusConnectionInterface>
+#include <QDBusError>
+#include <QDBusVirtualObject>
+#include <QSettings>
+
+#define RT_NOTIFY_CONNECTION "rt-notification-monitor"
+#define RT_NOTIFY_RULE "type='method_call',interface='org.freedesktop.Notifications',member='Notify'"
+
+/**
+ * @brief Receives the Notify calls seen by the monitor connection. A
+ * monitor must not send anything, every message counts as handled so
+ * Qt does not answer it.
+ */
+class RTNotificationMonitor : public QDBusVirtualObject
+{
+public:
+    explicit RTNotificationMonitor(RTNotificationBridge *bridge, const RTNotificationBridge::TConfig &config)
+        : QDBusVirtualObject(bridge)
+        , m_bridge(bridge)
+        , m_config(config)
+    {}
+
+    QString introspect(const QString &) const override { return QString(); }
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &) override
+    {
+        if (message.type() != QDBusMessage::MethodCallMessage || message.member() != QStringLiteral("Notify")) {
+            return true;
+        }
+
+        // app_name, replaces_id, app_icon, summary, body, actions, hints, expire_timeout
+        int urgency = RTNotificationBridge::UrgencyNormal;
+        const QList<QVariant> args = message.arguments();
+        if (args.size() >= 7) {
+            const QVariantMap hints = qdbus_cast<QVariantMap>(args.at(6));
+            urgency = qBound<int>(RTNotificationBridge::UrgencyLow, //
+                                  hints.value(QStringLiteral("urgency"), urgency).toInt(),
+                                  RTNotificationBridge::UrgencyCritical);
+        }
+
+        // may run on the D-Bus thread
+        const quint32 color = m_config.colors[urgency];
+        RTNotificationBridge *bridge = m_bridge;
+        QMetaObject::invokeMethod(bridge, [bridge, color, urgency]() { bridge->post(color, urgency); }, Qt::QueuedConnection);
+        return true;
+    }
+
+private:
+    RTNotificationBridge *m_bridge;
+    const RTNotificationBridge::TConfig m_config;
+};
+
+RTNotificationBridge::TConfig RTNotificationBridge::defaultConfig()
+{
+    TConfig config = {};
+    config.notifications = true;
+    config.merge = MergeHighest;
+    config.windowMs = 250;
+    config.intervalMs = 1500;
+    config.flashMs = 500;
+    config.queueSize = 4;
+    config.colors[UrgencyLow] = 0x0000ff;
+    config.colors[UrgencyNormal] = 0xffffff;
+    config.colors[UrgencyCritical] = 0xff0000;
+    config.signalColor = 0xffa000;
+    return config;
+}
+
+bool RTNotificationBridge::loadConfig(QSettings *settings, TConfig *config)
+{
+    static const char *const colorNames[UrgencyCount] = {
+        "lowColor",
+        "normalColor",
+        "criticalColor",
+    };
+
+    *config = defaultConfig();
+    settings->beginGroup("notifications");
+    const bool enabled = settings->value("enabled", false).toBool();
+    config->notifications = settings->value("notify", true).toBool();
+    config->signalNames = settings->value("signals").toStringList();
+    const QString merge = settings->value("merge", "highest").toString();
+    if (merge == QStringLiteral("latest")) {
+        config->merge = MergeLatest;
+    } else if (merge == QStringLiteral("first")) {
+        config->merge = MergeFirst;
+    } else {
+        config->merge = MergeHighest;
+    }
+    config->windowMs = qBound(0, settings->value("window", config->windowMs).toInt(), 5000);
+    config->flashMs = qBound(100, settings->value("flash", config->flashMs).toInt(), 5000);
+    config->intervalMs = qBound(config->flashMs, settings->value("interval", config->intervalMs).toInt(), 60000);
+    config->queueSize = qBound(1, settings->value("queue", config->queueSize).toInt(), 64);
+    for (int u = 0; u < UrgencyCount; u++) {
+        config->colors[u] = RTTalkFxEngine::colorValue(settings->value(colorNames[u]).toString(), config->colors[u]);
+    }
+    config->signalColor = RTTalkFxEngine::colorValue(settings->value("signalColor").toString(), config->signalColor);
+    settings->endGroup();
+    return enabled;
+}
+
+RTNotificationBridge::RTNotificationBridge(RTController *controller, QObject *parent)
+    : QObject(parent)
+    , m_controller(controller)
+    , m_config(defaultConfig())
+    , m_monitor(QString())
+    , m_monitorObject(nullptr)
+    , m_connected()
+    , m_queue()
+    , m_timer()
+    , m_clock()
+    , m_nextAt(0)
+    , m_flashing(false)
+    , m_metricsLog(qEnvironmentVariableIntValue("RT_NOTIFY_METRICS") > 0)
+    , m_stats()
+{
+    m_timer.setSingleShot(true);
+    m_clock.start();
+    connect(&m_timer, &QTimer::timeout, this, &RTNotificationBridge::onTimer);
+}
+
+RTNotificationBridge::~RTNotificationBridge()
+{
+    close();
+}
+
+bool RTNotificationBridge::open(const TConfig &config, QString *error)
+{
+    close();
+    m_config = config;
+
+    if (!m_controller->isTalkFxRunning()) {
+        *error = QStringLiteral("The notification flashes need the TalkFX engine.");
+        return false;
+    }
+    if (m_config.notifications && !openMonitor(error)) {
+        return false;
+    }
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    for (const QString &name : std::as_const(m_config.signalNames)) {
+        const qsizetype dot = name.lastIndexOf('.');
+        if (dot <= 0) {
+            qWarning("[NOTIFY] Invalid signal name %s, expected interface.member", qPrintable(name));
+            continue;
+        }
+        if (!bus.connect(QString(), QString(), name.left(dot), name.mid(dot + 1), this, SLOT(onCustomSignal(QDBusMessage)))) {
+            qWarning("[NOTIFY] Unable to watch signal %s", qPrintable(name));
+            continue;
+        }
+        m_connected.append(name);
+    }
+
+    qInfo("[NOTIFY] Watching %s and %lld signals", //
+          m_config.notifications ? "notifications" : "no notifications",
+          (long long) m_connected.count());
+    return true;
+}
+
+inline bool RTNotificationBridge::openMonitor(QString *error)
+{
+    // a monitor connection receives only, keep it apart from the service
+    m_monitor = QDBusConnection::connectToBus(QDBusConnection::SessionBus, QStringLiteral(RT_NOTIFY_CONNECTION));
+    if (!m_monitor.isConnected()) {
+        *error = m_monitor.lastError().message();
+        return false;
+    }
+    m_monitorObject = new RTNotificationMonitor(this, m_config);
+    m_monitor.registerVirtualObject(QStringLiteral("/"), m_monitorObject, QDBusConnection::SubPath);
+
+    QDBusMessage call = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.DBus"),
+                                                       QStringLiteral("/org/freedesktop/DBus"),
+                                                       QStringLiteral("org.freedesktop.DBus.Monitoring"),
+                                                       QStringLiteral("BecomeMonitor"));
+    call << QStringList{QStringLiteral(RT_NOTIFY_RULE)} << 0u;
+    const QDBusMessage reply = m_monitor.call(call);
+    if (reply.type() != QDBusMessage::ErrorMessage) {
+        return true;
+    }
+
+    // buses without the monitoring interface still allow eavesdropping
+    const QDBusMessage match = m_monitor.interface()->call(QStringLiteral("AddMatch"), QStringLiteral("eavesdrop=true," RT_NOTIFY_RULE));
+    if (match.type() != QDBusMessage::ErrorMessage) {
+        return true;
+    }
+
+    *error = QStringLiteral("Unable to watch notifications: %1").arg(reply.errorMessage());
+    closeMonitor();
+    return false;
+}
+
+void RTNotificationBridge::close()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    for (const QString &name : std::as_const(m_connected)) {
+        const qsizetype dot = name.lastIndexOf('.');
+        bus.disconnect(QString(), QString(), name.left(dot), name.mid(dot + 1), this, SLOT(onCustomSignal(QDBusMessage)));
+    }
+    m_connected.clear();
+
+    closeMonitor();
+
+    m_timer.stop();
+    m_queue.clear();
+    if (m_flashing) {
+        m_controller->setTalkFxEvent(false);
+        m_flashing = false;
+    }
+}
+
+inline void RTNotificationBridge::closeMonitor()
+{
+    if (m_monitor.isConnected()) {
+        m_monitor.unregisterObject(QStringLiteral("/"), QDBusConnection::UnregisterTree);
+        QDBusConnection::disconnectFromBus(QStringLiteral(RT_NOTIFY_CONNECTION));
+        m_monitor = QDBusConnection(QString());
+    }
+    delete m_monitorObject;
+    m_monitorObject = nullptr;
+}
+
+void RTNotificationBridge::onCustomSignal(const QDBusMessage &message)
+{
+    // a uint argument gives the color, e.g. busctl emit ... u 0xff0000
+    quint32 color = m_config.signalColor;
+    const QList<QVariant> args = message.arguments();
+    if (!args.isEmpty() && args.first().metaType().id() == QMetaType::UInt) {
+        color = args.first().toUInt() & 0xffffff;
+    }
+    post(color, UrgencyNormal);
+}
+
+void RTNotificationBridge::post(quint32 color, int urgency)
+{
+    const qint64 now = m_clock.elapsed();
+    m_stats.received++;
+
+    // a pending flash of the same burst takes the notification
+    if (!m_queue.isEmpty() && now - m_queue.last().lastAt < m_config.windowMs) {
+        TFlash &f = m_queue.last();
+        if (m_config.merge == MergeLatest || (m_config.merge == MergeHighest && urgency > f.urgency)) {
+            f.color = color;
+            f.urgency = urgency;
+        }
+        f.lastAt = now;
+        m_stats.merged++;
+        schedule();
+        return;
+    }
+
+    if (m_queue.count() >= m_config.queueSize) {
+        // drop the oldest of the least urgent, or the new one if it is below all
+        qsizetype victim = 0;
+        for (qsizetype i = 1; i < m_queue.count(); i++) {
+            if (m_queue.at(i).urgency < m_queue.at(victim).urgency) {
+                victim = i;
+            }
+        }
+        m_stats.dropped++;
+        if (urgency <= m_queue.at(victim).urgency) {
+            return;
+        }
+        m_queue.removeAt(victim);
+    }
+
+    m_queue.append({color, urgency, now, now});
+    schedule();
+}
+
+inline void RTNotificationBridge::schedule()
+{
+    if (m_flashing || m_queue.isEmpty()) {
+        return;
+    }
+
+    // a burst ends after the quiet window, but waits no longer than one interval
+    const TFlash &f = m_queue.first();
+    const qint64 burstEnd = qMin(f.lastAt + m_config.windowMs, f.firstAt + m_config.intervalMs);
+    const qint64 readyAt = qMax(burstEnd, m_nextAt);
+    m_timer.start((int) qMax<qint64>(0, readyAt - m_clock.elapsed()));
+}
+
+void RTNotificationBridge::onTimer()
+{
+    const qint64 now = m_clock.elapsed();
+
+    if (m_flashing) {
+        m_controller->setTalkFxEvent(false);
+        m_flashing = false;
+        schedule();
+        return;
+    }
+    if (m_queue.isEmpty()) {
+        return;
+    }
+
+    const TFlash &f = m_queue.first();
+    if (now < m_nextAt || (now - f.lastAt < m_config.windowMs && now - f.firstAt < m_config.intervalMs)) {
+        // merged into since the timer started
+        schedule();
+        return;
+    }
+
+    const TFlash flash = m_queue.takeFirst();
+    m_controller->setTalkFxEventColor(flash.color);
+    m_controller->setTalkFxEvent(true);
+    m_flashing = true;
+    m_nextAt = now + m_config.intervalMs;
+    m_stats.flashes++;
+    m_timer.start(m_config.flashMs);
+
+    if (m_metricsLog) {
+        qInfo("[NOTIFY] Flash #%06x, %llu received, %llu merged, %llu dropped, %llu flashes", //
+              flash.color,
+              (unsigned long long) m_stats.received,
+              (unsigned long long) m_stats.merged,
+              (unsigned long long) m_stats.dropped,
+              (unsigned long long) m_stats.flashes);
+    }
+}
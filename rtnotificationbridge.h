@@ -0,0 +1,154 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+class QSettings;
+class RTController;
+class RTNotificationMonitor;
+
+/**
+ * @brief The RTNotificationBridge class flashes the TalkFX event color for
+ * desktop notifications (org.freedesktop.Notifications.Notify, watched as
+ * a bus monitor) and for configured D-Bus signals. Notifications arriving
+ * within the merge window collapse into one flash, the bounded queue drops
+ * the least urgent flash when full and flashes start at most once per
+ * interval. The flash only sets the event flag of the TalkFX engine, the
+ * engine writes it when the device is free.
+ */
+class RTNotificationBridge : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum TMerge {
+        MergeHighest = 0, // color of the most urgent notification
+        MergeLatest,      // color of the newest notification
+        MergeFirst,       // color of the first notification
+    };
+
+    enum {
+        UrgencyLow = 0, // org.freedesktop.Notifications urgency hint
+        UrgencyNormal,
+        UrgencyCritical,
+        UrgencyCount,
+    };
+
+    /**
+     * @brief Bridge configuration
+     */
+    typedef struct
+    {
+        bool notifications;           // watch desktop notifications
+        QStringList signalNames;      // interface.member of custom signals
+        TMerge merge;                 // color of a merged flash
+        int windowMs;                 // quiet time that ends a burst
+        int intervalMs;               // time between the start of two flashes
+        int flashMs;                  // duration of a flash
+        int queueSize;                // pending flashes at most
+        quint32 colors[UrgencyCount]; // flash color per urgency
+        quint32 signalColor;          // flash color of custom signals
+    } TConfig;
+
+    /**
+     * @brief Bridge statistics
+     */
+    typedef struct
+    {
+        quint64 received; // notifications and signals
+        quint64 merged;   // folded into a pending flash
+        quint64 dropped;  // dropped from the full queue
+        quint64 flashes;  // flashes shown
+    } TStatistics;
+
+    /**
+     * @brief Return the defaults: notifications on, merge the most urgent,
+     * 250 ms window, one flash per 1.5 s of 500 ms, four pending flashes
+     * @return TConfig structure
+     */
+    static TConfig defaultConfig();
+
+    /**
+     * @brief Read the [notifications] group of the settings
+     * @param settings Application settings
+     * @param config Receives the configuration
+     * @return True if the bridge is enabled
+     */
+    static bool loadConfig(QSettings *settings, TConfig *config);
+
+    explicit RTNotificationBridge(RTController *controller, QObject *parent = nullptr);
+
+    /**
+     * @brief Stop watching the bus
+     */
+    ~RTNotificationBridge();
+
+    /**
+     * @brief Watch the session bus for notifications and custom signals.
+     * The TalkFX engine of the controller must be running.
+     * @param config Sources, merge policy, rates and colors
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(const TConfig &config, QString *error);
+
+    /**
+     * @brief Stop watching the bus and end the current flash
+     */
+    void close();
+
+    /**
+     * @brief Queue a flash, merged with a pending one of the same burst
+     * @param color 0xRRGGBB
+     * @param urgency UrgencyLow to UrgencyCritical
+     */
+    void post(quint32 color, int urgency);
+
+    /**
+     * @brief Return the bridge statistics
+     * @return TStatistics structure
+     */
+    inline TStatistics statistics() const { return m_stats; }
+
+private slots:
+    void onCustomSignal(const QDBusMessage &message);
+    void onTimer();
+
+private:
+    typedef struct
+    {
+        quint32 color;
+        int urgency;
+        qint64 firstAt; // ms, first notification of the burst
+        qint64 lastAt;  // ms, newest notification of the burst
+    } TFlash;
+
+    RTController *m_controller;
+    TConfig m_config;
+    QDBusConnection m_monitor;
+    RTNotificationMonitor *m_monitorObject;
+    QStringList m_connected;
+    QList<TFlash> m_queue;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_nextAt;
+    bool m_flashing;
+    bool m_metricsLog;
+    TStatistics m_stats;
+
+private:
+    inline bool openMonitor(QString *error);
+    inline void closeMonitor();
+    inline void schedule();
+};
@@ -0,0 +1,426 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtpollrateanalyzer.h"
+#include "rttypedefs.h"
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// evdev event types and codes, also needed to replay on other systems
+enum {
+    RT_EV_SYN = 0,
+    RT_EV_REL = 2,
+    RT_SYN_REPORT = 0,
+    RT_SYN_DROPPED = 3,
+};
+
+QString RTPollRateAnalyzer::findDevice()
+{
+#ifdef Q_OS_LINUX
+    const QDir dir(QStringLiteral("/dev/input"));
+    const QStringList nodes = dir.entryList({QStringLiteral("event*")}, QDir::System);
+    for (const QString &node : nodes) {
+        const QString path = dir.absoluteFilePath(node);
+        const int fd = ::open(path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        // the Tyon has a keyboard node as well, the mouse one reports REL_X
+        struct input_id id = {};
+        quint8 rel[(REL_CNT + 7) / 8] = {};
+        const bool match = (ioctl(fd, EVIOCGID, &id) >= 0 //
+                            && id.vendor == USB_DEVICE_ID_VENDOR_ROCCAT
+                            && (id.product == USB_DEVICE_ID_ROCCAT_TYON_BLACK || id.product == USB_DEVICE_ID_ROCCAT_TYON_WHITE)
+                            && ioctl(fd, EVIOCGBIT(EV_REL, sizeof(rel)), rel) >= 0 //
+                            && (rel[REL_X / 8] & (1 << (REL_X % 8))));
+        ::close(fd);
+        if (match) {
+            return path;
+        }
+    }
+#endif
+    return QString();
+}
+
+RTPollRateAnalyzer::RTPollRateAnalyzer(QObject *parent)
+    : QThread(parent)
+    , m_mutex()
+    , m_fd(-1)
+    , m_wake{-1, -1}
+    , m_metricsLog(qEnvironmentVariableIntValue("RT_POLLRATE_METRICS") > 0)
+    , m_lastNs(-1)
+    , m_nominalHz(0)
+    , m_reports(0)
+    , m_gaps(0)
+    , m_sumNs(0)
+    , m_minNs(~0ULL)
+    , m_maxNs(0)
+    , m_buckets()
+{
+}
+
+RTPollRateAnalyzer::~RTPollRateAnalyzer()
+{
+    close();
+}
+
+bool RTPollRateAnalyzer::open(const QString &node, QString *error)
+{
+    close();
+
+    QMutexLocker lock(&m_mutex);
+#ifdef Q_OS_LINUX
+    const QString path = (node.isEmpty() ? findDevice() : node);
+    if (path.isEmpty()) {
+        *error = QStringLiteral("No ROCCAT Tyon event node found (needs read access to /dev/input/event*).");
+        return false;
+    }
+    m_fd = ::open(path.toLocal8Bit().constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0) {
+        *error = QStringLiteral("%1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    // a step of the wall clock must not show up as an interval
+    const int clock = CLOCK_MONOTONIC;
+    if (ioctl(m_fd, EVIOCSCLOCKID, &clock) < 0 || pipe2(m_wake, O_CLOEXEC | O_NONBLOCK) < 0) {
+        *error = QStringLiteral("%1: %2").arg(path, QString::fromLocal8Bit(strerror(errno)));
+        closeDevice();
+        return false;
+    }
+
+    m_lastNs = -1;
+    qInfo("[POLLRATE] Reading %s", qPrintable(path));
+    lock.unlock();
+
+    // the kernel stamps the events, a late reader does not change them
+    start(QThread::NormalPriority);
+    return true;
+#else
+    Q_UNUSED(node);
+    *error = QStringLiteral("The polling rate analyzer needs Linux evdev.");
+    return false;
+#endif
+}
+
+void RTPollRateAnalyzer::close()
+{
+    if (isRunning()) {
+        requestInterruption();
+#ifdef Q_OS_LINUX
+        const char c = 0;
+        if (::write(m_wake[1], &c, 1) < 0) {
+            qWarning("[POLLRATE] Wake up failed: %s", strerror(errno));
+        }
+#endif
+        wait();
+    }
+    QMutexLocker lock(&m_mutex);
+    closeDevice();
+}
+
+inline void RTPollRateAnalyzer::closeDevice()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (m_wake[i] >= 0) {
+            ::close(m_wake[i]);
+        }
+    }
+#endif
+    m_fd = -1;
+    m_wake[0] = -1;
+    m_wake[1] = -1;
+}
+
+void RTPollRateAnalyzer::run()
+{
+#ifdef Q_OS_LINUX
+    struct pollfd pfds[2] = {
+        {m_wake[0], POLLIN, 0},
+        {m_fd, POLLIN, 0},
+    };
+
+    struct input_event events[64];
+    while (!isInterruptionRequested()) {
+        if (poll(pfds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qWarning("[POLLRATE] poll: %s", strerror(errno));
+            break;
+        }
+        if (pfds[0].revents) {
+            break;
+        }
+        if (pfds[1].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            qWarning("[POLLRATE] Mouse removed");
+            break;
+        }
+        const ssize_t n = ::read(m_fd, events, sizeof(events));
+        for (ssize_t e = 0; e < n / (ssize_t) sizeof(struct input_event); e++) {
+            const struct input_event &ev = events[e];
+            addEvent(ev.type, ev.code, (qint64) ev.input_event_sec * 1000000000LL + (qint64) ev.input_event_usec * 1000);
+        }
+    }
+#endif
+}
+
+bool RTPollRateAnalyzer::replay(const QString &fileName, QString *error)
+{
+    if (isRunning()) {
+        *error = QStringLiteral("The analyzer reads the mouse.");
+        return false;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        *error = QStringLiteral("%1: %2").arg(fileName, file.errorString());
+        return false;
+    }
+
+    // evemu-record writes comments and N: lines before the events
+    const QByteArray head = file.peek(2);
+    const quint64 reports = m_reports.loadRelaxed();
+    m_lastNs = -1;
+    if (head.startsWith('#') || head.startsWith("N:") || head.startsWith("E:")) {
+        if (!replayText(&file, error)) {
+            return false;
+        }
+    } else if (!replayRaw(&file, error)) {
+        return false;
+    }
+    if (m_reports.loadRelaxed() == reports) {
+        *error = QStringLiteral("%1: no SYN_REPORT events").arg(fileName);
+        return false;
+    }
+    return true;
+}
+
+inline bool RTPollRateAnalyzer::replayText(QFile *file, QString *error)
+{
+    Q_UNUSED(error);
+
+    // E: <sec>.<usec> <type> <code> <value>, type and code in hex
+    char line[256];
+    while (file->readLine(line, sizeof(line)) > 0) {
+        long long sec, usec;
+        unsigned type, code;
+        int value;
+        if (sscanf(line, "E: %lld.%lld %x %x %d", &sec, &usec, &type, &code, &value) != 5) {
+            continue;
+        }
+        addEvent(type, code, sec * 1000000000LL + usec * 1000);
+    }
+    return true;
+}
+
+inline bool RTPollRateAnalyzer::replayRaw(QFile *file, QString *error)
+{
+#ifdef Q_OS_LINUX
+    struct input_event events[64];
+    qint64 n;
+    while ((n = file->read(reinterpret_cast<char *>(events), sizeof(events))) > 0) {
+        if (n % sizeof(struct input_event)) {
+            *error = QStringLiteral("%1: not a stream of %2 byte input events").arg(file->fileName()).arg(sizeof(struct input_event));
+            return false;
+        }
+        for (qint64 e = 0; e < n / (qint64) sizeof(struct input_event); e++) {
+            const struct input_event &ev = events[e];
+            addEvent(ev.type, ev.code, (qint64) ev.input_event_sec * 1000000000LL + (qint64) ev.input_event_usec * 1000);
+        }
+    }
+    return true;
+#else
+    *error = QStringLiteral("%1: raw input events need Linux, use evemu-record").arg(file->fileName());
+    return false;
+#endif
+}
+
+inline void RTPollRateAnalyzer::addEvent(int type, int code, qint64 stampNs)
+{
+    if (type != RT_EV_SYN) {
+        return;
+    }
+    if (code == RT_SYN_REPORT) {
+        addReport(stampNs);
+    } else if (code == RT_SYN_DROPPED) {
+        // the kernel buffer overflowed, the next interval is not real
+        m_lastNs = -1;
+    }
+}
+
+void RTPollRateAnalyzer::addReport(qint64 stampNs)
+{
+    m_reports.fetchAndAddRelaxed(1);
+    const qint64 last = m_lastNs;
+    m_lastNs = stampNs;
+    if (last < 0) {
+        return;
+    }
+
+    const qint64 ns = stampNs - last;
+    if (ns < 0 || ns >= GapUs * 1000LL) {
+        m_gaps.fetchAndAddRelaxed(1);
+        return;
+    }
+    m_sumNs.fetchAndAddRelaxed(ns);
+    if ((quint64) ns < m_minNs.loadRelaxed()) {
+        m_minNs.storeRelaxed(ns);
+    }
+    if ((quint64) ns > m_maxNs.loadRelaxed()) {
+        m_maxNs.storeRelaxed(ns);
+    }
+    m_buckets[ns / 1000].fetchAndAddRelaxed(1);
+
+    if (m_metricsLog) {
+        qInfo("[POLLRATE] interval %.1f us", ns / 1000.0);
+    }
+}
+
+void RTPollRateAnalyzer::reset()
+{
+    m_lastNs = -1;
+    m_reports.storeRelaxed(0);
+    m_gaps.storeRelaxed(0);
+    m_sumNs.storeRelaxed(0);
+    m_minNs.storeRelaxed(~0ULL);
+    m_maxNs.storeRelaxed(0);
+    for (int i = 0; i < Buckets; i++) {
+        m_buckets[i].storeRelaxed(0);
+    }
+}
+
+void RTPollRateAnalyzer::setNominalHz(int hz)
+{
+    m_nominalHz.storeRelaxed(hz == 125 || hz == 250 || hz == 500 || hz == 1000 ? hz : 0);
+}
+
+RTPollRateAnalyzer::TStatistics RTPollRateAnalyzer::statistics() const
+{
+    TStatistics stats = {};
+    stats.reports = m_reports.loadRelaxed();
+    stats.gaps = m_gaps.loadRelaxed();
+    stats.nominalHz = m_nominalHz.loadRelaxed();
+
+    quint64 total = 0;
+    for (int i = 0; i < Buckets; i++) {
+        total += m_buckets[i].loadRelaxed();
+    }
+    const quint64 sumNs = m_sumNs.loadRelaxed();
+    stats.intervals = total;
+    if (total == 0 || sumNs == 0) {
+        return stats;
+    }
+
+    stats.rateHz = total * 1e9 / sumNs;
+    stats.meanUs = sumNs / 1000.0 / total;
+    stats.minUs = m_minNs.loadRelaxed() / 1000.0;
+    stats.maxUs = m_maxNs.loadRelaxed() / 1000.0;
+    stats.p1Us = percentile(total, 10);
+    stats.p50Us = percentile(total, 500);
+    stats.p99Us = percentile(total, 990);
+    stats.p999Us = percentile(total, 999);
+
+    double variance = 0;
+    for (int i = 0; i < Buckets; i++) {
+        const quint32 c = m_buckets[i].loadRelaxed();
+        if (c) {
+            const double d = i + 0.5 - stats.meanUs;
+            variance += c * d * d;
+        }
+    }
+    stats.stddevUs = sqrt(variance / total);
+
+    // slow movement skips reports, the median stays on the polling period
+    if (stats.nominalHz == 0) {
+        static const int rates[] = {125, 250, 500, 1000};
+        for (int hz : rates) {
+            if (stats.nominalHz == 0 || fabs(1e6 / hz - stats.p50Us) < fabs(1e6 / stats.nominalHz - stats.p50Us)) {
+                stats.nominalHz = hz;
+            }
+        }
+    }
+
+    const int period = 1000000 / stats.nominalHz;
+    for (int i = 0; i < Buckets; i++) {
+        const quint32 c = m_buckets[i].loadRelaxed();
+        if (i * 2 < period) {
+            stats.early += c;
+        } else if (i * 2 > period * 3) {
+            stats.late += c;
+        }
+    }
+
+    // a skipped report still arrives on the polling grid, measure the
+    // distance to the nearest multiple of the period
+    QList<quint64> distance(period + 1, 0);
+    for (int i = 0; i < Buckets; i++) {
+        const quint32 c = m_buckets[i].loadRelaxed();
+        if (c) {
+            const int k = qMax((i + period / 2) / period, 1);
+            distance[qAbs(i - k * period)] += c;
+        }
+    }
+    quint64 n = 0;
+    for (int d = 0; d <= period; d++) {
+        const quint64 c = distance[d];
+        if (c == 0) {
+            continue;
+        }
+        if (n * 2 < total && (n + c) * 2 >= total) {
+            stats.jitterP50Us = d;
+        }
+        if (n * 100 < total * 99 && (n + c) * 100 >= total * 99) {
+            stats.jitterP99Us = d;
+        }
+        stats.jitterMaxUs = d;
+        n += c;
+    }
+    return stats;
+}
+
+inline double RTPollRateAnalyzer::percentile(quint64 total, int permille) const
+{
+    quint64 n = 0;
+    for (int i = 0; i < Buckets; i++) {
+        n += m_buckets[i].loadRelaxed();
+        if (n * 1000 >= total * permille) {
+            return i;
+        }
+    }
+    return Buckets - 1;
+}
+
+QList<quint64> RTPollRateAnalyzer::histogram(int firstUs, int binUs, int count) const
+{
+    QList<quint64> bins(count, 0);
+    for (int b = 0; b < count; b++) {
+        const int from = qMax(firstUs + b * binUs, 0);
+        const int to = qMin(firstUs + (b + 1) * binUs, (int) Buckets);
+        for (int i = from; i < to; i++) {
+            bins[b] += m_buckets[i].loadRelaxed();
+        }
+    }
+    return bins;
+}
@@ -0,0 +1,156 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QAtomicInteger>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QtCore/QtGlobal>
+
+class QFile;
+
+/**
+ * @brief The RTPollRateAnalyzer thread reads the mouse event node of the
+ * Tyon (Linux evdev) and measures the interval between two reports from
+ * the kernel time stamps of the SYN_REPORT events. The intervals go into
+ * a fixed histogram of 1 us buckets, nothing is allocated per event. The
+ * achieved report rate, the interval percentiles and the jitter against
+ * the grid of the nominal polling period are derived from the histogram
+ * on request.
+ *
+ * The mouse only reports while it moves, pauses longer than GapUs are
+ * counted as gaps and left out. Recorded streams (evemu-record or a raw
+ * copy of the event node) can be fed through replay() without a mouse.
+ */
+class RTPollRateAnalyzer : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum {
+        Buckets = 16384, // 1 us each, covers two 125 Hz periods
+        GapUs = Buckets, // longer intervals are pauses, not reports
+    };
+
+    /**
+     * @brief Analyzer statistics, times in microseconds
+     */
+    typedef struct
+    {
+        quint64 reports;    // SYN_REPORT events
+        quint64 intervals;  // intervals in the histogram
+        quint64 gaps;       // pauses longer than GapUs
+        quint64 late;       // intervals over 1.5 nominal periods (missed reports)
+        quint64 early;      // intervals under half a nominal period
+        int nominalHz;      // configured or detected polling rate
+        double rateHz;      // intervals per second of movement
+        double meanUs;      // mean interval
+        double stddevUs;    // standard deviation of the interval
+        double minUs;       // shortest interval
+        double maxUs;       // longest interval below GapUs
+        double p1Us;        // 1st percentile of the interval
+        double p50Us;       // median interval
+        double p99Us;       // 99th percentile of the interval
+        double p999Us;      // 99.9th percentile of the interval
+        double jitterP50Us; // median distance from the polling grid
+        double jitterP99Us; // 99th percentile distance from the polling grid
+        double jitterMaxUs; // largest distance from the polling grid
+    } TStatistics;
+
+    /**
+     * @brief Find the mouse event node of the Tyon
+     * @return Path like /dev/input/event5 or an empty string
+     */
+    static QString findDevice();
+
+    explicit RTPollRateAnalyzer(QObject *parent = nullptr);
+
+    /**
+     * @brief Stop the thread and close the event node
+     */
+    ~RTPollRateAnalyzer();
+
+    /**
+     * @brief Open the event node and start the reader thread
+     * @param node Event node, empty to look up the Tyon
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(const QString &node, QString *error);
+
+    /**
+     * @brief Stop the thread and close the event node
+     */
+    void close();
+
+    /**
+     * @brief Feed a recorded event stream. Text files are read in the
+     * evemu-record format, anything else as raw struct input_event.
+     * @param fileName Recorded stream
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool replay(const QString &fileName, QString *error);
+
+    /**
+     * @brief Add the kernel time stamp of one report
+     * @param stampNs Time stamp in nanoseconds
+     */
+    void addReport(qint64 stampNs);
+
+    /**
+     * @brief Clear the histogram and the counters. Not while running.
+     */
+    void reset();
+
+    /**
+     * @brief Set the polling rate the jitter is measured against
+     * @param hz 125, 250, 500 or 1000, 0 picks the one next to the median
+     */
+    void setNominalHz(int hz);
+
+    /**
+     * @brief Return the analyzer statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+    /**
+     * @brief Sum up the histogram into wider bins
+     * @param firstUs Start of the first bin
+     * @param binUs Width of one bin
+     * @param count Number of bins
+     * @return Intervals per bin
+     */
+    QList<quint64> histogram(int firstUs, int binUs, int count) const;
+
+protected:
+    void run() override;
+
+private:
+    QMutex m_mutex;
+    int m_fd;
+    int m_wake[2];
+    bool m_metricsLog;
+    qint64 m_lastNs;
+    QAtomicInteger<int> m_nominalHz;
+    QAtomicInteger<quint64> m_reports;
+    QAtomicInteger<quint64> m_gaps;
+    QAtomicInteger<quint64> m_sumNs;
+    QAtomicInteger<quint64> m_minNs;
+    QAtomicInteger<quint64> m_maxNs;
+    QAtomicInteger<quint32> m_buckets[Buckets];
+
+private:
+    inline void closeDevice();
+    inline void addEvent(int type, int code, qint64 stampNs);
+    inline bool replayText(QFile *file, QString *error);
+    inline bool replayRaw(QFile *file, QString *error);
+    inline double percentile(quint64 total, int permille) const;
+};
@@ -0,0 +1,139 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtpollratedialog.h"
+#include "ui_rtpollratedialog.h"
+#include <QFileDialog>
+
+// histogram bins on each side of the polling period
+#define POLLRATE_SIDE_BINS 20
+
+RTPollRateDialog::RTPollRateDialog(int configuredHz, QWidget *parent)
+    : QDialog(parent)
+    , ui(new Ui::RTPollRateDialog)
+    , m_analyzer()
+    , m_timer()
+    , m_configuredHz(configuredHz)
+{
+    ui->setupUi(this);
+
+    setAttribute(Qt::WA_DeleteOnClose, false);
+    setWindowFlags(Qt::Tool);
+
+    ui->txResult->clear();
+    ui->pbStart->setDefault(true);
+    ui->pbStart->setFocus();
+
+    m_timer.setInterval(250);
+    connect(&m_timer, &QTimer::timeout, this, &RTPollRateDialog::onUpdate);
+
+    connect(ui->pbStart, &QPushButton::clicked, this, [this]() { //
+        if (m_analyzer.isRunning()) {
+            stop();
+        } else {
+            start();
+        }
+    });
+
+    connect(ui->pbReplay, &QPushButton::clicked, this, [this]() { //
+        replay();
+    });
+
+    connect(ui->pbClose, &QPushButton::clicked, this, [this]() { //
+        stop();
+        accept();
+    });
+}
+
+RTPollRateDialog::~RTPollRateDialog()
+{
+    m_timer.stop();
+    m_analyzer.close();
+    delete ui;
+}
+
+inline void RTPollRateDialog::start()
+{
+    m_analyzer.reset();
+
+    QString error;
+    if (!m_analyzer.open(QString(), &error)) {
+        ui->txInstruction->setText(tr("ERROR: %1").arg(error));
+        return;
+    }
+
+    ui->txInstruction->setText(tr("Move the mouse fast in circles. Slow movement skips reports."));
+    ui->pbStart->setText(tr("Stop"));
+    ui->pbReplay->setEnabled(false);
+    m_timer.start();
+}
+
+inline void RTPollRateDialog::stop()
+{
+    if (!m_analyzer.isRunning()) {
+        return;
+    }
+
+    m_timer.stop();
+    m_analyzer.close();
+    ui->pbStart->setText(tr("Start"));
+    ui->pbReplay->setEnabled(true);
+    onUpdate();
+}
+
+inline void RTPollRateDialog::replay()
+{
+    const QString fileName = QFileDialog::getOpenFileName( //
+        this,
+        tr("Replay recorded events"),
+        QString(),
+        tr("Event recordings (*.evemu *.events);;All files (*)"));
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    m_analyzer.reset();
+    QString error;
+    if (!m_analyzer.replay(fileName, &error)) {
+        ui->txInstruction->setText(tr("ERROR: %1").arg(error));
+    } else {
+        ui->txInstruction->setText(tr("Replayed %1").arg(fileName));
+    }
+    onUpdate();
+}
+
+void RTPollRateDialog::onUpdate()
+{
+    const RTPollRateAnalyzer::TStatistics s = m_analyzer.statistics();
+    if (s.intervals == 0) {
+        ui->histogram->setHistogram({}, 0, 1, 0);
+        ui->txResult->setText(tr("%1 reports, no intervals yet.").arg(s.reports));
+        return;
+    }
+
+    const int period = 1000000 / s.nominalHz;
+    const int binUs = qMax(period / 100, 1);
+    const int firstUs = period - POLLRATE_SIDE_BINS * binUs - binUs / 2;
+    ui->histogram->setHistogram(m_analyzer.histogram(firstUs, binUs, 2 * POLLRATE_SIDE_BINS + 1), firstUs, binUs, period);
+
+    QString text = tr("%1 reports at %2 Hz on a %3 Hz grid\n").arg(s.reports).arg(s.rateHz, 0, 'f', 1).arg(s.nominalHz);
+    text += tr("Interval: mean %1 us, sd %2 us, p50 %3 us, p99 %4 us, p99.9 %5 us\n")
+                .arg(s.meanUs, 0, 'f', 1)
+                .arg(s.stddevUs, 0, 'f', 1)
+                .arg(s.p50Us, 0, 'f', 0)
+                .arg(s.p99Us, 0, 'f', 0)
+                .arg(s.p999Us, 0, 'f', 0);
+    text += tr("Jitter: p50 %1 us, p99 %2 us, max %3 us\n")
+                .arg(s.jitterP50Us, 0, 'f', 0)
+                .arg(s.jitterP99Us, 0, 'f', 0)
+                .arg(s.jitterMaxUs, 0, 'f', 0);
+    text += tr("Missed reports %1, early %2, pauses %3").arg(s.late).arg(s.early).arg(s.gaps);
+    if (m_configuredHz > 0 && s.nominalHz != m_configuredHz) {
+        text += tr("\nThe mouse is set to %1 Hz. Move it faster or try another USB port.").arg(m_configuredHz);
+    }
+    ui->txResult->setText(text);
+}
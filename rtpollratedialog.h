@@ -0,0 +1,39 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+
+#include "rtpollrateanalyzer.h"
+#include <QDialog>
+#include <QTimer>
+
+namespace Ui {
+class RTPollRateDialog;
+}
+
+class RTPollRateDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit RTPollRateDialog(int configuredHz, QWidget *parent = nullptr);
+    ~RTPollRateDialog();
+
+private slots:
+    void onUpdate();
+
+private:
+    Ui::RTPollRateDialog *ui;
+    RTPollRateAnalyzer m_analyzer;
+    QTimer m_timer;
+    int m_configuredHz;
+
+private:
+    inline void start();
+    inline void stop();
+    inline void replay();
+};
@@ -0,0 +1,69 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtpollratewidget.h"
+#include <QPainter>
+
+RTPollRateWidget::RTPollRateWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_bins()
+    , m_firstUs(0)
+    , m_binUs(1)
+    , m_periodUs(0)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void RTPollRateWidget::setHistogram(const QList<quint64> &bins, int firstUs, int binUs, int periodUs)
+{
+    m_bins = bins;
+    m_firstUs = firstUs;
+    m_binUs = qMax(binUs, 1);
+    m_periodUs = periodUs;
+    update();
+}
+
+void RTPollRateWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    if (m_bins.isEmpty()) {
+        return;
+    }
+
+    // bars above, the interval axis below
+    const int textHeight = fontMetrics().height();
+    const QRect area = rect().adjusted(4, 4, -4, -4 - textHeight);
+    const qsizetype count = m_bins.count();
+    const double barWidth = area.width() / (double) count;
+
+    quint64 peak = 1;
+    for (quint64 n : std::as_const(m_bins)) {
+        peak = qMax(peak, n);
+    }
+    for (qsizetype b = 0; b < count; b++) {
+        const int height = (int) (area.height() * m_bins[b] / peak);
+        const int x = area.left() + (int) (b * barWidth);
+        const int width = qMax((int) ((b + 1) * barWidth) - (int) (b * barWidth) - 1, 1);
+        painter.fillRect(x, area.bottom() - height, width, height, palette().highlight());
+    }
+
+    // marker on the nominal period
+    painter.setPen(QPen(palette().text().color(), 1, Qt::DashLine));
+    const int px = area.left() + (int) ((double) (m_periodUs - m_firstUs) / m_binUs * barWidth);
+    if (m_periodUs > 0 && px >= area.left() && px <= area.right()) {
+        painter.drawLine(px, area.top(), px, area.bottom());
+    }
+
+    painter.setPen(palette().text().color());
+    const QRect axis(area.left(), area.bottom() + 2, area.width(), textHeight);
+    painter.drawText(axis, Qt::AlignLeft | Qt::AlignVCenter, tr("%1 us").arg(m_firstUs));
+    painter.drawText(axis, Qt::AlignHCenter | Qt::AlignVCenter, tr("%1 us").arg(m_periodUs));
+    painter.drawText(axis, Qt::AlignRight | Qt::AlignVCenter, tr("%1 us").arg(m_firstUs + count * m_binUs));
+}
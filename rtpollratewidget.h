@@ -0,0 +1,41 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+
+#include <QList>
+#include <QWidget>
+
+/**
+ * @brief The RTPollRateWidget draws the report interval histogram of the
+ * polling rate analyzer with a marker on the nominal polling period.
+ */
+class RTPollRateWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RTPollRateWidget(QWidget *parent = nullptr);
+
+    /**
+     * @brief Set the histogram to draw
+     * @param bins Intervals per bin, empty to clear
+     * @param firstUs Start of the first bin
+     * @param binUs Width of one bin
+     * @param periodUs Nominal polling period
+     */
+    void setHistogram(const QList<quint64> &bins, int firstUs, int binUs, int periodUs);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QList<quint64> m_bins; // intervals per bin
+    int m_firstUs;         // start of the first bin
+    int m_binUs;           // width of one bin
+    int m_periodUs;        // nominal polling period
+};
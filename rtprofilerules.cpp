@@ -0,0 +1,53 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtprofilerules.h"
+#include "rttypedefs.h"
+#include <QFileInfo>
+
+RTProfileRules::RTProfileRules()
+    : m_rules()
+    , m_default(-1)
+{}
+
+void RTProfileRules::load(QSettings *settings)
+{
+    m_rules.clear();
+    m_default = -1;
+
+    if (!settings) {
+        return;
+    }
+
+    settings->beginGroup("profileRules");
+    foreach (const QString &key, settings->childKeys()) {
+        bool ok = false;
+        uint value = settings->value(key).toUInt(&ok);
+        if (!ok || value > TYON_PROFILE_NUM) {
+            qWarning("[APPWIN] Ignore profile rule %s: invalid profile", qPrintable(key));
+            continue;
+        }
+        if (key == QStringLiteral("default")) {
+            m_default = (int) value - 1;
+        } else if (value > 0) {
+            m_rules.insert(key, value - 1);
+        }
+    }
+    settings->endGroup();
+}
+
+int RTProfileRules::profileOf(const QString &program) const
+{
+    const QString name = QFileInfo(program).fileName();
+
+    QHash<QString, quint8>::const_iterator it = m_rules.constFind(name);
+    if (it != m_rules.constEnd()) {
+        return it.value();
+    }
+
+    return m_default;
+}
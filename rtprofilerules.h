@@ -0,0 +1,54 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QHash>
+#include <QSettings>
+#include <QString>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The RTProfileRules class maps program executables to device
+ * profiles. The table is built once from the settings file, lookups are
+ * a single hash probe.
+ *
+ * Settings layout:
+ *   [profileRules]
+ *   default=0         ; profile 1-5 if no rule matches, 0 = keep active
+ *   steam=2           ; executable file name = profile 1-5
+ */
+class RTProfileRules
+{
+public:
+    /**
+     * @brief Default constructor, no rules
+     */
+    RTProfileRules();
+
+    /**
+     * @brief Build the rule table from the settings group 'profileRules'
+     * @param settings Application settings
+     */
+    void load(QSettings *settings);
+
+    /**
+     * @brief Return true if no rule is defined
+     * @return True or False
+     */
+    inline bool isEmpty() const { return m_rules.isEmpty() && m_default < 0; }
+
+    /**
+     * @brief Return the profile for the given program
+     * @param program Absolute path or file name of the executable
+     * @return Profile index 0-4 or -1 to keep the active profile
+     */
+    int profileOf(const QString &program) const;
+
+private:
+    QHash<QString, quint8> m_rules;
+    int m_default;
+};
@@ -18,6 +18,7 @@ QMutex RTProgress::mutex;
 
 RTProgress::RTProgress(const QString &message, QWidget *parent)
     : QDialog(parent)
+    , label(new QLabel(this))
     , progressBar(new QProgressBar(this))
 {
     //| Qt::WindowStaysOnTopHint
@@ -27,7 +28,7 @@ RTProgress::RTProgress(const QString &message, QWidget *parent)
     auto *layout = new QVBoxLayout(this);
     layout->setAlignment(Qt::AlignCenter);
 
-    QLabel *label = new QLabel((message.isEmpty() ? tr("Please wait...") : message), this);
+    label->setText(message.isEmpty() ? tr("Please wait...") : message);
     label->setAlignment(Qt::AlignCenter);
     label->setWordWrap(true);
     label->setFixedWidth(320);
@@ -54,6 +55,8 @@ void RTProgress::present(const QString &message, QWidget *parent)
 
     if (!instance) {
         instance = new RTProgress(message, parent);
+    } else if (!message.isEmpty()) {
+        instance->label->setText(message);
     }
 
     // Position in Bildschirmmitte
@@ -70,8 +73,8 @@ void RTProgress::present(const QString &message, QWidget *parent)
     instance->setWindowTitle(message);
     instance->setVisible(true);
     instance->raise();
-
-    QApplication::processEvents();
+    // paint without entering the event loop again
+    instance->repaint();
 }
 
 void RTProgress::dismiss()
@@ -90,7 +93,7 @@ void RTProgress::setProgress(int value)
     //QMutexLocker locker(&mutex);
 
     if (instance && instance->progressBar) {
+        instance->progressBar->setVisible(true);
         instance->progressBar->setValue(value);
-        QApplication::processEvents();
     }
 }
@@ -11,6 +11,7 @@
 #include <QMutex>
 #include <QPointer>
 
+class QLabel;
 class QProgressBar;
 
 class RTProgress : public QDialog
@@ -20,7 +21,7 @@ class RTProgress : public QDialog
 public:
     static void present(const QString &message, QWidget *parent = nullptr);
     static void dismiss();
-    static void setProgress(int value); // 0 - 100
+    static void setProgress(int value); // 0 - 100, shows the bar
 
 protected:
     explicit RTProgress(const QString &message, QWidget *parent = nullptr);
@@ -28,5 +29,6 @@ protected:
 private:
     static QPointer<RTProgress> instance;
     static QMutex mutex;
+    QLabel *label;
     QProgressBar *progressBar;
 };
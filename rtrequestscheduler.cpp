@@ -0,0 +1,159 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtrequestscheduler.h"
+#include <QMutexLocker>
+#include <QThread>
+
+RTRequestScheduler::Step::Step(RTRequestScheduler *scheduler, TPriority priority)
+    : m_scheduler(scheduler)
+{
+    m_scheduler->acquire(priority);
+}
+
+RTRequestScheduler::Step::~Step()
+{
+    m_scheduler->release();
+}
+
+RTRequestScheduler::RTRequestScheduler()
+    : m_mutex()
+    , m_free()
+    , m_owner(nullptr)
+    , m_depth(0)
+    , m_priority(Normal)
+    , m_waiting()
+    , m_clock()
+    , m_holdStart(0)
+    , m_stats()
+{
+    m_clock.start();
+}
+
+inline bool RTRequestScheduler::mayRun(TPriority priority) const
+{
+    if (m_depth > 0) {
+        return false;
+    }
+    for (int p = Interactive; p < priority; p++) {
+        if (m_waiting[p] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RTRequestScheduler::acquire(TPriority priority)
+{
+    const Qt::HANDLE self = QThread::currentThreadId();
+    QMutexLocker lock(&m_mutex);
+
+    // nested step of the owner, e.g. a transaction inside a profile upload
+    if (m_depth > 0 && m_owner == self) {
+        m_depth++;
+        return;
+    }
+
+    const qint64 start = m_clock.nsecsElapsed();
+    m_waiting[priority]++;
+    while (!mayRun(priority)) {
+        m_free.wait(&m_mutex);
+    }
+    m_waiting[priority]--;
+
+    m_owner = self;
+    m_depth = 1;
+    m_priority = priority;
+    m_holdStart = m_clock.nsecsElapsed();
+
+    const quint64 wait = (m_holdStart - start) / 1000;
+    TClassStatistics &s = m_stats.classes[priority];
+    s.steps++;
+    s.waitTotal += wait;
+    s.waitMax = qMax(s.waitMax, wait);
+    // lower classes may wait as long as higher ones keep the device busy
+    if (priority == Interactive && wait > RT_SCHED_STEP_BUDGET_MS * 1000ULL) {
+        s.overBudget++;
+        qWarning("[HIDDEV] %s request waited %.1f ms for the device", name(priority), wait / 1000.0);
+    }
+}
+
+bool RTRequestScheduler::tryAcquire(TPriority priority)
+{
+    const Qt::HANDLE self = QThread::currentThreadId();
+    QMutexLocker lock(&m_mutex);
+
+    if (m_depth > 0 && m_owner == self) {
+        m_depth++;
+        return true;
+    }
+    // waiting steps of the same class go first as well
+    if (!mayRun(priority) || m_waiting[priority] > 0) {
+        return false;
+    }
+
+    m_owner = self;
+    m_depth = 1;
+    m_priority = priority;
+    m_holdStart = m_clock.nsecsElapsed();
+    m_stats.classes[priority].steps++;
+    return true;
+}
+
+void RTRequestScheduler::release()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_depth <= 0 || m_owner != QThread::currentThreadId()) {
+        return;
+    }
+    if (--m_depth > 0) {
+        return;
+    }
+
+    const quint64 hold = (m_clock.nsecsElapsed() - m_holdStart) / 1000;
+    TClassStatistics &s = m_stats.classes[m_priority];
+    s.holdMax = qMax(s.holdMax, hold);
+    // an interactive request may have waited this long
+    if (m_priority != Interactive && hold > RT_SCHED_STEP_BUDGET_MS * 1000ULL) {
+        s.overBudget++;
+        qWarning("[HIDDEV] %s step held the device %.1f ms", name(m_priority), hold / 1000.0);
+    }
+
+    m_owner = nullptr;
+    m_free.wakeAll();
+}
+
+RTRequestScheduler::TStatistics RTRequestScheduler::statistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
+
+void RTRequestScheduler::resetStatistics()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stats = {};
+}
+
+const char *RTRequestScheduler::name(TPriority priority)
+{
+    switch (priority) {
+        case Interactive: {
+            return "Interactive";
+        }
+        case Normal: {
+            return "Normal";
+        }
+        case Bulk: {
+            return "Bulk";
+        }
+        default: {
+            break;
+        }
+    }
+    return "Unknown";
+}
@@ -0,0 +1,125 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtCore/QtGlobal>
+
+/* A step of another class should not hold the device longer */
+#define RT_SCHED_STEP_BUDGET_MS 100
+
+/**
+ * @brief The RTRequestScheduler class serializes device access from the
+ * controller, its worker threads and the sensor capture. Every access runs
+ * as a step of one priority class. A waiting step of a higher class is
+ * served before any lower one, and bulk work (profile uploads, sensor
+ * frames) is split into short steps, so an interactive request waits for
+ * at most the step in progress. Steps are reentrant on the owning thread,
+ * a nested step joins the outer one.
+ */
+class RTRequestScheduler
+{
+public:
+    enum TPriority {
+        Interactive = 0, // profile switch, user triggered writes
+        Normal,          // sync, calibration, register batches
+        Bulk,            // profile uploads, sensor frames
+        PriorityCount,
+    };
+
+    /**
+     * @brief Latency of one priority class
+     */
+    typedef struct
+    {
+        quint32 steps;      // steps executed
+        quint64 waitTotal;  // time waited for the device in us
+        quint64 waitMax;    // longest wait in us
+        quint64 holdMax;    // longest step in us
+        quint32 overBudget; // interactive waits, other steps over RT_SCHED_STEP_BUDGET_MS
+    } TClassStatistics;
+
+    /**
+     * @brief Scheduler statistics per priority class
+     */
+    typedef struct
+    {
+        TClassStatistics classes[PriorityCount];
+    } TStatistics;
+
+    /**
+     * @brief The Step class holds the device for its lifetime, like a
+     * QMutexLocker. Bulk work creates one per resumable step.
+     */
+    class Step
+    {
+    public:
+        Step(RTRequestScheduler *scheduler, TPriority priority);
+        ~Step();
+
+    private:
+        RTRequestScheduler *m_scheduler;
+        Q_DISABLE_COPY(Step)
+    };
+
+    /**
+     * @brief Default constructor, device idle
+     */
+    RTRequestScheduler();
+
+    /**
+     * @brief Wait until the device is free and no higher class is waiting.
+     * Returns at once if the calling thread already holds the device.
+     * @param priority Class of the step
+     */
+    void acquire(TPriority priority);
+
+    /**
+     * @brief Take the device only if it is free and no higher class is
+     * waiting, for work that may be dropped (TalkFX frames)
+     * @param priority Class of the step
+     * @return True if the calling thread holds the device, release() it
+     */
+    bool tryAcquire(TPriority priority);
+
+    /**
+     * @brief End the step of the calling thread
+     */
+    void release();
+
+    /**
+     * @brief Return and keep the statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+    /**
+     * @brief Clear the statistics
+     */
+    void resetStatistics();
+
+    /**
+     * @brief Return the printable name of a priority class
+     */
+    static const char *name(TPriority priority);
+
+private:
+    mutable QMutex m_mutex;
+    QWaitCondition m_free;
+    Qt::HANDLE m_owner;
+    int m_depth;
+    TPriority m_priority;
+    quint32 m_waiting[PriorityCount];
+    QElapsedTimer m_clock;
+    qint64 m_holdStart;
+    TStatistics m_stats;
+
+private:
+    inline bool mayRun(TPriority priority) const;
+};
@@ -0,0 +1,159 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtsensorcapture.h"
+#include "rtcontroller.h"
+#include "rtframelog.h"
+#include <QMutexLocker>
+
+RTSensorFramePool::RTSensorFramePool(int count)
+    : m_mutex()
+    , m_frames()
+    , m_free()
+{
+    for (int i = 0; i < count; i++) {
+        TSensorFrame *frame = new TSensorFrame();
+        m_frames.append(frame);
+        m_free.append(frame);
+    }
+}
+
+RTSensorFramePool::~RTSensorFramePool()
+{
+    qDeleteAll(m_frames);
+}
+
+TSensorFrame *RTSensorFramePool::acquire()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_free.isEmpty()) {
+        return nullptr;
+    }
+    return m_free.takeLast();
+}
+
+void RTSensorFramePool::release(TSensorFrame *frame)
+{
+    QMutexLocker lock(&m_mutex);
+    m_free.append(frame);
+}
+
+// -------------------------------------------------------------
+
+RTSensorCapture::RTSensorCapture(RTController *controller, int poolSize)
+    : QThread(nullptr)
+    , m_controller(controller)
+    , m_pool(new RTSensorFramePool(poolSize))
+    , m_mutex()
+    , m_stats()
+    , m_log(nullptr)
+    , m_dcu(0)
+    , m_tcu(0)
+{
+    qRegisterMetaType<TSensorFrameRef>();
+}
+
+RTSensorCapture::~RTSensorCapture()
+{
+    stop();
+    wait();
+}
+
+void RTSensorCapture::stop()
+{
+    requestInterruption();
+}
+
+RTSensorCapture::TStatistics RTSensorCapture::statistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
+
+void RTSensorCapture::setFrameLog(RTFrameLog *log, quint8 dcu, quint8 tcu)
+{
+    QMutexLocker lock(&m_mutex);
+    m_log = log;
+    m_dcu = dcu;
+    m_tcu = tcu;
+}
+
+void RTSensorCapture::run()
+{
+    QElapsedTimer clock;
+    qint64 windowStart = 0;
+    quint64 windowFrames = 0;
+    quint64 sequence = 0;
+    TyonSensorImage scratch = {};
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stats = {};
+    }
+
+    clock.start();
+    while (!isInterruptionRequested()) {
+        // the frame is read even without a free buffer, so the sensor
+        // timing stays the same and the loss is counted
+        TSensorFrame *frame = m_pool->acquire();
+        TyonSensorImage *image = (frame ? &frame->image : &scratch);
+        if (!m_controller->tcuSensorCaptureFrame(image)) {
+            if (frame) {
+                m_pool->release(frame);
+            }
+            emit captureFailed();
+            break;
+        }
+
+        ++sequence;
+        if (!frame) {
+            QMutexLocker lock(&m_mutex);
+            m_stats.dropped++;
+        } else {
+            frame->sequence = sequence;
+            frame->timestamp = clock.nsecsElapsed();
+            RTSensorStats::compute(&frame->image, &frame->stats);
+            frame->median = RTSensorStats::metric(frame->stats, m_controller->tcuMetric());
+
+            // hand out by reference, buffer returns to the pool on release
+            QSharedPointer<RTSensorFramePool> pool = m_pool;
+            const TSensorFrameRef ref(frame, [pool](const TSensorFrame *f) { //
+                pool->release(const_cast<TSensorFrame *>(f));
+            });
+            {
+                QMutexLocker lock(&m_mutex);
+                m_stats.frames++;
+                if (m_log && !m_log->append(*frame, m_dcu, m_tcu)) {
+                    qWarning("[HIDDEV] Frame log write failed: %s", qPrintable(m_log->errorString()));
+                    m_log = nullptr;
+                }
+            }
+            windowFrames++;
+            emit frameReady(ref);
+        }
+
+        const qint64 now = clock.nsecsElapsed();
+        if (now - windowStart >= 1000000000LL) {
+            TStatistics stats;
+            {
+                QMutexLocker lock(&m_mutex);
+                m_stats.fps = windowFrames * 1e9 / (now - windowStart);
+                stats = m_stats;
+            }
+            windowStart = now;
+            windowFrames = 0;
+            emit statisticsChanged(stats.fps, stats.frames, stats.dropped);
+        }
+    }
+
+    const TStatistics stats = statistics();
+    const qint64 elapsed = qMax<qint64>(clock.nsecsElapsed(), 1);
+    qInfo("[HIDDEV] Sensor capture stopped: %llu frames, %llu dropped, avg %.1f fps", //
+          (unsigned long long) stats.frames,
+          (unsigned long long) stats.dropped,
+          stats.frames * 1e9 / elapsed);
+}
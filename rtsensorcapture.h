@@ -0,0 +1,131 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtsensorstats.h"
+#include "rttypedefs.h"
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief One captured TCU sensor frame
+ */
+typedef struct
+{
+    quint64 sequence;      // capture counter, gaps are dropped frames
+    qint64 timestamp;      // capture time in ns (QElapsedTimer clock)
+    uint median;           // TCU value by the controller's metric
+    TSensorStats stats;    // image statistics
+    TyonSensorImage image; // raw sensor report
+} TSensorFrame;
+
+/**
+ * @brief Shared reference to a pooled frame. The buffer returns to the
+ * pool when the last consumer releases its reference.
+ */
+typedef QSharedPointer<const TSensorFrame> TSensorFrameRef;
+Q_DECLARE_METATYPE(TSensorFrameRef)
+
+/**
+ * @brief Fixed set of reusable frame buffers
+ */
+class RTSensorFramePool
+{
+public:
+    explicit RTSensorFramePool(int count);
+    ~RTSensorFramePool();
+
+    /**
+     * @brief Take a free buffer
+     * @return Buffer or nullptr if all buffers are referenced
+     */
+    TSensorFrame *acquire();
+
+    /**
+     * @brief Return a buffer taken by acquire()
+     */
+    void release(TSensorFrame *frame);
+
+private:
+    QMutex m_mutex;
+    QList<TSensorFrame *> m_frames;
+    QList<TSensorFrame *> m_free;
+};
+
+class RTController;
+class RTFrameLog;
+
+/**
+ * @brief The RTSensorCapture thread captures TCU sensor frames as fast as
+ * the device delivers them. Frames are handed out by shared reference.
+ */
+class RTSensorCapture : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Capture statistics
+     */
+    typedef struct
+    {
+        double fps;      // frames per second of the last second
+        quint64 frames;  // frames delivered
+        quint64 dropped; // frames lost because no buffer was free
+    } TStatistics;
+
+    /**
+     * @brief Constructor
+     * @param controller Device controller used for the HID access
+     * @param poolSize Number of frame buffers
+     */
+    explicit RTSensorCapture(RTController *controller, int poolSize = 4);
+
+    /**
+     * @brief Stop the capture and wait for the thread
+     */
+    ~RTSensorCapture();
+
+    /**
+     * @brief Request the thread to stop after the current frame
+     */
+    void stop();
+
+    /**
+     * @brief Return the capture statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+    /**
+     * @brief Record every captured frame on the capture thread
+     * @param log Frame log opened with openAppend(), nullptr to stop recording
+     * @param dcu Distance control unit state stored with the frames
+     * @param tcu Tracking control unit state stored with the frames
+     */
+    void setFrameLog(RTFrameLog *log, quint8 dcu = 0, quint8 tcu = 0);
+
+    void run() override;
+
+signals:
+    void frameReady(const TSensorFrameRef &frame);
+    void statisticsChanged(double fps, quint64 frames, quint64 dropped);
+    void captureFailed();
+
+private:
+    RTController *m_controller;
+    QSharedPointer<RTSensorFramePool> m_pool;
+    mutable QMutex m_mutex;
+    TStatistics m_stats;
+    RTFrameLog *m_log;
+    quint8 m_dcu;
+    quint8 m_tcu;
+};
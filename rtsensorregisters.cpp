@@ -0,0 +1,153 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtsensorregisters.h"
+#include <QMutexLocker>
+#include <string.h>
+
+// ADNS-9800 register map, see the Avago data sheet
+enum {
+    REG_PRODUCT_ID = 0x00,
+    REG_REVISION_ID = 0x01,
+    REG_MOTION = 0x02,
+    REG_DELTA_Y_H = 0x06,
+    REG_SROM_ENABLE = 0x13,
+    REG_SROM_ID = 0x2a,
+    REG_POWER_UP_RESET = 0x3a,
+    REG_SHUTDOWN = 0x3b,
+    REG_INVERSE_PRODUCT_ID = 0x3f,
+    REG_MOTION_BURST = 0x50,
+};
+
+RTSensorRegisters::RTSensorRegisters()
+    : m_mutex()
+    , m_values()
+    , m_cached()
+    , m_stats()
+{
+    reset();
+}
+
+TSensorRegisterOp RTSensorRegisters::read(quint8 reg)
+{
+    return {reg, 0, false, false, false};
+}
+
+TSensorRegisterOp RTSensorRegisters::write(quint8 reg, quint8 value)
+{
+    return {reg, value, true, false, false};
+}
+
+bool RTSensorRegisters::isReadOnly(quint8 reg)
+{
+    switch (reg) {
+        case REG_PRODUCT_ID:
+        case REG_REVISION_ID:
+        case REG_SROM_ID:
+        case REG_INVERSE_PRODUCT_ID: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool RTSensorRegisters::isDumpable(quint8 reg)
+{
+    if (reg >= REG_MOTION && reg <= REG_DELTA_Y_H) {
+        return false;
+    }
+    switch (reg) {
+        case REG_SROM_ENABLE:
+        case REG_POWER_UP_RESET:
+        case REG_SHUTDOWN: {
+            // write only
+            return false;
+        }
+        default: {
+            break;
+        }
+    }
+    return reg < REG_MOTION_BURST;
+}
+
+TSensorRegisterBatch RTSensorRegisters::dumpBatch()
+{
+    TSensorRegisterBatch batch;
+    batch.reserve(REG_MOTION_BURST);
+    for (quint8 reg = 0; reg < REG_MOTION_BURST; reg++) {
+        if (isDumpable(reg)) {
+            batch.append(read(reg));
+        }
+    }
+    return batch;
+}
+
+void RTSensorRegisters::toSnapshot(const TSensorRegisterBatch &batch, TSnapshot *snapshot)
+{
+    memset(snapshot, 0, sizeof(TSnapshot));
+    for (const TSensorRegisterOp &op : batch) {
+        if (!op.write && op.ok && op.reg < RegisterCount) {
+            snapshot->value[op.reg] = op.value;
+            snapshot->valid[op.reg] = true;
+        }
+    }
+}
+
+QList<quint8> RTSensorRegisters::compare(const TSnapshot &a, const TSnapshot &b)
+{
+    QList<quint8> changed;
+    for (int reg = 0; reg < RegisterCount; reg++) {
+        if (a.valid[reg] && b.valid[reg] && a.value[reg] != b.value[reg]) {
+            changed.append(reg);
+        }
+    }
+    return changed;
+}
+
+void RTSensorRegisters::reset()
+{
+    QMutexLocker lock(&m_mutex);
+    memset(m_values, 0, sizeof(m_values));
+    memset(m_cached, 0, sizeof(m_cached));
+}
+
+bool RTSensorRegisters::lookup(quint8 reg, quint8 *value)
+{
+    QMutexLocker lock(&m_mutex);
+    if (reg >= RegisterCount || !m_cached[reg]) {
+        return false;
+    }
+    *value = m_values[reg];
+    m_stats.cacheHits++;
+    return true;
+}
+
+void RTSensorRegisters::store(quint8 reg, quint8 value)
+{
+    if (!isReadOnly(reg)) {
+        return;
+    }
+    QMutexLocker lock(&m_mutex);
+    m_values[reg] = value;
+    m_cached[reg] = true;
+}
+
+void RTSensorRegisters::count(quint32 reads, quint32 writes)
+{
+    QMutexLocker lock(&m_mutex);
+    m_stats.batches++;
+    m_stats.reads += reads;
+    m_stats.writes += writes;
+}
+
+RTSensorRegisters::TStatistics RTSensorRegisters::statistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,154 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rttypedefs.h"
+#include <QList>
+#include <QMutex>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief One sensor register access of a batch
+ */
+typedef struct
+{
+    quint8 reg;   // register address 0x00-0x7f
+    quint8 value; // value to write, or the value read
+    bool write;   // true = write, false = read
+    bool ok;      // set by the batch, true if executed
+    bool cached;  // set by the batch, true if served from the cache
+} TSensorRegisterOp;
+
+typedef QList<TSensorRegisterOp> TSensorRegisterBatch;
+
+/**
+ * @brief The RTSensorRegisters class describes the register space of the
+ * ADNS-9800 laser sensor behind the TyonSensor report and caches the
+ * identity registers, which never change while the device is connected.
+ * The batch itself runs in RTController::sensorRegisterBatch().
+ */
+class RTSensorRegisters
+{
+public:
+    enum {
+        RegisterCount = 0x80,
+    };
+
+    /**
+     * @brief Full register space, as read by a dump
+     */
+    typedef struct
+    {
+        quint8 value[RegisterCount];
+        bool valid[RegisterCount];
+    } TSnapshot;
+
+    /**
+     * @brief Batch statistics
+     */
+    typedef struct
+    {
+        quint32 batches;   // batches executed
+        quint32 reads;     // register reads sent to the device
+        quint32 writes;    // register writes sent to the device
+        quint32 cacheHits; // reads served from the cache
+    } TStatistics;
+
+    /**
+     * @brief Default constructor, cache empty
+     */
+    RTSensorRegisters();
+
+    /**
+     * @brief Create a register read operation
+     * @param reg Register address
+     * @return TSensorRegisterOp structure
+     */
+    static TSensorRegisterOp read(quint8 reg);
+
+    /**
+     * @brief Create a register write operation
+     * @param reg Register address
+     * @param value Register value
+     * @return TSensorRegisterOp structure
+     */
+    static TSensorRegisterOp write(quint8 reg, quint8 value);
+
+    /**
+     * @brief Return true for the constant identity registers
+     * @param reg Register address
+     */
+    static bool isReadOnly(quint8 reg);
+
+    /**
+     * @brief Return true if reading the register has no side effect. The
+     * motion registers clear the accumulated motion, the burst registers
+     * switch the sensor into burst mode.
+     * @param reg Register address
+     */
+    static bool isDumpable(quint8 reg);
+
+    /**
+     * @brief Return the read batch covering all dumpable registers
+     * @return Batch of read operations
+     */
+    static TSensorRegisterBatch dumpBatch();
+
+    /**
+     * @brief Copy the results of a batch into a snapshot
+     * @param batch Executed batch
+     * @param snapshot Target, registers not read are marked invalid
+     */
+    static void toSnapshot(const TSensorRegisterBatch &batch, TSnapshot *snapshot);
+
+    /**
+     * @brief Compare two snapshots
+     * @param a First snapshot
+     * @param b Second snapshot
+     * @return Addresses valid in both snapshots with different values
+     */
+    static QList<quint8> compare(const TSnapshot &a, const TSnapshot &b);
+
+    /**
+     * @brief Forget all cached registers, called on device lookup
+     */
+    void reset();
+
+    /**
+     * @brief Look up a cached identity register
+     * @param reg Register address
+     * @param value Receives the cached value
+     * @return True if the register is cached
+     */
+    bool lookup(quint8 reg, quint8 *value);
+
+    /**
+     * @brief Cache a register value if it is an identity register
+     * @param reg Register address
+     * @param value Value read from the device
+     */
+    void store(quint8 reg, quint8 value);
+
+    /**
+     * @brief Count an executed batch
+     * @param reads Reads sent to the device
+     * @param writes Writes sent to the device
+     */
+    void count(quint32 reads, quint32 writes);
+
+    /**
+     * @brief Return the batch statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+private:
+    mutable QMutex m_mutex;
+    quint8 m_values[RegisterCount];
+    bool m_cached[RegisterCount];
+    TStatistics m_stats;
+};
@@ -0,0 +1,281 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtsensorstats.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RT_SENSOR_STATS_X86
+#endif
+
+// Histogram update of the pixels, 4 sub tables against store forwarding
+// stalls on runs of equal values. Shared by all code paths.
+static inline void histogramUpdate(quint32 (*hist)[256], const quint8 *p, qsizetype n)
+{
+    qsizetype i = 0;
+    for (; i + 4 <= n; i += 4) {
+        hist[0][p[i + 0]]++;
+        hist[1][p[i + 1]]++;
+        hist[2][p[i + 2]]++;
+        hist[3][p[i + 3]]++;
+    }
+    for (; i < n; i++) {
+        hist[0][p[i]]++;
+    }
+}
+
+static void computeScalar(const quint8 *p, qsizetype n, quint32 (*hist)[256], quint64 *sum, quint64 *sq, quint8 *mn, quint8 *mx)
+{
+    quint64 s = 0, s2 = 0;
+    quint8 lo = 0xff, hi = 0x00;
+    for (qsizetype i = 0; i < n; i++) {
+        const quint32 v = p[i];
+        s += v;
+        s2 += v * v;
+        lo = qMin<quint8>(lo, v);
+        hi = qMax<quint8>(hi, v);
+    }
+    histogramUpdate(hist, p, n);
+    *sum = s;
+    *sq = s2;
+    *mn = lo;
+    *mx = hi;
+}
+
+#ifdef RT_SENSOR_STATS_X86
+__attribute__((target("sse2"))) //
+static void computeSSE2(const quint8 *p, qsizetype n, quint32 (*hist)[256], quint64 *sum, quint64 *sq, quint8 *mn, quint8 *mx)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vsum = zero; // 2x 64 bit
+    __m128i vsq = zero;  // 4x 32 bit, max 16 * 255^2 per lane and block
+    __m128i vmin = _mm_set1_epi8((char) 0xff);
+    __m128i vmax = zero;
+    quint64 s2 = 0;
+    qsizetype i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (p + i));
+        vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+        vmin = _mm_min_epu8(vmin, v);
+        vmax = _mm_max_epu8(vmax, v);
+        const __m128i l = _mm_unpacklo_epi8(v, zero);
+        const __m128i h = _mm_unpackhi_epi8(v, zero);
+        vsq = _mm_add_epi32(vsq, _mm_add_epi32(_mm_madd_epi16(l, l), _mm_madd_epi16(h, h)));
+        // flush before the 32 bit lanes can overflow
+        if ((i & 0x3fff) == 0x3ff0) {
+            quint32 q[4];
+            _mm_storeu_si128((__m128i *) q, vsq);
+            s2 += (quint64) q[0] + q[1] + q[2] + q[3];
+            vsq = zero;
+        }
+    }
+    histogramUpdate(hist, p, i);
+
+    quint64 s[2];
+    quint32 q[4];
+    quint8 lo[16], hi[16];
+    _mm_storeu_si128((__m128i *) s, vsum);
+    _mm_storeu_si128((__m128i *) q, vsq);
+    _mm_storeu_si128((__m128i *) lo, vmin);
+    _mm_storeu_si128((__m128i *) hi, vmax);
+
+    quint64 tsum, tsq;
+    quint8 tmin, tmax;
+    computeScalar(p + i, n - i, hist, &tsum, &tsq, &tmin, &tmax);
+
+    *sum = s[0] + s[1] + tsum;
+    *sq = s2 + q[0] + q[1] + q[2] + q[3] + tsq;
+    *mn = tmin;
+    *mx = tmax;
+    for (int k = 0; k < 16; k++) {
+        *mn = qMin(*mn, lo[k]);
+        *mx = qMax(*mx, hi[k]);
+    }
+}
+
+__attribute__((target("avx2"))) //
+static void computeAVX2(const quint8 *p, qsizetype n, quint32 (*hist)[256], quint64 *sum, quint64 *sq, quint8 *mn, quint8 *mx)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vsum = zero; // 4x 64 bit
+    __m256i vsq = zero;  // 8x 32 bit
+    __m256i vmin = _mm256_set1_epi8((char) 0xff);
+    __m256i vmax = zero;
+    quint64 s2 = 0;
+    qsizetype i = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *) (p + i));
+        vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(v, zero));
+        vmin = _mm256_min_epu8(vmin, v);
+        vmax = _mm256_max_epu8(vmax, v);
+        const __m256i l = _mm256_unpacklo_epi8(v, zero);
+        const __m256i h = _mm256_unpackhi_epi8(v, zero);
+        vsq = _mm256_add_epi32(vsq, _mm256_add_epi32(_mm256_madd_epi16(l, l), _mm256_madd_epi16(h, h)));
+        if ((i & 0x7fff) == 0x7fe0) {
+            quint32 q[8];
+            _mm256_storeu_si256((__m256i *) q, vsq);
+            for (int k = 0; k < 8; k++) {
+                s2 += q[k];
+            }
+            vsq = zero;
+        }
+    }
+    histogramUpdate(hist, p, i);
+
+    quint64 s[4];
+    quint32 q[8];
+    quint8 lo[32], hi[32];
+    _mm256_storeu_si256((__m256i *) s, vsum);
+    _mm256_storeu_si256((__m256i *) q, vsq);
+    _mm256_storeu_si256((__m256i *) lo, vmin);
+    _mm256_storeu_si256((__m256i *) hi, vmax);
+
+    quint64 tsum, tsq;
+    quint8 tmin, tmax;
+    computeScalar(p + i, n - i, hist, &tsum, &tsq, &tmin, &tmax);
+
+    *sum = s[0] + s[1] + s[2] + s[3] + tsum;
+    *sq = s2 + tsq;
+    for (int k = 0; k < 8; k++) {
+        *sq += q[k];
+    }
+    *mn = tmin;
+    *mx = tmax;
+    for (int k = 0; k < 32; k++) {
+        *mn = qMin(*mn, lo[k]);
+        *mx = qMax(*mx, hi[k]);
+    }
+}
+#endif
+
+// Value at 1 based rank in the histogram
+static inline quint8 valueAtRank(const quint32 *hist, quint64 rank)
+{
+    quint64 cum = 0;
+    for (int v = 0; v < 256; v++) {
+        cum += hist[v];
+        if (cum >= rank) {
+            return (quint8) v;
+        }
+    }
+    return 0xff;
+}
+
+RTSensorStats::TPath RTSensorStats::bestPath()
+{
+#ifdef RT_SENSOR_STATS_X86
+    static const TPath path = []() -> TPath {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return PathAVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return PathSSE2;
+        }
+        return PathScalar;
+    }();
+    return path;
+#else
+    return PathScalar;
+#endif
+}
+
+void RTSensorStats::compute(const TyonSensorImage *image, TSensorStats *stats)
+{
+    compute(image->data, TYON_SENSOR_IMAGE_SIZE * TYON_SENSOR_IMAGE_SIZE, stats);
+}
+
+void RTSensorStats::compute(const quint8 *data, qsizetype length, TSensorStats *stats)
+{
+    compute(data, length, stats, bestPath());
+}
+
+void RTSensorStats::compute(const quint8 *data, qsizetype length, TSensorStats *stats, TPath path)
+{
+    quint32 hist[4][256];
+    memset(hist, 0, sizeof(hist));
+    memset(stats, 0, sizeof(TSensorStats));
+    if (!data || length <= 0) {
+        return;
+    }
+
+    switch (path) {
+#ifdef RT_SENSOR_STATS_X86
+        case PathAVX2: {
+            computeAVX2(data, length, hist, &stats->sum, &stats->sumSquares, &stats->min, &stats->max);
+            break;
+        }
+        case PathSSE2: {
+            computeSSE2(data, length, hist, &stats->sum, &stats->sumSquares, &stats->min, &stats->max);
+            break;
+        }
+#endif
+        default: {
+            computeScalar(data, length, hist, &stats->sum, &stats->sumSquares, &stats->min, &stats->max);
+            break;
+        }
+    }
+
+    quint32 peak = 0;
+    for (int v = 0; v < 256; v++) {
+        stats->histogram[v] = hist[0][v] + hist[1][v] + hist[2][v] + hist[3][v];
+        if (stats->histogram[v] > peak) {
+            peak = stats->histogram[v];
+            stats->mode = (quint8) v;
+        }
+    }
+
+    const quint64 n = (quint64) length;
+    stats->count = (quint32) n;
+    stats->median = (quint8) ((valueAtRank(stats->histogram, (n + 1) / 2) //
+                               + valueAtRank(stats->histogram, n / 2 + 1) + 1)
+                              / 2);
+    stats->mean = (double) stats->sum / n;
+    // integer numerator, identical on every path
+    stats->variance = (double) (n * stats->sumSquares - stats->sum * stats->sum) / ((double) n * n);
+}
+
+quint8 RTSensorStats::percentile(const TSensorStats &stats, uint percent)
+{
+    if (!stats.count) {
+        return 0;
+    }
+    const quint64 p = qMin<uint>(percent, 100);
+    const quint64 rank = qMax<quint64>((p * stats.count + 99) / 100, 1);
+    return valueAtRank(stats.histogram, rank);
+}
+
+quint8 RTSensorStats::metric(const TSensorStats &stats, TMetric metric)
+{
+    switch (metric) {
+        case MetricMedian: {
+            return stats.median;
+        }
+        case MetricMode: {
+            return stats.mode;
+        }
+        default: {
+            break;
+        }
+    }
+    // integer division like the ROCCAT driver
+    return (quint8) (stats.count ? stats.sum / stats.count : 0);
+}
+
+RTSensorStats::TMetric RTSensorStats::metricFromName(const QString &name)
+{
+    const QString n = name.trimmed().toLower();
+    if (n == QStringLiteral("median")) {
+        return MetricMedian;
+    }
+    if (n == QStringLiteral("mode")) {
+        return MetricMode;
+    }
+    return MetricMean;
+}
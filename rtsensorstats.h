@@ -0,0 +1,101 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rttypedefs.h"
+#include <QString>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief Statistics of one TCU sensor image
+ */
+typedef struct
+{
+    quint32 histogram[256]; // pixel count per value
+    quint32 count;          // number of pixels
+    quint64 sum;            // sum of all pixel values
+    quint64 sumSquares;     // sum of all squared pixel values
+    quint8 min;             // smallest pixel value
+    quint8 max;             // largest pixel value
+    quint8 median;          // median, mean of both middle values rounded
+    quint8 mode;            // most frequent value, lowest on ties
+    double mean;            // sum / count
+    double variance;        // population variance
+} TSensorStats;
+
+/**
+ * @brief The RTSensorStats class computes TCU sensor image statistics in
+ * one pass. Uses AVX2 or SSE2 where available, otherwise plain C++. All
+ * accumulation is done in integers, so every code path returns identical
+ * results.
+ */
+class RTSensorStats
+{
+public:
+    /**
+     * @brief Statistic written as TCU median to the device
+     */
+    typedef enum {
+        MetricMean = 0, // sum / count, the ROCCAT driver default
+        MetricMedian,   // true median
+        MetricMode,     // most frequent value
+    } TMetric;
+
+    /**
+     * @brief Instruction set used by compute()
+     */
+    typedef enum {
+        PathScalar = 0,
+        PathSSE2,
+        PathAVX2,
+    } TPath;
+
+    /**
+     * @brief Compute the statistics of a sensor image
+     * @param image Sensor report
+     * @param stats Result
+     */
+    static void compute(const TyonSensorImage *image, TSensorStats *stats);
+
+    /**
+     * @brief Compute the statistics of a pixel buffer
+     * @param data Pixel values
+     * @param length Number of pixels
+     * @param stats Result
+     * @param path Instruction set, the best supported one if omitted
+     */
+    static void compute(const quint8 *data, qsizetype length, TSensorStats *stats);
+    static void compute(const quint8 *data, qsizetype length, TSensorStats *stats, TPath path);
+
+    /**
+     * @brief Return the best instruction set supported by this CPU
+     */
+    static TPath bestPath();
+
+    /**
+     * @brief Return the value at a percentile (nearest rank)
+     * @param stats Computed statistics
+     * @param percent 0-100
+     * @return Pixel value
+     */
+    static quint8 percentile(const TSensorStats &stats, uint percent);
+
+    /**
+     * @brief Return the value of the given metric, rounded to the device range
+     * @param stats Computed statistics
+     * @param metric Statistic to return
+     * @return Value 0-255
+     */
+    static quint8 metric(const TSensorStats &stats, TMetric metric);
+
+    /**
+     * @brief Convert metric name (mean, median, mode) to TMetric
+     * @param name Metric name from settings
+     * @return TMetric, MetricMean for unknown names
+     */
+    static TMetric metricFromName(const QString &name);
+};
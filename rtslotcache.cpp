@@ -0,0 +1,137 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtslotcache.h"
+#include <QHash>
+#include <QMutexLocker>
+#include <cstddef>
+
+RTSlotCache::RTSlotCache()
+    : m_mutex()
+    , m_slots()
+    , m_tick(0)
+    , m_stats()
+{
+    reset();
+}
+
+RTSlotCache::THash RTSlotCache::contentHash(const TyonProfileSettings &settings, const TyonProfileButtons &buttons)
+{
+    // skip report id, size and profile index, they depend on the slot
+    const quint8 *s = (const quint8 *) &settings.advanced_sensitivity;
+    const size_t slen = offsetof(TyonProfileSettings, checksum) - offsetof(TyonProfileSettings, advanced_sensitivity);
+
+    THash hash = qHashBits(s, slen, 0);
+    hash = qHashBits(buttons.buttons, sizeof(buttons.buttons), hash);
+
+    // 0 is reserved for unknown slot content
+    return (hash == 0 ? 1 : hash);
+}
+
+void RTSlotCache::reset()
+{
+    QMutexLocker lock(&m_mutex);
+    for (quint8 i = 0; i < TYON_PROFILE_NUM; i++) {
+        m_slots[i] = {0, 0};
+    }
+}
+
+void RTSlotCache::assign(quint8 slot, THash hash)
+{
+    if (slot >= TYON_PROFILE_NUM) {
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+
+    // same content in two slots, keep the newest one only
+    for (quint8 i = 0; i < TYON_PROFILE_NUM; i++) {
+        if (i != slot && m_slots[i].hash == hash) {
+            m_slots[i].hash = 0;
+        }
+    }
+
+    m_slots[slot].hash = hash;
+    m_slots[slot].tick = ++m_tick;
+}
+
+void RTSlotCache::invalidate(quint8 slot)
+{
+    if (slot >= TYON_PROFILE_NUM) {
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    m_slots[slot] = {0, 0};
+}
+
+void RTSlotCache::touch(quint8 slot)
+{
+    if (slot >= TYON_PROFILE_NUM) {
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    m_slots[slot].tick = ++m_tick;
+}
+
+int RTSlotCache::slotOf(THash hash) const
+{
+    if (hash == 0) {
+        return -1;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    for (quint8 i = 0; i < TYON_PROFILE_NUM; i++) {
+        if (m_slots[i].hash == hash) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int RTSlotCache::victim(quint32 pinned) const
+{
+    QMutexLocker lock(&m_mutex);
+
+    int slot = -1;
+    for (quint8 i = 0; i < TYON_PROFILE_NUM; i++) {
+        if (pinned & (1 << i)) {
+            continue;
+        }
+        // unknown content is always the cheapest choice
+        if (m_slots[i].hash == 0) {
+            return i;
+        }
+        if (slot < 0 || m_slots[i].tick < m_slots[slot].tick) {
+            slot = i;
+        }
+    }
+    return slot;
+}
+
+void RTSlotCache::count(bool hit)
+{
+    QMutexLocker lock(&m_mutex);
+    if (hit) {
+        m_stats.hits++;
+    } else {
+        m_stats.misses++;
+    }
+}
+
+void RTSlotCache::countPrefetch()
+{
+    QMutexLocker lock(&m_mutex);
+    m_stats.prefetches++;
+}
+
+RTSlotCache::TStatistics RTSlotCache::statistics() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,117 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rttypedefs.h"
+#include <QMutex>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The RTSlotCache class tracks which profile content currently sits
+ * in the 5 hardware profile slots of the ROCCAT Tyon. The slots are treated
+ * as a least recently used cache over a larger profile library.
+ */
+class RTSlotCache
+{
+public:
+    /**
+     * @brief Content hash of a profile, independent of its slot index
+     */
+    typedef size_t THash;
+
+    /**
+     * @brief Cache statistics
+     */
+    typedef struct
+    {
+        quint32 hits;       // switch served by a profile index write only
+        quint32 misses;     // switch required a slot overwrite
+        quint32 prefetches; // slots filled ahead of time
+    } TStatistics;
+
+    /**
+     * @brief Default constructor, all slots unknown
+     */
+    RTSlotCache();
+
+    /**
+     * @brief Calculate the content hash of profile settings and buttons
+     * @param settings Profile settings
+     * @param buttons Profile buttons
+     * @return Hash value, 0 is never returned
+     */
+    static THash contentHash(const TyonProfileSettings &settings, const TyonProfileButtons &buttons);
+
+    /**
+     * @brief Forget all slot assignments
+     */
+    void reset();
+
+    /**
+     * @brief Record the content of a device slot after it was read or written
+     * @param slot Slot index 0-4
+     * @param hash Content hash
+     */
+    void assign(quint8 slot, THash hash);
+
+    /**
+     * @brief Mark slot content as unknown
+     * @param slot Slot index 0-4
+     */
+    void invalidate(quint8 slot);
+
+    /**
+     * @brief Mark a slot as used right now
+     * @param slot Slot index 0-4
+     */
+    void touch(quint8 slot);
+
+    /**
+     * @brief Find the slot holding the given content
+     * @param hash Content hash
+     * @return Slot index or -1 if not resident
+     */
+    int slotOf(THash hash) const;
+
+    /**
+     * @brief Return the slot to overwrite next. Unknown slots first,
+     * then the least recently used one.
+     * @param pinned Bit mask of slots which must not be evicted (the
+     * active slot, slots with unsaved changes)
+     * @return Slot index 0-4 or -1 if all slots are pinned
+     */
+    int victim(quint32 pinned = 0) const;
+
+    /**
+     * @brief Count a switch as cache hit or miss
+     * @param hit True if the profile was resident
+     */
+    void count(bool hit);
+
+    /**
+     * @brief Count a prefetched slot
+     */
+    void countPrefetch();
+
+    /**
+     * @brief Return the cache statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+private:
+    typedef struct
+    {
+        THash hash;   // 0 = unknown content
+        quint64 tick; // last use, 0 = never
+    } TSlot;
+
+    mutable QMutex m_mutex;
+    TSlot m_slots[TYON_PROFILE_NUM];
+    quint64 m_tick;
+    TStatistics m_stats;
+};
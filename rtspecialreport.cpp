@@ -0,0 +1,154 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtspecialreport.h"
+
+bool RTSpecialReport::decode(const quint8 *data, qsizetype length, TSpecialEvent *event)
+{
+    if (length < (qsizetype) sizeof(TyonSpecial) || data[0] != TYON_REPORT_ID_SPECIAL) {
+        return false;
+    }
+
+    const TyonSpecial *p = (const TyonSpecial *) data;
+    *event = {};
+    event->raw = p->type;
+    event->pressed = (p->action == TYON_SPECIAL_ACTION_PRESS);
+
+    switch (p->type) {
+        case TYON_SPECIAL_TYPE_TILT: {
+            event->type = SpecialTilt;
+            event->value = (p->data == 0xff ? -1 : 1);
+            break;
+        }
+        case TYON_SPECIAL_TYPE_PROFILE: {
+            if (p->data < 1 || p->data > TYON_PROFILE_NUM) {
+                return false;
+            }
+            event->type = SpecialProfile;
+            event->value = p->data - 1;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_XCELERATOR: {
+            event->type = SpecialXCelerator;
+            event->value = p->data;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_QUICKLAUNCH: {
+            event->type = SpecialQuickLaunch;
+            event->value = p->data;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_TIMER_START: {
+            event->type = SpecialTimerStart;
+            event->value = p->data;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_TIMER_STOP: {
+            event->type = SpecialTimerStop;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_OPEN_DRIVER: {
+            /* press/release in data */
+            event->type = SpecialOpenDriver;
+            event->pressed = (p->data == TYON_SPECIAL_ACTION_PRESS);
+            break;
+        }
+        case TYON_SPECIAL_TYPE_CPI: {
+            if (p->data < 1 || p->data > TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM) {
+                return false;
+            }
+            event->type = SpecialCpi;
+            event->value = p->data - 1;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_SENSITIVITY: {
+            /* level in data, action is not used */
+            if (p->data < ROCCAT_SENSITIVITY_MIN || p->data > ROCCAT_SENSITIVITY_MAX) {
+                return false;
+            }
+            event->type = SpecialSensitivity;
+            event->value = p->data;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_ANALOGUE: {
+            event->type = SpecialAnalogue;
+            event->value = p->analogue;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_XCELERATOR_CALIBRATION: {
+            event->type = SpecialXCeleratorCalibration;
+            event->value = p->action;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_RAD_LEFT:
+        case TYON_SPECIAL_TYPE_RAD_RIGHT:
+        case TYON_SPECIAL_TYPE_RAD_MIDDLE:
+        case TYON_SPECIAL_TYPE_RAD_THUMB_BACKWARD:
+        case TYON_SPECIAL_TYPE_RAD_THUMB_FORWARD:
+        case TYON_SPECIAL_TYPE_RAD_SCROLL_UP:
+        case TYON_SPECIAL_TYPE_RAD_SCROLL_DOWN:
+        case TYON_SPECIAL_TYPE_RAD_EASYSHIFT:
+        case TYON_SPECIAL_TYPE_RAD_EASYAIM:
+        case TYON_SPECIAL_TYPE_RAD_DISTANCE: {
+            event->type = SpecialRadCounter;
+            event->index = p->type - TYON_SPECIAL_TYPE_RAD_LEFT;
+            event->value = p->data;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_MULTIMEDIA: {
+            event->type = SpecialMultimedia;
+            event->value = p->data;
+            break;
+        }
+        case TYON_SPECIAL_TYPE_TALK: {
+            event->type = SpecialTalk;
+            event->value = p->data;
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RTSpecialReport::changesState(TSpecialEventType type)
+{
+    switch (type) {
+        case SpecialProfile:
+        case SpecialCpi:
+        case SpecialSensitivity:
+        case SpecialTalk: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+const char *RTSpecialReport::name(TSpecialEventType type)
+{
+    static const char *const names[] = {
+        "none",
+        "tilt",
+        "profile",
+        "cpi",
+        "sensitivity",
+        "xcelerator",
+        "quicklaunch",
+        "timer-start",
+        "timer-stop",
+        "open-driver",
+        "analogue",
+        "xcelerator-calibration",
+        "rad-counter",
+        "multimedia",
+        "talk",
+    };
+    return ((uint) type < sizeof(names) / sizeof(names[0]) ? names[type] : "unknown");
+}
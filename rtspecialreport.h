@@ -0,0 +1,77 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rttypedefs.h"
+#include <QMetaType>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief Event types of the SPECIAL input report (TyonSpecial)
+ */
+typedef enum {
+    SpecialNone = 0,
+    SpecialTilt,                  // value: -1 left, +1 right
+    SpecialProfile,               // value: profile index 0-4
+    SpecialCpi,                   // value: DPI slot 0-4
+    SpecialSensitivity,           // value: RoccatSensitivity 1-11
+    SpecialXCelerator,            // value: paddle value, X-Celerator as shortcut
+    SpecialQuickLaunch,           // value: button index
+    SpecialTimerStart,            // value: button index
+    SpecialTimerStop,             //
+    SpecialOpenDriver,            //
+    SpecialAnalogue,              // value: paddle value
+    SpecialXCeleratorCalibration, // value: paddle value
+    SpecialRadCounter,            // index: TYON_SPECIAL_TYPE_RAD_* - RAD_LEFT, value: count
+    SpecialMultimedia,            // value: report data
+    SpecialTalk,                  // value: button type of the talk function
+} TSpecialEventType;
+
+/**
+ * @brief One decoded SPECIAL report
+ */
+typedef struct
+{
+    TSpecialEventType type;
+    quint8 raw;   // TyonSpecialType
+    int value;    // see TSpecialEventType
+    quint8 index; // sub index of counters
+    bool pressed; // press/release events, true on press
+} TSpecialEvent;
+
+Q_DECLARE_METATYPE(TSpecialEvent)
+
+/**
+ * @brief The RTSpecialReport class decodes the SPECIAL input reports the
+ * mouse sends when something changes on the device itself (profile and
+ * DPI buttons, sensitivity, talk functions, counters, the X-Celerator).
+ */
+class RTSpecialReport
+{
+public:
+    /**
+     * @brief Decode a SPECIAL report
+     * @param data Report including the report id
+     * @param length Report length
+     * @param event Receives the decoded event
+     * @return False if the report is too short, unknown or out of range
+     */
+    static bool decode(const quint8 *data, qsizetype length, TSpecialEvent *event);
+
+    /**
+     * @brief Return true if the event changes state kept by RTController
+     * (profile, DPI slot, sensitivity, talk functions)
+     * @param type Event type
+     */
+    static bool changesState(TSpecialEventType type);
+
+    /**
+     * @brief Return the event type name for logging
+     * @param type Event type
+     */
+    static const char *name(TSpecialEventType type);
+};
@@ -0,0 +1,152 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtstartupmetrics.h"
+#include <QCoreApplication>
+#include <QEvent>
+#include <QFile>
+#include <QSet>
+#include <QTimer>
+#ifdef Q_OS_LINUX
+#include <time.h>
+#include <unistd.h>
+#else
+#include <sys/resource.h>
+#endif
+
+QElapsedTimer RTStartupMetrics::m_clock;
+qint64 RTStartupMetrics::m_execToMain = -1;
+
+#ifdef Q_OS_LINUX
+// Process start time in ns since boot, field 22 of /proc/self/stat
+static inline qint64 processStartTime()
+{
+    QFile f(QStringLiteral("/proc/self/stat"));
+    if (!f.open(QFile::ReadOnly)) {
+        return -1;
+    }
+    const QByteArray stat = f.readAll();
+    // the command name may contain blanks, fields start after ')'
+    const QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+    if (fields.size() < 20) {
+        return -1;
+    }
+    const long hz = sysconf(_SC_CLK_TCK);
+    return fields.at(19).toLongLong() * (1000000000LL / hz);
+}
+
+// Value in kB of a /proc/self/status line
+static inline qint64 statusValue(const QByteArray &key)
+{
+    QFile f(QStringLiteral("/proc/self/status"));
+    if (!f.open(QFile::ReadOnly)) {
+        return -1;
+    }
+    for (const QByteArray &line : f.readAll().split('\n')) {
+        if (line.startsWith(key)) {
+            return line.mid(key.length()).trimmed().split(' ').first().toLongLong();
+        }
+    }
+    return -1;
+}
+
+// Number of distinct shared objects mapped into the process
+static inline int sharedObjects()
+{
+    QFile f(QStringLiteral("/proc/self/maps"));
+    if (!f.open(QFile::ReadOnly)) {
+        return -1;
+    }
+    QSet<QByteArray> libs;
+    for (const QByteArray &line : f.readAll().split('\n')) {
+        const qsizetype pos = line.indexOf('/');
+        if (pos > 0 && line.contains(".so")) {
+            libs.insert(line.mid(pos));
+        }
+    }
+    return libs.size();
+}
+#endif
+
+void RTStartupMetrics::start()
+{
+    m_clock.start();
+#ifdef Q_OS_LINUX
+    struct timespec ts = {};
+    const qint64 started = processStartTime();
+    if (started >= 0 && clock_gettime(CLOCK_BOOTTIME, &ts) == 0) {
+        m_execToMain = (ts.tv_sec * 1000000000LL + ts.tv_nsec) - started;
+    }
+#endif
+}
+
+bool RTStartupMetrics::isEnabled()
+{
+    return !qEnvironmentVariableIsEmpty("RT_STARTUP_METRICS");
+}
+
+void RTStartupMetrics::watch(QObject *window)
+{
+    if (!isEnabled() || !window) {
+        return;
+    }
+    window->installEventFilter(new RTStartupMetrics(window));
+}
+
+void RTStartupMetrics::mark(const char *milestone)
+{
+    // reconnects reach the same milestones again
+    static QSet<QByteArray> reached;
+    if (!isEnabled() || reached.contains(milestone)) {
+        return;
+    }
+    reached.insert(milestone);
+    qInfo("[APPWIN] Startup: main->%s %.2f ms", milestone, m_clock.nsecsElapsed() / 1000000.0);
+}
+
+RTStartupMetrics::RTStartupMetrics(QObject *parent)
+    : QObject(parent)
+    , m_painted(false)
+{}
+
+bool RTStartupMetrics::eventFilter(QObject *watched, QEvent *event)
+{
+    if (!m_painted && event->type() == QEvent::Paint) {
+        m_painted = true;
+        // report once the frame is finished, not while painting it
+        QTimer::singleShot(0, this, [this]() { report(); });
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+inline void RTStartupMetrics::report()
+{
+    const double firstFrame = m_clock.nsecsElapsed() / 1000000.0;
+    parent()->removeEventFilter(this);
+
+#ifdef Q_OS_LINUX
+    // process start time has clock tick resolution (usually 10ms)
+    qInfo("[APPWIN] Startup: exec->main %.2f ms, main->first frame %.2f ms", //
+          m_execToMain / 1000000.0,
+          firstFrame);
+    qInfo("[APPWIN] Startup: VmRSS %lld kB, VmHWM %lld kB, %d shared objects", //
+          statusValue("VmRSS:"),
+          statusValue("VmHWM:"),
+          sharedObjects());
+#else
+    struct rusage ru = {};
+    getrusage(RUSAGE_SELF, &ru);
+    qInfo("[APPWIN] Startup: main->first frame %.2f ms", firstFrame);
+    // ru_maxrss is in bytes on macOS
+    qInfo("[APPWIN] Startup: max RSS %ld kB", (long) (ru.ru_maxrss / 1024));
+#endif
+
+    if (qgetenv("RT_STARTUP_METRICS") == "exit") {
+        QCoreApplication::quit();
+    }
+    deleteLater();
+}
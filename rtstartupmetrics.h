@@ -0,0 +1,58 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QElapsedTimer>
+#include <QObject>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The RTStartupMetrics class measures the application startup.
+ * Enabled with the environment variable RT_STARTUP_METRICS=1, or
+ * RT_STARTUP_METRICS=exit to quit right after the report (benchmark runs).
+ * Reports process exec to main(), main() to the first paint of the main
+ * window, resident memory and the number of mapped shared libraries.
+ */
+class RTStartupMetrics : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Start the clock, call first thing in main()
+     */
+    static void start();
+
+    /**
+     * @brief Return true if the metrics are requested by environment
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Watch a top level widget for its first paint event
+     * @param window The main window
+     */
+    static void watch(QObject *window);
+
+    /**
+     * @brief Log the time from main() to a startup milestone, once
+     * @param milestone Name of the milestone
+     */
+    static void mark(const char *milestone);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    explicit RTStartupMetrics(QObject *parent);
+    inline void report();
+
+private:
+    static QElapsedTimer m_clock;
+    static qint64 m_execToMain;
+    bool m_painted;
+};
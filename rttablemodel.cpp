@@ -20,6 +20,13 @@ RTTableModel::RTTableModel(RTController *device, QObject *parent)
     Qt::ConnectionType ct = Qt::QueuedConnection;
     connect(m_device, &RTController::deviceFound, this, &RTTableModel::onDeviceFound, ct);
     connect(m_device, &RTController::deviceRemoved, this, &RTTableModel::onDeviceRemoved, ct);
+    connect(m_device, &RTController::profileSynced, this, &RTTableModel::onProfileSynced, ct);
+}
+
+void RTTableModel::onProfileSynced(quint8 pix)
+{
+    const QModelIndex i = index(pix);
+    emit dataChanged(i, i);
 }
 
 void RTTableModel::onDeviceFound()
@@ -127,5 +134,8 @@ Qt::ItemFlags RTTableModel::flags(const QModelIndex &index) const
 {
     if (!index.isValid())
         return Qt::NoItemFlags;
+    // holds defaults until read from the device
+    if (!m_device->isProfileSynced(index.row()))
+        return Qt::NoItemFlags;
     return QAbstractItemModel::flags(index) | Qt::ItemIsEditable;
 }
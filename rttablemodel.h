@@ -42,6 +42,7 @@ public:
 private slots:
     void onDeviceFound();
     void onDeviceRemoved();
+    void onProfileSynced(quint8 pix);
 
 private:
     RTController *m_device;
@@ -0,0 +1,342 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rttalkfxengine.h"
+#include "rtlatency.h"
+#include "rttypedefs.h"
+#include <QFile>
+#include <QSettings>
+#include <errno.h>
+#include <time.h>
+
+/* CPU load is sampled at most this often, /proc/stat counts in 10 ms */
+#define RT_TALKFX_CPU_SAMPLE_MS 100
+
+static inline void sleepUntil(qint64 deadline)
+{
+#ifdef Q_OS_LINUX
+    struct timespec ts;
+    ts.tv_sec = deadline / 1000000000LL;
+    ts.tv_nsec = deadline % 1000000000LL;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    const qint64 ns = deadline - RTLatency::monotonicNs();
+    if (ns > 0) {
+        QThread::usleep(ns / 1000);
+    }
+#endif
+}
+
+static inline bool sameFrame(const RTTalkFxEngine::TFrame &a, const RTTalkFxEngine::TFrame &b)
+{
+    return a.effect == b.effect && a.ambientColor == b.ambientColor && a.eventColor == b.eventColor;
+}
+
+RTTalkFxEngine::TConfig RTTalkFxEngine::defaultConfig()
+{
+    TConfig config = {};
+    config.source = CpuLoad;
+    config.fps = 20;
+    config.maxWrites = 10;
+    config.steps = 16;
+    config.lowColor = 0x00ff00;
+    config.highColor = 0xff0000;
+    config.eventColor = 0xffffff;
+    return config;
+}
+
+bool RTTalkFxEngine::loadConfig(QSettings *settings, TConfig *config)
+{
+    *config = defaultConfig();
+    settings->beginGroup("talkfx");
+    const bool enabled = settings->value("enabled", false).toBool();
+    const QString source = settings->value("source", "cpu").toString();
+    if (source == QStringLiteral("external")) {
+        config->source = External;
+    } else if (source == QStringLiteral("events")) {
+        config->source = Events;
+    } else {
+        config->source = CpuLoad;
+    }
+    config->fps = qBound(1, settings->value("fps", config->fps).toInt(), (int) MaxFps);
+    config->maxWrites = qBound(1, settings->value("maxWrites", config->maxWrites).toInt(), config->fps);
+    config->steps = qBound(2, settings->value("steps", config->steps).toInt(), 256);
+    config->lowColor = colorValue(settings->value("lowColor").toString(), config->lowColor);
+    config->highColor = colorValue(settings->value("highColor").toString(), config->highColor);
+    config->eventColor = colorValue(settings->value("eventColor").toString(), config->eventColor);
+    settings->endGroup();
+    return enabled;
+}
+
+quint32 RTTalkFxEngine::colorValue(const QString &text, quint32 fallback)
+{
+    bool ok;
+    QString hex = text.trimmed();
+    if (hex.startsWith('#')) {
+        hex.remove(0, 1);
+    }
+    const quint32 color = hex.toUInt(&ok, 16);
+    return (ok && hex.length() == 6 ? color : fallback);
+}
+
+RTTalkFxEngine::RTTalkFxEngine(QObject *parent)
+    : QThread(parent)
+    , m_config(defaultConfig())
+    , m_writer()
+    , m_metricsLog(qEnvironmentVariableIntValue("RT_TALKFX_METRICS") > 0)
+    , m_level(0)
+    , m_event(0)
+    , m_eventColor(0)
+    , m_cpuBusy(0)
+    , m_cpuTotal(0)
+    , m_startNs(0)
+    , m_stopNs(0)
+    , m_ticks(0)
+    , m_late(0)
+    , m_writes(0)
+    , m_suppressed(0)
+    , m_capped(0)
+    , m_busy(0)
+    , m_failures(0)
+{}
+
+RTTalkFxEngine::~RTTalkFxEngine()
+{
+    close();
+}
+
+bool RTTalkFxEngine::open(const TConfig &config, const TWriter &writer, QString *error)
+{
+    close();
+
+    m_config = config;
+    m_config.fps = qBound(1, m_config.fps, (int) MaxFps);
+    m_config.maxWrites = qBound(1, m_config.maxWrites, m_config.fps);
+    m_config.steps = qMax(2, m_config.steps);
+
+    m_cpuBusy = 0;
+    m_cpuTotal = 0;
+    if (m_config.source == CpuLoad && sampleCpuLoad() < 0) {
+        *error = QStringLiteral("The CPU load source needs Linux /proc/stat.");
+        return false;
+    }
+
+    m_writer = writer;
+    m_eventColor.storeRelaxed(m_config.eventColor);
+    m_startNs.storeRelaxed(0);
+    m_stopNs.storeRelaxed(0);
+    m_ticks.storeRelaxed(0);
+    m_late.storeRelaxed(0);
+    m_writes.storeRelaxed(0);
+    m_suppressed.storeRelaxed(0);
+    m_capped.storeRelaxed(0);
+    m_busy.storeRelaxed(0);
+    m_failures.storeRelaxed(0);
+
+    qInfo("[TALKFX] %d fps, at most %d writes/s", m_config.fps, m_config.maxWrites);
+
+    // lighting yields to the GUI and the device threads, late ticks are counted
+    start(QThread::LowPriority);
+    return true;
+}
+
+void RTTalkFxEngine::close()
+{
+    if (isRunning()) {
+        // the tick in progress ends within one frame period
+        requestInterruption();
+        wait();
+    }
+}
+
+void RTTalkFxEngine::setLevel(int level)
+{
+    m_level.storeRelaxed(qBound(0, level, (int) LevelMax));
+}
+
+void RTTalkFxEngine::setEvent(bool active)
+{
+    m_event.storeRelaxed(active ? 1 : 0);
+}
+
+void RTTalkFxEngine::setEventColor(quint32 color)
+{
+    m_eventColor.storeRelaxed(color & 0xffffff);
+}
+
+inline int RTTalkFxEngine::sampleCpuLoad()
+{
+#ifdef Q_OS_LINUX
+    QFile f(QStringLiteral("/proc/stat"));
+    if (!f.open(QFile::ReadOnly)) {
+        return -1;
+    }
+    // cpu user nice system idle iowait irq softirq steal
+    const QList<QByteArray> fields = f.readLine().simplified().split(' ');
+    if (fields.size() < 8 || fields[0] != "cpu") {
+        return -1;
+    }
+    quint64 total = 0;
+    for (int i = 1; i < fields.size() && i <= 8; i++) {
+        total += fields[i].toULongLong();
+    }
+    const quint64 busy = total - fields[4].toULongLong() - fields[5].toULongLong();
+
+    const quint64 dTotal = total - m_cpuTotal;
+    const quint64 dBusy = busy - m_cpuBusy;
+    m_cpuTotal = total;
+    m_cpuBusy = busy;
+    return (dTotal > 0 ? (int) (dBusy * LevelMax / dTotal) : 0);
+#else
+    return -1;
+#endif
+}
+
+inline RTTalkFxEngine::TFrame RTTalkFxEngine::render(int level, bool event) const
+{
+    // quantized, so small level changes give the same frame
+    const int steps = m_config.steps - 1;
+    const int step = (level * steps + LevelMax / 2) / LevelMax;
+
+    quint32 ambient = 0;
+    for (int shift = 0; shift < 24; shift += 8) {
+        const int lo = (m_config.lowColor >> shift) & 0xff;
+        const int hi = (m_config.highColor >> shift) & 0xff;
+        ambient |= (quint32) (lo + (hi - lo) * step / steps) << shift;
+    }
+
+    TFrame frame = {};
+    if (m_config.source == Events && !event) {
+        return frame;
+    }
+    frame.ambientColor = ambient;
+    frame.eventColor = m_eventColor.loadRelaxed();
+    if (event) {
+        frame.effect = (ROCCAT_TALKFX_ZONE_EVENT << ROCCAT_TALKFX_ZONE_BIT_SHIFT) //
+                       | (ROCCAT_TALKFX_EFFECT_BLINKING << ROCCAT_TALKFX_EFFECT_BIT_SHIFT) //
+                       | (ROCCAT_TALKFX_SPEED_FAST << ROCCAT_TALKFX_SPEED_BIT_SHIFT);
+    } else {
+        frame.effect = (ROCCAT_TALKFX_ZONE_AMBIENT << ROCCAT_TALKFX_ZONE_BIT_SHIFT) //
+                       | (ROCCAT_TALKFX_EFFECT_ON << ROCCAT_TALKFX_EFFECT_BIT_SHIFT) //
+                       | (ROCCAT_TALKFX_SPEED_NORMAL << ROCCAT_TALKFX_SPEED_BIT_SHIFT);
+    }
+    return frame;
+}
+
+void RTTalkFxEngine::run()
+{
+    const qint64 period = 1000000000LL / m_config.fps;
+    const qint64 minWrite = 1000000000LL / m_config.maxWrites;
+    const qint64 cpuSample = RT_TALKFX_CPU_SAMPLE_MS * 1000000LL;
+
+    qint64 next = RTLatency::monotonicNs();
+    qint64 lastWrite = next - minWrite;
+    qint64 sampledAt = next;
+    int level = 0;
+    TFrame sent = {};
+    bool hasSent = false;
+    m_startNs.storeRelaxed(next);
+
+    while (!isInterruptionRequested()) {
+        // absolute deadlines, a late frame does not shift the ones after it
+        next += period;
+        qint64 now = RTLatency::monotonicNs();
+        if (now - next >= period) {
+            const qint64 missed = (now - next) / period;
+            m_late.fetchAndAddRelaxed(missed);
+            next += missed * period;
+        }
+        sleepUntil(next);
+        if (isInterruptionRequested()) {
+            break;
+        }
+
+        const quint64 ticks = m_ticks.fetchAndAddRelaxed(1) + 1;
+        now = RTLatency::monotonicNs();
+        if (m_config.source == CpuLoad) {
+            if (now - sampledAt >= cpuSample) {
+                level = (level * 3 + qMax(0, sampleCpuLoad())) / 4;
+                sampledAt = now;
+            }
+        } else {
+            level = m_level.loadRelaxed();
+        }
+
+        if (m_metricsLog && ticks % (m_config.fps * 10) == 0) {
+            logStatistics();
+        }
+
+        const TFrame frame = render(level, m_event.loadRelaxed() != 0);
+        if (hasSent && sameFrame(frame, sent)) {
+            m_suppressed.fetchAndAddRelaxed(1);
+            continue;
+        }
+        // a held back frame is replaced by the next one, the newest is written
+        if (now - lastWrite < minWrite) {
+            m_capped.fetchAndAddRelaxed(1);
+            continue;
+        }
+        switch (m_writer(&frame)) {
+            case Written: {
+                sent = frame;
+                hasSent = true;
+                lastWrite = now;
+                m_writes.fetchAndAddRelaxed(1);
+                break;
+            }
+            case Busy: {
+                m_busy.fetchAndAddRelaxed(1);
+                break;
+            }
+            default: {
+                // back off like a written frame, do not hammer a failing device
+                lastWrite = now;
+                m_failures.fetchAndAddRelaxed(1);
+                break;
+            }
+        }
+    }
+
+    m_stopNs.storeRelaxed(RTLatency::monotonicNs());
+    if (hasSent && m_writer(nullptr) != Written) {
+        qWarning("[TALKFX] Switching TalkFX off failed");
+    }
+}
+
+RTTalkFxEngine::TStatistics RTTalkFxEngine::statistics() const
+{
+    TStatistics stats = {};
+    stats.ticks = m_ticks.loadRelaxed();
+    stats.late = m_late.loadRelaxed();
+    stats.writes = m_writes.loadRelaxed();
+    stats.suppressed = m_suppressed.loadRelaxed();
+    stats.capped = m_capped.loadRelaxed();
+    stats.busy = m_busy.loadRelaxed();
+    stats.failures = m_failures.loadRelaxed();
+
+    const qint64 start = m_startNs.loadRelaxed();
+    const qint64 stop = m_stopNs.loadRelaxed();
+    const qint64 end = (stop > start ? stop : RTLatency::monotonicNs());
+    if (start > 0 && end > start) {
+        stats.fps = stats.ticks * 1e9 / (end - start);
+        stats.writeRate = stats.writes * 1e9 / (end - start);
+    }
+    return stats;
+}
+
+inline void RTTalkFxEngine::logStatistics() const
+{
+    const TStatistics s = statistics();
+    qInfo("[TALKFX] %.1f fps, %.1f writes/s, suppressed %llu, capped %llu, busy %llu, late %llu", //
+          s.fps,
+          s.writeRate,
+          (unsigned long long) s.suppressed,
+          (unsigned long long) s.capped,
+          (unsigned long long) s.busy,
+          (unsigned long long) s.late);
+}
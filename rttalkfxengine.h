@@ -0,0 +1,188 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QAtomicInteger>
+#include <QThread>
+#include <QtCore/QtGlobal>
+#include <functional>
+
+class QSettings;
+
+/**
+ * @brief The RTTalkFxEngine thread drives the TalkFX lights of the mouse
+ * from the host. On a fixed-rate tick it renders a frame from a level
+ * (CPU load or set by another program) and an event flag, drops frames
+ * equal to the last one written and keeps the writes below a rate cap.
+ * Each write is offered to the controller, which skips it while other
+ * device I/O runs; the frame is retried on the next tick.
+ */
+class RTTalkFxEngine : public QThread
+{
+    Q_OBJECT
+
+public:
+    enum TSource {
+        External = 0, // level and event set with setLevel() / setEvent()
+        CpuLoad,      // level follows the CPU load (Linux /proc/stat)
+        Events,       // event flashes only, profile lights in between
+        SourceCount,
+    };
+
+    enum TWrite {
+        Written = 0, // frame is on the device
+        Busy,        // device busy with other I/O, try again
+        Failed,      // write failed
+    };
+
+    enum {
+        LevelMax = 1000, // full scale of the level
+        MaxFps = 60,
+    };
+
+    /**
+     * @brief One TalkFX frame, fields as taken by the talk report. A frame
+     * with effect 0 returns the lights to the profile.
+     */
+    typedef struct
+    {
+        quint32 effect;       // ROCCAT_TALKFX zone, effect and speed bits
+        quint32 ambientColor; // 0xRRGGBB
+        quint32 eventColor;   // 0xRRGGBB
+    } TFrame;
+
+    /**
+     * @brief Engine configuration
+     */
+    typedef struct
+    {
+        TSource source;     // where the level comes from
+        int fps;            // frames rendered per second
+        int maxWrites;      // reports written per second at most
+        int steps;          // color steps between level 0 and LevelMax
+        quint32 lowColor;   // ambient color at level 0
+        quint32 highColor;  // ambient color at LevelMax
+        quint32 eventColor; // blinking color while the event is set
+    } TConfig;
+
+    /**
+     * @brief Engine statistics
+     */
+    typedef struct
+    {
+        quint64 ticks;      // frames rendered
+        quint64 late;       // ticks skipped because a frame ran late
+        quint64 writes;     // reports written
+        quint64 suppressed; // frames equal to the last written one
+        quint64 capped;     // changed frames held back by the rate cap
+        quint64 busy;       // changed frames deferred for other device I/O
+        quint64 failures;   // failed writes
+        double fps;         // achieved frames per second
+        double writeRate;   // reports per second
+    } TStatistics;
+
+    /**
+     * @brief Called on the engine thread for each changed frame, nullptr
+     * switches TalkFX off and returns the lights to the profile
+     */
+    typedef std::function<TWrite(const TFrame *frame)> TWriter;
+
+    /**
+     * @brief Return the defaults: CPU load, green to red, 20 fps, at most
+     * 10 writes per second
+     * @return TConfig structure
+     */
+    static TConfig defaultConfig();
+
+    /**
+     * @brief Read the [talkfx] group of the settings
+     * @param settings Application settings
+     * @param config Receives the configuration
+     * @return True if the engine is enabled
+     */
+    static bool loadConfig(QSettings *settings, TConfig *config);
+
+    /**
+     * @brief Parse a settings color
+     * @param text #RRGGBB or RRGGBB
+     * @param fallback Returned if the text is no color
+     * @return 0xRRGGBB
+     */
+    static quint32 colorValue(const QString &text, quint32 fallback);
+
+    explicit RTTalkFxEngine(QObject *parent = nullptr);
+
+    /**
+     * @brief Stop the thread
+     */
+    ~RTTalkFxEngine();
+
+    /**
+     * @brief Start the engine thread
+     * @param config Source, rates and colors
+     * @param writer Writes the frames on the engine thread
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(const TConfig &config, const TWriter &writer, QString *error);
+
+    /**
+     * @brief Stop the thread and switch TalkFX off
+     */
+    void close();
+
+    /**
+     * @brief Set the level of the External source, thread safe
+     * @param level 0 to LevelMax
+     */
+    void setLevel(int level);
+
+    /**
+     * @brief Blink the event color while set, thread safe
+     * @param active True to blink
+     */
+    void setEvent(bool active);
+
+    /**
+     * @brief Set the color of the following event flashes, thread safe
+     * @param color 0xRRGGBB
+     */
+    void setEventColor(quint32 color);
+
+    /**
+     * @brief Return the engine statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+protected:
+    void run() override;
+
+private:
+    TConfig m_config;
+    TWriter m_writer;
+    bool m_metricsLog;
+    QAtomicInteger<int> m_level;
+    QAtomicInteger<int> m_event;
+    QAtomicInteger<quint32> m_eventColor;
+    quint64 m_cpuBusy;
+    quint64 m_cpuTotal;
+    QAtomicInteger<qint64> m_startNs;
+    QAtomicInteger<qint64> m_stopNs;
+    QAtomicInteger<quint64> m_ticks;
+    QAtomicInteger<quint64> m_late;
+    QAtomicInteger<quint64> m_writes;
+    QAtomicInteger<quint64> m_suppressed;
+    QAtomicInteger<quint64> m_capped;
+    QAtomicInteger<quint64> m_busy;
+    QAtomicInteger<quint64> m_failures;
+
+private:
+    inline int sampleCpuLoad();
+    inline TFrame render(int level, bool event) const;
+    inline void logStatistics() const;
+};
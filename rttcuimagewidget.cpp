@@ -9,21 +9,61 @@
 #include <QPainter>
 #include <QStyleOption>
 
+// Anzahl paintEvent je Ausgabe der Zeitmessung
+#define TCU_PAINT_METRICS_FRAMES 100
+
 RTTcuImageWidget::RTTcuImageWidget(QWidget *parent)
     : QWidget(parent)
     , m_margin(4)
     , m_pixelSize(4)
     , m_pixelColor(Qt::black)
-    , m_imageSize(0)
+    , m_smoothScaling(false)
+    , m_colorTable()
+    , m_image()
+    , m_pixmap()
+    , m_metrics(!qEnvironmentVariableIsEmpty("RT_PAINT_METRICS"))
+    , m_paintClock()
+    , m_paintTime(0)
+    , m_paintCount(0)
 {
     setAttribute(Qt::WA_OpaquePaintEvent);
+    updateColorTable();
 }
 
 // Daten setzen
 void RTTcuImageWidget::setImageData(const QVector<quint8> &data, int size)
 {
-    m_imageData = data;
-    m_imageSize = size;
+    if (data.size() < size * size) {
+        qWarning("[TCUIMG] setImageData(): %lld bytes for %dx%d image", (long long) data.size(), size, size);
+        return;
+    }
+    setImageData(data.constData(), size);
+}
+
+void RTTcuImageWidget::setImageData(const quint8 *data, int size)
+{
+    if (!data || size <= 0) {
+        m_image = QImage();
+        m_pixmap = QPixmap();
+        update();
+        return;
+    }
+
+    if (m_image.width() != size || m_image.height() != size) {
+        m_image = QImage(size, size, QImage::Format_Indexed8);
+        m_image.setColorTable(m_colorTable);
+    }
+
+    // Sensorbild ist horizontal gespiegelt
+    for (int y = 0; y < size; ++y) {
+        const quint8 *src = data + y * size;
+        uchar *dst = m_image.scanLine(y);
+        for (int x = 0; x < size; ++x) {
+            dst[x] = src[size - 1 - x];
+        }
+    }
+
+    updatePixmap();
     update();
 }
 
@@ -50,15 +90,50 @@ void RTTcuImageWidget::setPixelColor(const QColor &color)
 {
     if (m_pixelColor != color) {
         m_pixelColor = color;
+        updateColorTable();
+        updatePixmap();
         emit pixelColorChanged(m_pixelColor);
         update();
     }
 }
 
+void RTTcuImageWidget::setSmoothScaling(bool smooth)
+{
+    if (m_smoothScaling != smooth) {
+        m_smoothScaling = smooth;
+        emit smoothScalingChanged(m_smoothScaling);
+        update();
+    }
+}
+
+inline void RTTcuImageWidget::updateColorTable()
+{
+    // Sensorwert -> Grauwert, Alpha aus der Pixelfarbe
+    const int alpha = m_pixelColor.alpha();
+    m_colorTable.resize(256);
+    for (int i = 0; i < 256; i++) {
+        const int grey = qMin(i * 4 + 24, 255);
+        m_colorTable[i] = qRgba(grey, grey, grey, alpha);
+    }
+    if (!m_image.isNull()) {
+        m_image.setColorTable(m_colorTable);
+    }
+}
+
+inline void RTTcuImageWidget::updatePixmap()
+{
+    // einmal je Bild konvertieren, paintEvent skaliert nur noch
+    m_pixmap = (m_image.isNull() ? QPixmap() : QPixmap::fromImage(m_image));
+}
+
 void RTTcuImageWidget::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
 
+    if (m_metrics) {
+        m_paintClock.start();
+    }
+
     QPainter painter(this);
 
     QStyleOption opt;
@@ -70,38 +145,27 @@ void RTTcuImageWidget::paintEvent(QPaintEvent *event)
 
     style()->drawPrimitive(QStyle::PE_Widget, &opt, &painter, this);
 
-    if (m_imageData.isEmpty() || m_imageSize == 0)
+    if (m_pixmap.isNull())
         return;
 
     // Zeichenbereich
-    QRect area = rect().adjusted(m_margin, m_margin, -m_margin, -m_margin);
-
-    for (int l = rect().y(); l < (rect().y() + rect().height() - m_margin); l++) {
-        area.moveTo(rect().x() + m_margin, area.y() + m_pixelSize);
-
-        for (int x = 0; x < m_imageSize; ++x) {
-            for (int y = 0; y < m_imageSize; ++y) {
-                int idx = y * m_imageSize + (m_imageSize - 1 - x);
-                if (idx < 0 || idx >= m_imageData.size())
-                    continue;
-
-                quint16 color_value = m_imageData[idx];
-                color_value = (color_value * 4 + 24) * 256;
-                if (color_value > 65535)
-                    color_value = 65535;
-
-                QColor c = m_pixelColor;
-                c.setRed(color_value >> 8);
-                c.setGreen(color_value >> 8);
-                c.setBlue(color_value >> 8);
-
-                QRect pixelRect(area.left() + x * m_pixelSize, //
-                                area.top() + y * m_pixelSize,
-                                m_pixelSize,
-                                m_pixelSize);
-
-                painter.fillRect(pixelRect, c);
-            }
+    const QRect area = rect().adjusted(m_margin, m_margin, -m_margin, -m_margin);
+    QRect target = area;
+    if (m_pixelSize > 0) {
+        target.setSize(m_pixmap.size() * m_pixelSize);
+        target = target.intersected(area);
+    }
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_smoothScaling);
+    painter.drawPixmap(target, m_pixmap);
+
+    if (m_metrics) {
+        painter.end();
+        m_paintTime += m_paintClock.nsecsElapsed();
+        if (++m_paintCount >= TCU_PAINT_METRICS_FRAMES) {
+            qInfo("[TCUIMG] paintEvent: %d frames, avg %.1f us", m_paintCount, m_paintTime / 1000.0 / m_paintCount);
+            m_paintTime = 0;
+            m_paintCount = 0;
         }
     }
 }
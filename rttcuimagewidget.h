@@ -8,6 +8,9 @@
 #pragma once
 
 #include <QColor>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPixmap>
 #include <QVector>
 #include <QWidget>
 
@@ -17,12 +20,14 @@ class RTTcuImageWidget : public QWidget
     Q_PROPERTY(int margin READ margin WRITE setMargin NOTIFY marginChanged)
     Q_PROPERTY(int pixelSize READ pixelSize WRITE setPixelSize NOTIFY pixelSizeChanged)
     Q_PROPERTY(QColor pixelColor READ pixelColor WRITE setPixelColor NOTIFY pixelColorChanged)
+    Q_PROPERTY(bool smoothScaling READ smoothScaling WRITE setSmoothScaling NOTIFY smoothScalingChanged)
 
 public:
     explicit RTTcuImageWidget(QWidget *parent = nullptr);
 
-    // Datenübergabe: Sensorbild setzen
+    // Datenübergabe: Sensorbild setzen (size = Breite/Höhe)
     void setImageData(const QVector<quint8> &data, int size);
+    void setImageData(const quint8 *data, int size);
 
     // Getter/Setter
     int margin() const { return m_margin; }
@@ -34,18 +39,32 @@ public:
     QColor pixelColor() const { return m_pixelColor; }
     void setPixelColor(const QColor &color);
 
+    bool smoothScaling() const { return m_smoothScaling; }
+    void setSmoothScaling(bool smooth);
+
 signals:
     void marginChanged(int);
     void pixelSizeChanged(int);
     void pixelColorChanged(const QColor &);
+    void smoothScalingChanged(bool);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
 
+private:
+    inline void updateColorTable();
+    inline void updatePixmap();
+
 private:
     int m_margin;                // Innenabstand vom Rand
-    int m_pixelSize;             // Größe eines Pixels
+    int m_pixelSize;             // Größe eines Pixels, 0 = Fläche füllen
     QColor m_pixelColor;         // Basisfarbe für Pixel
-    QVector<quint8> m_imageData; // Bilddaten (1D-Array)
-    int m_imageSize;             // Breite/Höhe (quadratisch)
+    bool m_smoothScaling;        // Bilineare statt Nearest-Skalierung
+    QList<QRgb> m_colorTable;    // Sensorwert -> Farbe (256 Einträge)
+    QImage m_image;              // Sensorbild (Indexed8)
+    QPixmap m_pixmap;            // Sensorbild für paintEvent
+    bool m_metrics;              // RT_PAINT_METRICS gesetzt
+    QElapsedTimer m_paintClock;  // Zeitmessung paintEvent
+    qint64 m_paintTime;          // Summe ns seit letzter Ausgabe
+    int m_paintCount;            // Anzahl paintEvent seit letzter Ausgabe
 };
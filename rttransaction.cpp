@@ -0,0 +1,107 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rttransaction.h"
+
+RTTransaction::RTTransaction()
+    : m_steps()
+    , m_idle(false)
+{}
+
+void RTTransaction::select(quint8 value, quint8 request)
+{
+    RoccatControl control = {};
+    control.report_id = TYON_REPORT_ID_CONTROL;
+    control.value = value;
+    control.request = request;
+
+    TTransactionStep s;
+    s.kind = Select;
+    s.rid = TYON_REPORT_ID_CONTROL;
+    s.data = QByteArray((const char *) &control, sizeof(RoccatControl));
+    s.ok = false;
+    m_steps.append(s);
+}
+
+void RTTransaction::write(const void *report, qsizetype length)
+{
+    TTransactionStep s;
+    s.kind = Write;
+    s.rid = ((const quint8 *) report)[0];
+    s.data = QByteArray((const char *) report, length);
+    s.ok = false;
+    m_steps.append(s);
+}
+
+void RTTransaction::read(quint8 rid, qsizetype length)
+{
+    TTransactionStep s;
+    s.kind = Read;
+    s.rid = rid;
+    s.data = QByteArray(length, '\0');
+    s.data[0] = (char) rid;
+    s.ok = false;
+    m_steps.append(s);
+}
+
+void RTTransaction::readProfile(quint8 pix, bool withButtons)
+{
+    select(TYON_CONTROL_DATA_INDEX_NONE | pix, TYON_CONTROL_REQUEST_PROFILE_SETTINGS);
+    read(TYON_REPORT_ID_PROFILE_SETTINGS, sizeof(TyonProfileSettings));
+    if (withButtons) {
+        select(TYON_CONTROL_DATA_INDEX_NONE | pix, TYON_CONTROL_REQUEST_PROFILE_BUTTONS);
+        read(TYON_REPORT_ID_PROFILE_BUTTONS, sizeof(TyonProfileButtons));
+    }
+}
+
+bool RTTransaction::needsCheck(int i) const
+{
+    if (i == 0) {
+        return !m_idle;
+    }
+    // a stored report keeps the device busy, roccat_select() checks after a select as well
+    return m_steps.at(i - 1).kind != Read;
+}
+
+bool RTTransaction::isComplete() const
+{
+    for (const TTransactionStep &s : m_steps) {
+        if (!s.ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RTTransaction::TStatistics RTTransaction::plan() const
+{
+    TStatistics s = {};
+    s.transactions = 1;
+    s.reports = m_steps.count();
+    for (int i = 0; i < m_steps.count(); i++) {
+        if (needsCheck(i)) {
+            s.checks++;
+        }
+        // the former sequence checked before every select and write
+        s.legacy += (m_steps.at(i).kind == Read ? 1 : 2);
+    }
+    // and read the control state before a sequence of reads
+    if (!m_idle && !m_steps.isEmpty() && m_steps.first().kind == Read) {
+        s.legacy++;
+    }
+    return s;
+}
+
+void RTTransaction::add(TStatistics *total, const TStatistics &s)
+{
+    total->transactions += s.transactions;
+    total->checks += s.checks;
+    total->reports += s.reports;
+    total->legacy += s.legacy;
+    total->speculative += s.speculative;
+    total->retries += s.retries;
+}
@@ -0,0 +1,141 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rttypedefs.h"
+#include <QByteArray>
+#include <QList>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief One HID report of a transaction script
+ */
+typedef struct
+{
+    quint8 kind;     // RTTransaction::TKind
+    quint8 rid;      // report identifier
+    QByteArray data; // report to send, or the report read
+    bool ok;         // set by the executor, true if executed
+} TTransactionStep;
+
+/**
+ * @brief The RTTransaction class is a script of HID reports sent to the
+ * device as one sequence. The device answers BUSY while it stores a
+ * written report and, as roccat_select() of roccat-tools expects, after a
+ * select; a read changes nothing. The control status is therefore checked
+ * at the start and after each write or select, not before a read. The
+ * script runs in RTController::runTransaction().
+ */
+class RTTransaction
+{
+public:
+    enum TKind {
+        Select = 0, // control report, selects the store of the next read
+        Write,      // report stored by the device, BUSY until done
+        Read,       // feature report read
+    };
+
+    /**
+     * @brief Round trips of executed scripts
+     */
+    typedef struct
+    {
+        quint32 transactions; // scripts executed
+        quint32 checks;       // control status reads
+        quint32 reports;      // selects, writes and reads
+        quint32 legacy;       // round trips with a check before every select and write
+        quint32 speculative;  // single writes without the check before
+        quint32 retries;      // speculative writes repeated with checks
+    } TStatistics;
+
+    /**
+     * @brief Default constructor, empty script
+     */
+    RTTransaction();
+
+    /**
+     * @brief Skip the initial status check. Only valid while a status OK
+     * is fresh and nothing was written since, set by the executor under
+     * its scheduler step.
+     * @param idle True or False
+     */
+    inline void assumeIdle(bool idle = true) { m_idle = idle; }
+
+    /**
+     * @brief Append a control select
+     * @param value Data index, e.g. the profile index
+     * @param request TYON_CONTROL_REQUEST_* value
+     */
+    void select(quint8 value, quint8 request);
+
+    /**
+     * @brief Append a report write, the first byte is the report id
+     * @param report Report buffer
+     * @param length Report length
+     */
+    void write(const void *report, qsizetype length);
+
+    /**
+     * @brief Append a report read
+     * @param rid Report identifier
+     * @param length Report length
+     */
+    void read(quint8 rid, qsizetype length);
+
+    /**
+     * @brief Append select and read of the settings and buttons of a profile
+     * @param pix Profile index 0-4
+     * @param withButtons False to read the settings only
+     */
+    void readProfile(quint8 pix, bool withButtons = true);
+
+    /**
+     * @brief Return the number of steps
+     */
+    inline int count() const { return m_steps.count(); }
+
+    /**
+     * @brief Return a step
+     * @param i Step index
+     */
+    inline const TTransactionStep &at(int i) const { return m_steps.at(i); }
+
+    /**
+     * @brief Return a step for the executor
+     * @param i Step index
+     */
+    inline TTransactionStep &step(int i) { return m_steps[i]; }
+
+    /**
+     * @brief Return true if the control status must be checked before a step
+     * @param i Step index
+     */
+    bool needsCheck(int i) const;
+
+    /**
+     * @brief Return true if all steps are executed
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief Return the round trips of this script and of the former
+     * sequence with a status check before every select and write
+     * @return TStatistics structure of one transaction
+     */
+    TStatistics plan() const;
+
+    /**
+     * @brief Sum statistics
+     * @param total Accumulated statistics
+     * @param s Statistics to add
+     */
+    static void add(TStatistics *total, const TStatistics &s);
+
+private:
+    QList<TTransactionStep> m_steps;
+    bool m_idle;
+};
@@ -565,7 +565,7 @@ typedef enum {
     TYON_SPECIAL_TYPE_TIMER_STOP = 0x90,             /* action: press/release */
     TYON_SPECIAL_TYPE_OPEN_DRIVER = 0xa0,            /* data: press/release ! */
     TYON_SPECIAL_TYPE_CPI = 0xb0,                    /* data: 1-5 */
-    TYON_SPECIAL_TYPE_SENSITIVITY = 0xc0,            /* data: action: 1-b */
+    TYON_SPECIAL_TYPE_SENSITIVITY = 0xc0,            /* data: 1-b, X and Y */
     TYON_SPECIAL_TYPE_ANALOGUE = 0xd1,               /* analogue: value, data: 0x00, action: 0x10 */
     TYON_SPECIAL_TYPE_XCELERATOR_CALIBRATION = 0xe0, /* data: 0x06, action: value */
     TYON_SPECIAL_TYPE_RAD_LEFT = 0xe1,               /* all rads: data: count */
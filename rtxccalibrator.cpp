@@ -0,0 +1,226 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtxccalibrator.h"
+#include <QMutexLocker>
+#include <math.h>
+#include <string.h>
+
+// MAD to standard deviation of a normal distribution
+#define MAD_TO_SIGMA 1.4826
+// standard error of the median relative to the mean, times z(95%)
+#define MEDIAN_CI_FACTOR (1.2533 * 1.96)
+
+RTXCCalibrator::TConfig RTXCCalibrator::defaultConfig()
+{
+    TConfig config;
+    config.window = 128;
+    config.minSamples = 16;
+    config.maxHalfWidth = 1.0;
+    config.rejectSigma = 3.0;
+    config.minHoldMs = 250;
+    config.maxHoldMs = 2000;
+    config.moveThreshold = 20;
+    return config;
+}
+
+RTXCCalibrator::RTXCCalibrator(const TConfig &config)
+    : m_mutex()
+    , m_config(config)
+    , m_progress()
+    , m_ring()
+    , m_histogram()
+    , m_head(0)
+    , m_size(0)
+    , m_sum(0)
+    , m_rejectRun(0)
+    , m_moveRun(0)
+    , m_holdStart(0)
+{
+    m_config.window = qBound(1, m_config.window, (int) MaxWindow);
+    m_config.minSamples = qBound(1, m_config.minSamples, m_config.window);
+    reset();
+}
+
+void RTXCCalibrator::reset()
+{
+    QMutexLocker lock(&m_mutex);
+    m_progress = {};
+    m_progress.phase = PhaseMid;
+    clearWindow();
+}
+
+RTXCCalibrator::TPhase RTXCCalibrator::add(quint8 value, qint64 msecs)
+{
+    QMutexLocker lock(&m_mutex);
+
+    switch (m_progress.phase) {
+        case PhaseWaitMax: { /* values < mid */
+            if (!hasMoved((value + m_config.moveThreshold) < m_progress.mid)) {
+                return m_progress.phase;
+            }
+            m_progress.phase = PhaseMax;
+            break;
+        }
+        case PhaseWaitMin: { /* values > mid */
+            if (!hasMoved(value > (m_progress.mid + m_config.moveThreshold))) {
+                return m_progress.phase;
+            }
+            m_progress.phase = PhaseMin;
+            break;
+        }
+        case PhaseDone: {
+            return m_progress.phase;
+        }
+        default: {
+            break;
+        }
+    }
+
+    if (isOutlier(value)) {
+        m_progress.rejected++;
+        // a long run of outliers means the paddle moved, start over
+        if (++m_rejectRun <= (quint32) m_config.window / 2) {
+            return m_progress.phase;
+        }
+        clearWindow();
+    }
+
+    m_rejectRun = 0;
+    insert(value, msecs);
+    updateStatistics();
+
+    if (isStable(msecs)) {
+        takePosition();
+    }
+    return m_progress.phase;
+}
+
+RTXCCalibrator::TProgress RTXCCalibrator::progress() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_progress;
+}
+
+inline bool RTXCCalibrator::hasMoved(bool moved)
+{
+    // single outliers must not start the next phase
+    m_moveRun = (moved ? m_moveRun + 1 : 0);
+    return m_moveRun >= (quint32) qMax(1, m_config.minSamples / 4);
+}
+
+inline void RTXCCalibrator::clearWindow()
+{
+    memset(m_histogram, 0, sizeof(m_histogram));
+    m_head = 0;
+    m_size = 0;
+    m_sum = 0;
+    m_rejectRun = 0;
+    m_moveRun = 0;
+    m_holdStart = 0;
+    m_progress.samples = 0;
+    m_progress.median = 0;
+    m_progress.mad = 0;
+    m_progress.halfWidth = 0;
+}
+
+inline void RTXCCalibrator::insert(quint8 value, qint64 msecs)
+{
+    if (m_size == 0) {
+        m_holdStart = msecs;
+    }
+    if (m_size == m_config.window) {
+        const quint8 oldest = m_ring[m_head];
+        m_histogram[oldest]--;
+        m_sum -= oldest;
+        m_size--;
+    }
+    m_ring[m_head] = value;
+    m_head = (m_head + 1) % m_config.window;
+    m_histogram[value]++;
+    m_sum += value;
+    m_size++;
+}
+
+inline void RTXCCalibrator::updateStatistics()
+{
+    // values are 8 bit, median and MAD come from the window histogram
+    const int half = (m_size + 1) / 2;
+
+    int median = 0;
+    for (int n = 0; median < 256; median++) {
+        if ((n += m_histogram[median]) >= half) {
+            break;
+        }
+    }
+
+    int mad = 0;
+    for (int n = m_histogram[median]; n < half; ) {
+        mad++;
+        if (median - mad >= 0) {
+            n += m_histogram[median - mad];
+        }
+        if (median + mad < 256) {
+            n += m_histogram[median + mad];
+        }
+    }
+
+    m_progress.samples = m_size;
+    m_progress.median = median;
+    m_progress.mad = mad;
+    m_progress.halfWidth = MEDIAN_CI_FACTOR * MAD_TO_SIGMA * mad / sqrt((double) m_size);
+}
+
+inline bool RTXCCalibrator::isOutlier(quint8 value) const
+{
+    if (m_size < m_config.minSamples) {
+        return false;
+    }
+    // at least one count of noise, the values are quantized
+    const double sigma = qMax(MAD_TO_SIGMA * m_progress.mad, 1.0);
+    return fabs(value - m_progress.median) > m_config.rejectSigma * sigma;
+}
+
+inline bool RTXCCalibrator::isStable(qint64 msecs) const
+{
+    const qint64 held = msecs - m_holdStart;
+    if (m_size >= m_config.minSamples && held >= m_config.minHoldMs && m_progress.halfWidth <= m_config.maxHalfWidth) {
+        return true;
+    }
+    // noisy paddle, a full window held long enough is the best estimate
+    return (m_size == m_config.window && held >= m_config.maxHoldMs);
+}
+
+inline void RTXCCalibrator::takePosition()
+{
+    // mean of the window, all values passed the outlier check
+    const quint8 position = (quint8) ((m_sum + m_size / 2) / m_size);
+    const bool moved = (qAbs(position - m_progress.mid) > m_config.moveThreshold);
+
+    switch (m_progress.phase) {
+        case PhaseMid: {
+            m_progress.mid = position;
+            m_progress.phase = PhaseWaitMax;
+            break;
+        }
+        case PhaseMax: {
+            // paddle went back to the middle, wait again
+            m_progress.max = (moved ? position : 0);
+            m_progress.phase = (moved ? PhaseWaitMin : PhaseWaitMax);
+            break;
+        }
+        case PhaseMin: {
+            m_progress.min = (moved ? position : 0);
+            m_progress.phase = (moved ? PhaseDone : PhaseWaitMin);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    clearWindow();
+}
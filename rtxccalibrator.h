@@ -0,0 +1,119 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QMutex>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The RTXCCalibrator class finds the mid, max and min position of
+ * the X-Celerator paddle from the calibration value stream. Each position
+ * is measured over a sliding window with running median and MAD (median
+ * absolute deviation). Outliers are rejected, and a position is taken as
+ * soon as the confidence interval of the median is narrow enough. The
+ * calibrator is fed value by value and does not depend on the device, so
+ * recorded paddle streams can be replayed (rtyonctl xcreplay).
+ */
+class RTXCCalibrator
+{
+public:
+    typedef enum {
+        PhaseMid = 0, // paddle released
+        PhaseWaitMax, // waiting for the paddle to move up
+        PhaseMax,     // paddle held up
+        PhaseWaitMin, // waiting for the paddle to move down
+        PhaseMin,     // paddle held down
+        PhaseDone,
+    } TPhase;
+
+    /**
+     * @brief Tuning parameters
+     */
+    typedef struct
+    {
+        int window;          // sliding window size in values, max 255
+        int minSamples;      // values required before a position can be taken
+        double maxHalfWidth; // 95% confidence half width of the median in counts
+        double rejectSigma;  // outlier limit in robust standard deviations
+        qint64 minHoldMs;    // the paddle must be held at least this long
+        qint64 maxHoldMs;    // take a full window after this time regardless of noise
+        int moveThreshold;   // distance from mid that starts the max/min phase
+    } TConfig;
+
+    /**
+     * @brief Calibration state, safe to read from another thread
+     */
+    typedef struct
+    {
+        TPhase phase;
+        quint8 mid;
+        quint8 max;
+        quint8 min;
+        quint32 samples;  // values in the current window
+        quint32 rejected; // outliers rejected in total
+        double median;    // current window median
+        double mad;       // current window MAD
+        double halfWidth; // current confidence half width
+    } TProgress;
+
+    /**
+     * @brief Return the default tuning parameters
+     * @return TConfig structure
+     */
+    static TConfig defaultConfig();
+
+    /**
+     * @brief Construct a calibrator in PhaseMid
+     * @param config Tuning parameters
+     */
+    explicit RTXCCalibrator(const TConfig &config = defaultConfig());
+
+    /**
+     * @brief Restart the calibration with PhaseMid
+     */
+    void reset();
+
+    /**
+     * @brief Add one paddle value
+     * @param value Paddle position 0-255
+     * @param msecs Monotonic time stamp of the value in milliseconds
+     * @return Phase after the value was processed
+     */
+    TPhase add(quint8 value, qint64 msecs);
+
+    /**
+     * @brief Return the calibration state
+     * @return TProgress structure
+     */
+    TProgress progress() const;
+
+private:
+    enum {
+        MaxWindow = 255,
+    };
+
+    mutable QMutex m_mutex;
+    TConfig m_config;
+    TProgress m_progress;
+    quint8 m_ring[MaxWindow];
+    quint16 m_histogram[256];
+    int m_head;
+    int m_size;
+    quint32 m_sum;
+    quint32 m_rejectRun;
+    quint32 m_moveRun;
+    qint64 m_holdStart;
+
+private:
+    inline void clearWindow();
+    inline bool hasMoved(bool moved);
+    inline void insert(quint8 value, qint64 msecs);
+    inline void updateStatistics();
+    inline bool isOutlier(quint8 value) const;
+    inline bool isStable(qint64 msecs) const;
+    inline void takePosition();
+};
@@ -0,0 +1,80 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtxceleratorstream.h"
+
+// frame window layout in the 64 bit atomic
+#define WINDOW_MIN(w) ((quint8) ((w) & 0xff))
+#define WINDOW_MAX(w) ((quint8) (((w) >> 8) & 0xff))
+#define WINDOW_COUNT(w) ((quint32) (((w) >> 16) & 0xffff))
+#define WINDOW_SUM(w) ((quint32) ((w) >> 32))
+#define WINDOW_MAKE(min, max, count, sum) \
+    (((quint64) (sum) << 32) | ((quint64) (count) << 16) | ((quint64) (max) << 8) | (quint64) (min))
+
+RTXCeleratorStream::RTXCeleratorStream()
+    : m_latest(0)
+    , m_window(0)
+{}
+
+bool RTXCeleratorStream::push(quint8 value)
+{
+    const quint64 latest = m_latest.loadRelaxed();
+    m_latest.storeRelease((((latest >> 8) + 1) << 8) | value);
+
+    quint64 w = m_window.loadRelaxed();
+    quint64 next;
+    do {
+        const quint32 count = WINDOW_COUNT(w);
+        if (count == 0) {
+            next = WINDOW_MAKE(value, value, 1, value);
+        } else if (count == 0xffff) {
+            // nobody pulls, keep the window from overflowing
+            next = w;
+            break;
+        } else {
+            next = WINDOW_MAKE(qMin(WINDOW_MIN(w), value), //
+                               qMax(WINDOW_MAX(w), value),
+                               count + 1,
+                               WINDOW_SUM(w) + value);
+        }
+    } while (!m_window.testAndSetOrdered(w, next, w));
+
+    return (WINDOW_COUNT(w) == 0);
+}
+
+RTXCeleratorStream::TSample RTXCeleratorStream::latest() const
+{
+    const quint64 latest = m_latest.loadAcquire();
+
+    TSample s = {};
+    s.sequence = (latest >> 8);
+    s.value = (quint8) (latest & 0xff);
+    s.min = s.max = s.value;
+    s.mean = s.value;
+    return s;
+}
+
+RTXCeleratorStream::TSample RTXCeleratorStream::take()
+{
+    const quint64 w = m_window.fetchAndStoreOrdered(0);
+
+    TSample s = latest();
+    s.count = WINDOW_COUNT(w);
+    if (s.count > 0) {
+        s.min = WINDOW_MIN(w);
+        s.max = WINDOW_MAX(w);
+        s.sum = WINDOW_SUM(w);
+        s.mean = (double) s.sum / s.count;
+    }
+    return s;
+}
+
+void RTXCeleratorStream::reset()
+{
+    m_window.storeRelease(0);
+    m_latest.storeRelease(0);
+}
@@ -0,0 +1,73 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include <QAtomicInteger>
+#include <QtCore/QtGlobal>
+
+/**
+ * @brief The RTXCeleratorStream class publishes the X-Celerator paddle
+ * values of the SPECIAL input reports without queueing them. The input
+ * thread pushes every value, the UI pulls the latest value and the
+ * min/max/mean since its previous pull once per display frame. Both sides
+ * are lock free: the latest value and the frame window each live in one
+ * 64 bit atomic.
+ */
+class RTXCeleratorStream
+{
+public:
+    /**
+     * @brief One display frame of paddle values
+     */
+    typedef struct
+    {
+        quint64 sequence; // number of values pushed so far, 0 = none yet
+        quint8 value;     // latest value
+        quint8 min;       // smallest value of the frame
+        quint8 max;       // largest value of the frame
+        quint32 count;    // values in the frame, 0 = no new value
+        quint32 sum;      // sum of the frame values
+        double mean;      // mean of the frame values
+    } TSample;
+
+    /**
+     * @brief Default constructor, no values
+     */
+    RTXCeleratorStream();
+
+    /**
+     * @brief Publish a paddle value, called from the input thread
+     * @param value Paddle position 0-255
+     * @return True if this is the first value since the last take(),
+     * to wake up a consumer with at most one pending notification
+     */
+    bool push(quint8 value);
+
+    /**
+     * @brief Return the latest value without touching the frame window
+     * @return TSample with sequence and value set, count 0
+     */
+    TSample latest() const;
+
+    /**
+     * @brief Return the latest value and the values since the previous
+     * call, then start a new frame window. Call once per display frame.
+     * @return TSample structure
+     */
+    TSample take();
+
+    /**
+     * @brief Forget all values
+     */
+    void reset();
+
+private:
+    // sequence << 8 | value
+    QAtomicInteger<quint64> m_latest;
+    // sum << 32 | count << 16 | max << 8 | min
+    QAtomicInteger<quint64> m_window;
+};
@@ -76,6 +76,9 @@ void RTXCeleratorWidget::setValue(int v)
         if (m_updateTimer.elapsed() < 30) { // < 30ms seit letzter Änderung
             m_anim->stop();
             setAnimatedValue(m_value);
+        } else if (m_anim->state() == QAbstractAnimation::Running) {
+            // running animation follows the new target, no restart
+            m_anim->setEndValue(m_value);
         } else {
             // Saubere Animation starten
             m_anim->stop();
@@ -0,0 +1,240 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtxcjoystick.h"
+#include "rttypedefs.h"
+#include <QMutexLocker>
+#include <QSettings>
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+RTXCJoystick::TConfig RTXCJoystick::defaultConfig()
+{
+    TConfig config;
+    config.deadzone = 5;
+    config.curve = 1.0;
+    config.invert = false;
+    return config;
+}
+
+bool RTXCJoystick::loadConfig(QSettings *settings, TConfig *config)
+{
+    const TConfig defaults = defaultConfig();
+    settings->beginGroup("joystick");
+    const bool enabled = settings->value("enabled", false).toBool();
+    config->deadzone = qBound(0, settings->value("deadzone", defaults.deadzone).toInt(), 50);
+    config->curve = qBound(0.2, settings->value("curve", defaults.curve).toDouble(), 5.0);
+    config->invert = settings->value("invert", defaults.invert).toBool();
+    settings->endGroup();
+    return enabled;
+}
+
+RTXCJoystick::RTXCJoystick()
+    : m_mutex()
+    , m_fd(-1)
+    , m_config(defaultConfig())
+    , m_min(0xff)
+    , m_mid(0x80)
+    , m_max(0x00)
+    , m_lut()
+    , m_lastAxis(-1 - AxisMax)
+    , m_metricsLog(qEnvironmentVariableIntValue("RT_JOYSTICK_METRICS") > 0)
+    , m_values(0)
+    , m_failures(0)
+    , m_latency()
+{
+    buildTable();
+}
+
+RTXCJoystick::~RTXCJoystick()
+{
+    close();
+}
+
+bool RTXCJoystick::open(QString *error)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_fd >= 0) {
+        return true;
+    }
+
+#ifdef Q_OS_LINUX
+    const int fd = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        *error = QStringLiteral("/dev/uinput: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+
+    // one button makes udev and SDL classify the device as a gamepad
+    struct uinput_abs_setup abs = {};
+    abs.code = ABS_X;
+    abs.absinfo.minimum = -AxisMax;
+    abs.absinfo.maximum = AxisMax;
+
+    struct uinput_setup setup = {};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = USB_DEVICE_ID_VENDOR_ROCCAT;
+    setup.id.product = USB_DEVICE_ID_ROCCAT_TYON_BLACK;
+    setup.id.version = 1;
+    strncpy(setup.name, "ROCCAT Tyon X-Celerator", UINPUT_MAX_NAME_SIZE - 1);
+
+    if (ioctl(fd, UI_SET_EVBIT, EV_KEY) < 0 //
+        || ioctl(fd, UI_SET_KEYBIT, BTN_SOUTH) < 0
+        || ioctl(fd, UI_SET_EVBIT, EV_ABS) < 0
+        || ioctl(fd, UI_SET_ABSBIT, ABS_X) < 0
+        || ioctl(fd, UI_ABS_SETUP, &abs) < 0
+        || ioctl(fd, UI_DEV_SETUP, &setup) < 0
+        || ioctl(fd, UI_DEV_CREATE) < 0) {
+        *error = QStringLiteral("uinput: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_lastAxis = -1 - AxisMax;
+    qInfo("[XCJOY] Virtual gamepad created");
+    return true;
+#else
+    *error = QStringLiteral("The joystick export needs Linux uinput.");
+    return false;
+#endif
+}
+
+void RTXCJoystick::close()
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_fd < 0) {
+        return;
+    }
+#ifdef Q_OS_LINUX
+    ioctl(m_fd, UI_DEV_DESTROY);
+    ::close(m_fd);
+#endif
+    m_fd = -1;
+}
+
+bool RTXCJoystick::isOpen() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_fd >= 0;
+}
+
+void RTXCJoystick::setConfig(const TConfig &config)
+{
+    QMutexLocker lock(&m_mutex);
+    m_config = config;
+    buildTable();
+}
+
+void RTXCJoystick::setCalibration(quint8 min, quint8 mid, quint8 max)
+{
+    QMutexLocker lock(&m_mutex);
+    // paddle up gives small values: max < mid < min
+    if (max < mid && mid < min) {
+        m_min = min;
+        m_mid = mid;
+        m_max = max;
+    } else {
+        m_min = 0xff;
+        m_mid = 0x80;
+        m_max = 0x00;
+    }
+    buildTable();
+}
+
+qint16 RTXCJoystick::axisValue(quint8 value) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_lut[value];
+}
+
+void RTXCJoystick::forward(quint8 value, qint64 receivedNs)
+{
+    m_values.fetchAndAddRelaxed(1);
+
+    QMutexLocker lock(&m_mutex);
+    const int axis = m_lut[value];
+    if (m_fd < 0 || axis == m_lastAxis) {
+        return;
+    }
+
+#ifdef Q_OS_LINUX
+    // axis and sync in a single write
+    struct input_event ev[2] = {};
+    ev[0].type = EV_ABS;
+    ev[0].code = ABS_X;
+    ev[0].value = axis;
+    ev[1].type = EV_SYN;
+    ev[1].code = SYN_REPORT;
+    if (::write(m_fd, ev, sizeof(ev)) != (ssize_t) sizeof(ev)) {
+        m_failures.fetchAndAddRelaxed(1);
+        return;
+    }
+#endif
+
+    m_lastAxis = axis;
+    lock.unlock();
+    measure(RTLatency::monotonicNs() - receivedNs);
+}
+
+RTXCJoystick::TStatistics RTXCJoystick::statistics() const
+{
+    TStatistics stats = {};
+    stats.values = m_values.loadRelaxed();
+    stats.events = m_latency.events();
+    stats.failures = m_failures.loadRelaxed();
+    stats.meanUs = m_latency.meanUs();
+    stats.maxUs = m_latency.maxUs();
+    stats.p99Us = m_latency.percentileUs(99);
+    return stats;
+}
+
+inline void RTXCJoystick::buildTable()
+{
+    const double dz = m_config.deadzone / 100.0;
+    const double sign = (m_config.invert ? -1.0 : 1.0);
+
+    for (int v = 0; v < 256; v++) {
+        // -1 (down) .. +1 (up) relative to the calibrated center
+        double t;
+        if (v <= m_mid) {
+            t = (v <= m_max ? 1.0 : (double) (m_mid - v) / (m_mid - m_max));
+        } else {
+            t = (v >= m_min ? -1.0 : -(double) (v - m_mid) / (m_min - m_mid));
+        }
+
+        double a = fabs(t);
+        a = (a <= dz ? 0.0 : (a - dz) / (1.0 - dz));
+        a = pow(a, m_config.curve);
+
+        m_lut[v] = (qint16) lround(sign * (t < 0 ? -a : a) * AxisMax);
+    }
+    // force the next value out with the new mapping
+    m_lastAxis = -1 - AxisMax;
+}
+
+inline void RTXCJoystick::measure(qint64 ns)
+{
+    const quint64 events = m_latency.add(ns);
+
+    if (m_metricsLog && (events % 1000) == 0) {
+        const TStatistics s = statistics();
+        qInfo("[XCJOY] %llu events: mean %.1f us, p99 %.0f us, max %.1f us", //
+              (unsigned long long) s.events,
+              s.meanUs,
+              s.p99Us,
+              s.maxUs);
+    }
+}
@@ -0,0 +1,147 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#pragma once
+#include "rtlatency.h"
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QString>
+#include <QtCore/QtGlobal>
+
+class QSettings;
+
+/**
+ * @brief The RTXCJoystick class exports the X-Celerator paddle as the
+ * absolute X axis of a virtual gamepad (Linux uinput). The analogue values
+ * are mapped through a 256 entry lookup table built from the calibration
+ * (TyonInfo min/mid/max), the dead zone and the response curve. forward()
+ * runs directly on the HID input thread and writes the axis event without
+ * any Qt signal in between. The time from the arrival of the HID report to
+ * the written axis event is measured.
+ */
+class RTXCJoystick
+{
+public:
+    enum {
+        AxisMax = 32767,
+        LatencyBuckets = 64, // 16 us each, the last one collects the rest
+        LatencyBucketUs = 16,
+    };
+
+    /**
+     * @brief Mapping parameters
+     */
+    typedef struct
+    {
+        int deadzone; // center dead zone in percent 0-50
+        double curve; // response exponent, 1.0 = linear, > 1 finer near center
+        bool invert;  // paddle up is negative
+    } TConfig;
+
+    /**
+     * @brief Forwarding statistics
+     */
+    typedef struct
+    {
+        quint64 values;   // values received
+        quint64 events;   // axis events written, unchanged positions are skipped
+        quint64 failures; // failed writes
+        double meanUs;    // mean time from HID report to axis event
+        double maxUs;     // longest report to axis event
+        double p99Us;     // 99th percentile, 16 us resolution
+    } TStatistics;
+
+    /**
+     * @brief Return the default mapping: 5% dead zone, linear
+     * @return TConfig structure
+     */
+    static TConfig defaultConfig();
+
+    /**
+     * @brief Read the [joystick] group of the settings
+     * @param settings Application settings
+     * @param config Receives the mapping parameters
+     * @return True if the joystick export is enabled
+     */
+    static bool loadConfig(QSettings *settings, TConfig *config);
+
+    /**
+     * @brief Default constructor, closed
+     */
+    RTXCJoystick();
+    ~RTXCJoystick();
+
+    /**
+     * @brief Create the virtual gamepad
+     * @param error Receives the reason on failure
+     * @return True on success
+     */
+    bool open(QString *error);
+
+    /**
+     * @brief Destroy the virtual gamepad
+     */
+    void close();
+
+    /**
+     * @brief Return true if the virtual gamepad exists
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Set the mapping parameters and rebuild the lookup table
+     * @param config Mapping parameters
+     */
+    void setConfig(const TConfig &config);
+
+    /**
+     * @brief Set the paddle calibration and rebuild the lookup table.
+     * Invalid values (min, mid, max not ordered) select the full range.
+     * @param min Paddle down position
+     * @param mid Paddle center position
+     * @param max Paddle up position
+     */
+    void setCalibration(quint8 min, quint8 mid, quint8 max);
+
+    /**
+     * @brief Map and write one paddle value, called on the input thread
+     * @param value Analogue paddle value 0-255
+     * @param receivedNs RTLatency::monotonicNs() when the HID report arrived
+     */
+    void forward(quint8 value, qint64 receivedNs);
+
+    /**
+     * @brief Return the forwarding statistics
+     * @return TStatistics structure
+     */
+    TStatistics statistics() const;
+
+    /**
+     * @brief Map a paddle value with the current lookup table
+     * @param value Analogue paddle value 0-255
+     * @return Axis value -AxisMax..AxisMax
+     */
+    qint16 axisValue(quint8 value) const;
+
+private:
+    mutable QMutex m_mutex;
+    int m_fd;
+    TConfig m_config;
+    quint8 m_min;
+    quint8 m_mid;
+    quint8 m_max;
+    qint16 m_lut[256];
+    int m_lastAxis;
+    bool m_metricsLog;
+    QAtomicInteger<quint64> m_values;
+    QAtomicInteger<quint64> m_failures;
+    RTLatencyHistogram<LatencyBuckets, LatencyBucketUs> m_latency;
+
+private:
+    inline void buildTable();
+    inline void measure(qint64 ns);
+};
@@ -0,0 +1,1203 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtcalibrationsweep.h"
+#include "rtcontroller.h"
+#include "rtframeanalyzer.h"
+#include "rtframelog.h"
+#include "rtpollrateanalyzer.h"
+#include "rtprofilerules.h"
+#include "rtxccalibrator.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QMetaEnum>
+#include <QPair>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTimer>
+#include <stdio.h>
+#include <string.h>
+
+// Exit codes
+enum {
+    RTCTL_OK = 0,
+    RTCTL_USAGE = 1,
+    RTCTL_NODEVICE = 2,
+    RTCTL_FAILED = 3,
+};
+
+/**
+ * @brief Phase timing for the --timing option
+ */
+class RTTiming
+{
+public:
+    RTTiming()
+        : m_clock()
+        , m_last(0)
+        , m_phases()
+        , m_enabled(false)
+    {
+        m_clock.start();
+    }
+
+    inline void setEnabled(bool enabled) { m_enabled = enabled; }
+
+    inline bool isEnabled() const { return m_enabled; }
+
+    inline void mark(const char *phase)
+    {
+        const qint64 now = m_clock.nsecsElapsed();
+        m_phases.append(qMakePair(QString::fromLatin1(phase), now - m_last));
+        m_last = now;
+    }
+
+    inline void print() const
+    {
+        for (const QPair<QString, qint64> &p : m_phases) {
+            fprintf(stderr, "timing: %-8s %8.2f ms\n", qPrintable(p.first), p.second / 1000000.0);
+        }
+        fprintf(stderr, "timing: %-8s %8.2f ms\n", "total", m_clock.nsecsElapsed() / 1000000.0);
+    }
+
+private:
+    QElapsedTimer m_clock;
+    qint64 m_last;
+    QList<QPair<QString, qint64>> m_phases;
+    bool m_enabled;
+};
+
+/**
+ * @brief Ends the last phase and prints the breakdown if enabled
+ */
+static int finish(RTTiming &timing, const char *phase, int rc)
+{
+    timing.mark(phase);
+    if (timing.isEnabled()) {
+        timing.print();
+    }
+    return rc;
+}
+
+/**
+ * @brief Loads the configuration of C shared with the GUI and rtyond
+ */
+template<class C>
+static void loadSettings(typename C::TConfig *config)
+{
+    const QString fpath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    QSettings settings(QDir::toNativeSeparators(fpath + "/settings.conf"), QSettings::Format::NativeFormat);
+    C::loadConfig(&settings, config);
+}
+
+static int toNumber(const QString &s, int min, int max, bool &ok)
+{
+    int value = s.toInt(&ok);
+    if (ok && (value < min || value > max)) {
+        ok = false;
+    }
+    return value;
+}
+
+// -------------------------------------------------------------
+
+static int doSwitch(RTController *c, const QStringList &args)
+{
+    bool ok = false;
+    int pix = (args.size() == 1 ? toNumber(args[0], 1, TYON_PROFILE_NUM, ok) : 0);
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl switch <1-%d>\n", TYON_PROFILE_NUM);
+        return RTCTL_USAGE;
+    }
+    return c->deviceWriteActiveProfile(pix - 1) ? RTCTL_OK : RTCTL_FAILED;
+}
+
+static int doSet(RTController *c, const QStringList &args, int profile)
+{
+    bool ok = false;
+    int slot = 0;
+    int value = 0;
+
+    if (args.size() == 3 && args[0] == QStringLiteral("dpi")) {
+        slot = toNumber(args[1], 1, TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM, ok);
+        if (ok) {
+            value = toNumber(args[2], TYON_CPI_MIN, TYON_CPI_MAX, ok);
+        }
+    } else if (args.size() == 2 && args[0] == QStringLiteral("active-dpi")) {
+        slot = toNumber(args[1], 1, TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl [--profile <1-%d>] set dpi <slot 1-%d> <%d-%d>\n", //
+                TYON_PROFILE_NUM,
+                TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM,
+                TYON_CPI_MIN,
+                TYON_CPI_MAX);
+        fprintf(stderr, "       rtyonctl [--profile <1-%d>] set active-dpi <slot 1-%d>\n", //
+                TYON_PROFILE_NUM,
+                TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM);
+        return RTCTL_USAGE;
+    }
+
+    /* the setters work on the active profile */
+    if (profile > 0) {
+        c->setActiveProfile(profile - 1);
+    } else if (!c->deviceReadActiveProfile()) {
+        return RTCTL_FAILED;
+    }
+
+    const quint8 pix = c->activeProfileIndex();
+
+    /* buttons are untouched, settings only */
+    if (!c->deviceReadProfile(pix, false)) {
+        return RTCTL_FAILED;
+    }
+
+    if (args[0] == QStringLiteral("dpi")) {
+        c->setDpiLevel(slot - 1, value);
+    } else {
+        c->setActiveDpiSlot(slot - 1);
+    }
+
+    return c->deviceWriteProfile(pix, false) ? RTCTL_OK : RTCTL_FAILED;
+}
+
+static int doApply(RTController *c, const QStringList &args, int profile, bool &failed)
+{
+    if (args.size() != 1) {
+        fprintf(stderr, "usage: rtyonctl [--profile <1-%d>] apply <file.rtpf>\n", TYON_PROFILE_NUM);
+        return RTCTL_USAGE;
+    }
+
+    c->loadProfilesFromFile(args[0], true);
+    if (failed) {
+        return RTCTL_FAILED;
+    }
+
+    for (quint8 pix = 0; pix < TYON_PROFILE_NUM; pix++) {
+        bool found = false;
+        const RTController::TProfile p = c->profile(pix, found);
+        if (found && p.changed && !c->deviceWriteProfile(pix)) {
+            return RTCTL_FAILED;
+        }
+    }
+
+    if (profile > 0 && !c->deviceWriteActiveProfile(profile - 1)) {
+        return RTCTL_FAILED;
+    }
+
+    return RTCTL_OK;
+}
+
+/**
+ * @brief Format a shortcut like QKeySequence::PortableText without QtGui
+ * @param kc Key combination from RTController::toKeyCombination
+ * @return Text like Ctrl+Shift+F5
+ */
+static QString toKeyText(const QKeyCombination &kc)
+{
+    if (kc.toCombined() == 0) {
+        return QStringLiteral("unmapped");
+    }
+
+    static const struct
+    {
+        Qt::KeyboardModifier modifier;
+        const char *name;
+    } modifiers[] = {
+        {Qt::ControlModifier, "Ctrl+"},
+        {Qt::AltModifier, "Alt+"},
+        {Qt::ShiftModifier, "Shift+"},
+        {Qt::MetaModifier, "Meta+"},
+        {Qt::KeypadModifier, "Num+"},
+    };
+
+    QString text;
+    for (const auto &m : modifiers) {
+        if (kc.keyboardModifiers().testFlag(m.modifier)) {
+            text += QLatin1String(m.name);
+        }
+    }
+    // Qt::Key_F5 -> F5
+    const char *name = QMetaEnum::fromType<Qt::Key>().valueToKey(kc.key());
+    if (name && !strncmp(name, "Key_", 4)) {
+        text += QLatin1String(name + 4);
+    } else {
+        text += QStringLiteral("0x%1").arg((uint) kc.key(), 0, 16);
+    }
+    return text;
+}
+
+static int doDump(RTController *c)
+{
+    if (!c->deviceReadInfo() || !c->deviceReadActiveProfile()) {
+        return RTCTL_FAILED;
+    }
+    for (quint8 pix = 0; pix < TYON_PROFILE_NUM; pix++) {
+        if (!c->deviceReadProfile(pix)) {
+            return RTCTL_FAILED;
+        }
+    }
+
+    const TyonInfo info = c->firmwareInfo();
+    printf("firmware      %d.%02d (dfu %d)\n", info.firmware_version / 100, info.firmware_version % 100, info.dfu_version);
+    printf("x-celerator   min=%d mid=%d max=%d\n", info.xcelerator_min, info.xcelerator_mid, info.xcelerator_max);
+    printf("control unit  dcu=%d tcu=%d median=%u\n", c->dcuState(), c->tcuState(), c->tcuMedian());
+    printf("active        %d\n", c->activeProfileIndex() + 1);
+
+    const QMap<quint8, QString> &types = c->buttonTypes();
+    for (quint8 pix = 0; pix < TYON_PROFILE_NUM; pix++) {
+        bool found = false;
+        const RTController::TProfile p = c->profile(pix, found);
+        if (!found) {
+            continue;
+        }
+        const TyonProfileSettings *s = &p.settings;
+        printf("profile %d     %s\n", pix + 1, qPrintable(p.name));
+        printf("  dpi         ");
+        for (quint8 i = 0; i < TYON_PROFILE_SETTINGS_CPI_LEVELS_NUM; i++) {
+            printf("%s%d%s%s", //
+                   (s->cpi_levels_enabled & (1 << i)) ? "" : "(",
+                   c->toDpiLevelValue(s, i),
+                   (s->cpi_levels_enabled & (1 << i)) ? "" : ")",
+                   (i == s->cpi_active ? "* " : " "));
+        }
+        printf("\n");
+        printf("  sensitivity x=%d y=%d advanced=%d\n", //
+               c->toSensitivityXValue(s),
+               c->toSensitivityYValue(s),
+               s->advanced_sensitivity);
+        printf("  polling     %d talkfx=%d\n", c->talkFxPollRate(s), c->talkFxState(s));
+        printf("  lights      enabled=0x%02x effect=%d flow=%d speed=%d\n", //
+               s->lights_enabled,
+               s->light_effect,
+               s->color_flow,
+               s->effect_speed);
+        for (quint8 bix = 0; bix < TYON_PROFILE_BUTTON_NUM; bix++) {
+            const RoccatButton *b = &p.buttons.buttons[bix];
+            printf("  button %02d   %s", bix, qPrintable(types.value(b->type, QString::number(b->type))));
+            if (b->type == TYON_BUTTON_TYPE_SHORTCUT) {
+                printf(" [%s]", qPrintable(toKeyText(c->toKeyCombination(*b))));
+            }
+            printf("\n");
+        }
+    }
+    return RTCTL_OK;
+}
+
+static int doRecord(RTController *c, const QStringList &args)
+{
+    bool ok = (args.size() == 1 || args.size() == 2);
+    int frames = 1000;
+    if (ok && args.size() == 2) {
+        frames = toNumber(args[1], 1, 1000000, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl record <file.rtfl> [frames 1-1000000]\n");
+        return RTCTL_USAGE;
+    }
+
+    /* DCU/TCU state is stored with each frame */
+    if (!c->deviceReadInfo()) {
+        return RTCTL_FAILED;
+    }
+
+    RTFrameLog log;
+    if (!log.openAppend(args[0])) {
+        fprintf(stderr, "rtyonctl: %s\n", qPrintable(log.errorString()));
+        return RTCTL_FAILED;
+    }
+    const quint64 first = log.count();
+
+    RTSensorCapture *capture = c->sensorCapture();
+    capture->setFrameLog(&log, c->dcuState(), c->tcuState());
+
+    QEventLoop loop;
+    int received = 0;
+    bool failed = false;
+    QObject::connect(
+        capture,
+        &RTSensorCapture::frameReady,
+        &loop,
+        [&](const TSensorFrameRef &) {
+            if (++received >= frames) {
+                capture->stop();
+                loop.quit();
+            }
+        },
+        Qt::QueuedConnection);
+    QObject::connect(
+        capture,
+        &RTSensorCapture::captureFailed,
+        &loop,
+        [&]() {
+            failed = true;
+            loop.quit();
+        },
+        Qt::QueuedConnection);
+
+    c->tcuSensorStartCapture();
+    loop.exec();
+    c->tcuSensorStopCapture();
+    capture->setFrameLog(nullptr);
+    capture->disconnect(&loop);
+
+    const RTSensorCapture::TStatistics stats = capture->statistics();
+    printf("recorded %llu frames to %s (dcu=%d tcu=%d, %llu dropped)\n",
+           (unsigned long long) (log.count() - first),
+           qPrintable(args[0]),
+           c->dcuState(),
+           c->tcuState(),
+           (unsigned long long) stats.dropped);
+    log.close();
+    return failed ? RTCTL_FAILED : RTCTL_OK;
+}
+
+static int doJoystick(RTController *c, const QStringList &args)
+{
+    bool ok = (args.size() <= 1);
+    int seconds = 30;
+    if (ok && args.size() == 1) {
+        seconds = toNumber(args[0], 1, 86400, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl joystick [seconds]\n");
+        return RTCTL_USAGE;
+    }
+
+    /* X-Celerator calibration for the axis mapping */
+    if (!c->deviceReadInfo()) {
+        return RTCTL_FAILED;
+    }
+
+    // dead zone and curve as configured for the GUI and rtyond
+    RTXCJoystick::TConfig config;
+    loadSettings<RTXCJoystick>(&config);
+
+    if (!c->setXcJoystick(true, config)) {
+        return RTCTL_FAILED;
+    }
+
+    printf("forwarding the X-Celerator for %d s (deadzone %d%%, curve %.2f)\n", seconds, config.deadzone, config.curve);
+    QEventLoop loop;
+    QTimer::singleShot(seconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+    c->setXcJoystick(false);
+
+    const RTXCJoystick::TStatistics s = c->xcJoystickStatistics();
+    printf("values %llu, events %llu, failures %llu\n", //
+           (unsigned long long) s.values,
+           (unsigned long long) s.events,
+           (unsigned long long) s.failures);
+    printf("added latency: mean %.1f us, p99 %.0f us, max %.1f us\n", s.meanUs, s.p99Us, s.maxUs);
+    return RTCTL_OK;
+}
+
+static int doHotkeys(RTController *c, const QStringList &args)
+{
+    bool ok = (args.size() <= 1);
+    int seconds = 30;
+    if (ok && args.size() == 1) {
+        seconds = toNumber(args[0], 1, 86400, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl hotkeys [seconds]\n");
+        return RTCTL_USAGE;
+    }
+
+    // key bindings as configured for the GUI and rtyond
+    RTHotkeyListener::TConfig config;
+    loadSettings<RTHotkeyListener>(&config);
+
+    if (!c->setHotkeys(true, config)) {
+        return RTCTL_FAILED;
+    }
+
+    printf("listening for the hotkeys for %d s\n", seconds);
+    QEventLoop loop;
+    QTimer::singleShot(seconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+    c->setHotkeys(false);
+
+    const RTHotkeyListener::TStatistics s = c->hotkeyStatistics();
+    printf("events %llu, failures %llu, over %d us %llu\n", //
+           (unsigned long long) s.events,
+           (unsigned long long) s.failures,
+           (int) RTHotkeyListener::BudgetUs,
+           (unsigned long long) s.overBudget);
+    printf("key to report: mean %.1f us, p99 %.0f us, max %.1f us\n", s.meanUs, s.p99Us, s.maxUs);
+    return (s.failures > 0 ? RTCTL_FAILED : RTCTL_OK);
+}
+
+static int doFocusReplay(RTController *c, const QStringList &args)
+{
+    if (args.size() != 1) {
+        fprintf(stderr, "usage: rtyonctl focusreplay <file>\n");
+        return RTCTL_USAGE;
+    }
+
+    QFile file(args[0]);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        fprintf(stderr, "rtyonctl: %s: %s\n", qPrintable(args[0]), qPrintable(file.errorString()));
+        return RTCTL_FAILED;
+    }
+
+    // rules as configured for the GUI and rtyond
+    const QString fpath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    QSettings settings(QDir::toNativeSeparators(fpath + "/settings.conf"), QSettings::Format::NativeFormat);
+    RTProfileRules rules;
+    rules.load(&settings);
+    if (rules.isEmpty()) {
+        fprintf(stderr, "rtyonctl: no [profileRules] in %s\n", qPrintable(settings.fileName()));
+        return RTCTL_FAILED;
+    }
+
+    // one focused program per line, optionally followed by a pause in ms
+    quint32 switches = 0;
+    quint32 failures = 0;
+    quint32 over = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+    while (!file.atEnd()) {
+        const QStringList f = QString::fromUtf8(file.readLine()).simplified().split(QChar(' '), Qt::SkipEmptyParts);
+        if (f.isEmpty() || f[0].startsWith(QChar('#'))) {
+            continue;
+        }
+        bool ok = true;
+        const int pauseMs = (f.size() > 1 ? toNumber(f[1], 0, 60000, ok) : 100);
+        if (!ok) {
+            continue;
+        }
+
+        // same path as the rtyond focus handler, stamped like a focus event
+        const qint64 timestamp = QDeadlineTimer::current(Qt::PreciseTimer).deadlineNSecs();
+        const int pix = rules.profileOf(f[0]);
+        if (pix >= 0 && pix != c->activeProfileIndex()) {
+            bool written = false;
+            bool done = false;
+            qint64 elapsed = 0;
+            QEventLoop loop;
+            QObject::connect(c, &RTController::profileActivated, &loop, [&](quint8, bool success, qint64 ns) {
+                done = true;
+                written = success;
+                elapsed = ns;
+                loop.quit();
+            });
+            QTimer::singleShot(1000, &loop, &QEventLoop::quit);
+            c->activateProfile(pix, timestamp);
+            loop.exec();
+
+            switches++;
+            if (!written) {
+                failures++;
+                printf("%-24s profile %d %s\n", qPrintable(f[0]), pix + 1, done ? "failed" : "timed out");
+            } else {
+                totalNs += elapsed;
+                maxNs = qMax(maxNs, elapsed);
+                if (elapsed > RT_PROFILE_SWITCH_BUDGET_MS * 1000000LL) {
+                    over++;
+                }
+                printf("%-24s profile %d %8.2f ms\n", qPrintable(f[0]), pix + 1, elapsed / 1000000.0);
+            }
+        }
+
+        QEventLoop pause;
+        QTimer::singleShot(pauseMs, &pause, &QEventLoop::quit);
+        pause.exec();
+    }
+
+    printf("switches %u, failures %u, over %d ms %u\n", switches, failures, RT_PROFILE_SWITCH_BUDGET_MS, over);
+    if (switches > failures) {
+        printf("focus to profile: mean %.2f ms, max %.2f ms\n", totalNs / 1000000.0 / (switches - failures), maxNs / 1000000.0);
+    }
+    return (failures > 0 || over > 0 ? RTCTL_FAILED : RTCTL_OK);
+}
+
+static int doTalkFx(RTController *c, const QStringList &args)
+{
+    bool ok = (args.size() <= 1);
+    int seconds = 30;
+    if (ok && args.size() == 1) {
+        seconds = toNumber(args[0], 1, 86400, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl talkfx [seconds]\n");
+        return RTCTL_USAGE;
+    }
+
+    // source, rates and colors as configured for the GUI and rtyond
+    RTTalkFxEngine::TConfig config;
+    loadSettings<RTTalkFxEngine>(&config);
+
+    if (!c->setTalkFx(true, config)) {
+        return RTCTL_FAILED;
+    }
+
+    printf("driving TalkFX for %d s (%d fps, at most %d writes/s)\n", seconds, config.fps, config.maxWrites);
+    QEventLoop loop;
+    QTimer::singleShot(seconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+    c->setTalkFx(false);
+
+    const RTTalkFxEngine::TStatistics s = c->talkFxStatistics();
+    printf("frames %llu, late %llu: %.1f fps\n", //
+           (unsigned long long) s.ticks,
+           (unsigned long long) s.late,
+           s.fps);
+    printf("writes %llu (%.1f/s), suppressed %llu, capped %llu, busy %llu, failures %llu\n", //
+           (unsigned long long) s.writes,
+           s.writeRate,
+           (unsigned long long) s.suppressed,
+           (unsigned long long) s.capped,
+           (unsigned long long) s.busy,
+           (unsigned long long) s.failures);
+    return (s.failures > 0 ? RTCTL_FAILED : RTCTL_OK);
+}
+
+static int doEvents(RTController *c, const QStringList &args)
+{
+    bool ok = (args.size() <= 1);
+    int seconds = 30;
+    if (ok && args.size() == 1) {
+        seconds = toNumber(args[0], 1, 86400, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl events [seconds]\n");
+        return RTCTL_USAGE;
+    }
+
+    // the decoded events update the profile state, print what changed
+    QEventLoop loop;
+    QObject::connect(c, &RTController::specialEvent, &loop, [](const TSpecialEvent &e) { //
+        printf("%-22s value=%d index=%d %s\n", RTSpecialReport::name(e.type), e.value, e.index, e.pressed ? "press" : "release");
+        fflush(stdout);
+    });
+    QObject::connect(c, &RTController::profileIndexChanged, &loop, [](quint8 pix) { //
+        printf("  active profile %d\n", pix + 1);
+    });
+    QObject::connect(c, &RTController::dpiSlotChanged, &loop, [c](quint8 pix, quint8 slot) { //
+        bool found = false;
+        const RTController::TProfile p = c->profile(pix, found);
+        printf("  profile %d dpi slot %d (%d dpi)\n", pix + 1, slot + 1, found ? c->toDpiLevelValue(&p.settings, slot) : 0);
+    });
+    QObject::connect(c, &RTController::sensitivityChanged, &loop, [](quint8 pix, qint16 x, qint16 y) { //
+        printf("  profile %d sensitivity x=%d y=%d\n", pix + 1, x, y);
+    });
+    QObject::connect(c, &RTController::easyshiftChanged, &loop, [](bool enabled, bool locked) { //
+        printf("  easyshift %s%s\n", enabled ? "on" : "off", locked ? " (locked)" : "");
+    });
+
+    QTimer::singleShot(seconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+    return RTCTL_OK;
+}
+
+static int doSweep(RTController *c, const QStringList &args, bool store)
+{
+    static const char *const dcuNames[] = {"off", "extra-low", "low", "normal"};
+
+    bool ok = (args.size() <= 1);
+    int frames = 20;
+    if (ok && args.size() == 1) {
+        frames = toNumber(args[0], 2, 1000, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl [--store] sweep [frames 2-1000]\n");
+        return RTCTL_USAGE;
+    }
+
+    if (!c->deviceReadInfo()) {
+        return RTCTL_FAILED;
+    }
+    const TyonControlUnitDcu dcu = c->dcuState();
+    const bool tcu = (c->tcuState() == TYON_TRACKING_CONTROL_UNIT_ON);
+    const uint median = c->tcuMedian();
+
+    RTCalibrationSweep sweep(c, frames);
+    QEventLoop loop;
+    QObject::connect(&sweep, &QThread::finished, &loop, &QEventLoop::quit, Qt::QueuedConnection);
+    sweep.start(QThread::HighPriority);
+    loop.exec();
+
+    const RTCalibrationSweep::TResults results = sweep.results();
+    if (results.isEmpty()) {
+        c->deviceWriteControlUnit(dcu, tcu, median);
+        return RTCTL_FAILED;
+    }
+
+    printf("%-4s %-10s %-4s %7s %7s %7s %7s %7s\n", "rank", "dcu", "tcu", "score", "contr.", "noise", "mean", "median");
+    for (int i = 0; i < results.size(); i++) {
+        const RTCalibrationSweep::TResult &r = results.at(i);
+        printf("%-4d %-10s %-4s %7.2f %7.2f %7.3f %7.1f %7u\n",
+               i + 1,
+               dcuNames[r.dcu],
+               r.tcu ? "on" : "off",
+               r.score,
+               r.contrast,
+               r.temporalNoise,
+               r.mean,
+               r.median);
+    }
+
+    /* one control unit write: the recommendation or the previous setting */
+    const RTCalibrationSweep::TResult &best = results.first();
+    if (store) {
+        printf("stored dcu=%s tcu=%s\n", dcuNames[best.dcu], best.tcu ? "on" : "off");
+        return c->deviceWriteControlUnit(best.dcu, best.tcu, best.median) ? RTCTL_OK : RTCTL_FAILED;
+    }
+    return c->deviceWriteControlUnit(dcu, tcu, median) ? RTCTL_OK : RTCTL_FAILED;
+}
+
+static bool toRegister(const QString &s, quint8 &value)
+{
+    bool ok = false;
+    const uint v = s.toUInt(&ok, 0);
+    value = (quint8) v;
+    return ok && v <= 0xff;
+}
+
+static bool readSnapshot(const QString &fileName, RTSensorRegisters::TSnapshot *snapshot)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        fprintf(stderr, "rtyonctl: %s: %s\n", qPrintable(fileName), qPrintable(file.errorString()));
+        return false;
+    }
+    memset(snapshot, 0, sizeof(RTSensorRegisters::TSnapshot));
+    while (!file.atEnd()) {
+        const QStringList f = QString::fromLatin1(file.readLine()).simplified().split(QChar(' '));
+        quint8 reg, value;
+        if (f.size() == 2 && toRegister(f[0], reg) && toRegister(f[1], value) && reg < RTSensorRegisters::RegisterCount) {
+            snapshot->value[reg] = value;
+            snapshot->valid[reg] = true;
+        }
+    }
+    return true;
+}
+
+static int doRegs(RTController *c, const QStringList &args)
+{
+    const QString sub = (args.isEmpty() ? QStringLiteral("dump") : args[0]);
+    const QStringList values = args.mid(1);
+
+    TSensorRegisterBatch batch;
+    bool ok = true;
+    if (sub == QStringLiteral("get")) {
+        ok = !values.isEmpty();
+        for (const QString &v : values) {
+            quint8 reg;
+            ok = ok && toRegister(v, reg);
+            batch.append(RTSensorRegisters::read(reg));
+        }
+    } else if (sub == QStringLiteral("set")) {
+        ok = !values.isEmpty() && (values.size() % 2) == 0;
+        for (int i = 0; ok && i < values.size(); i += 2) {
+            quint8 reg, value;
+            ok = toRegister(values[i], reg) && toRegister(values[i + 1], value);
+            batch.append(RTSensorRegisters::write(reg, value));
+        }
+    } else if (sub == QStringLiteral("dump")) {
+        ok = values.isEmpty();
+    } else if (sub == QStringLiteral("diff")) {
+        ok = (values.size() == 1);
+    } else {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl regs [dump | diff <file> | get <reg>... | set <reg> <value>...]\n");
+        return RTCTL_USAGE;
+    }
+
+    if (sub == QStringLiteral("get") || sub == QStringLiteral("set")) {
+        ok = c->sensorRegisterBatch(&batch);
+        for (const TSensorRegisterOp &op : batch) {
+            if (op.ok && !op.write) {
+                printf("0x%02x 0x%02x\n", op.reg, op.value);
+            }
+        }
+        return ok ? RTCTL_OK : RTCTL_FAILED;
+    }
+
+    RTSensorRegisters::TSnapshot saved;
+    if (sub == QStringLiteral("diff") && !readSnapshot(values[0], &saved)) {
+        return RTCTL_FAILED;
+    }
+
+    RTSensorRegisters::TSnapshot current;
+    if (!c->sensorRegisterDump(&current)) {
+        return RTCTL_FAILED;
+    }
+
+    if (sub == QStringLiteral("diff")) {
+        const QList<quint8> changed = RTSensorRegisters::compare(saved, current);
+        for (quint8 reg : changed) {
+            printf("0x%02x 0x%02x -> 0x%02x\n", reg, saved.value[reg], current.value[reg]);
+        }
+        return RTCTL_OK;
+    }
+
+    // same format as read by diff
+    for (int reg = 0; reg < RTSensorRegisters::RegisterCount; reg++) {
+        if (current.valid[reg]) {
+            printf("0x%02x 0x%02x\n", reg, current.value[reg]);
+        }
+    }
+    return RTCTL_OK;
+}
+
+static int doXcReplay(const QStringList &args)
+{
+    if (args.size() != 1) {
+        fprintf(stderr, "usage: rtyonctl xcreplay <file>\n");
+        return RTCTL_USAGE;
+    }
+
+    QFile file(args[0]);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        fprintf(stderr, "rtyonctl: %s: %s\n", qPrintable(args[0]), qPrintable(file.errorString()));
+        return RTCTL_FAILED;
+    }
+
+    // one value per line, optionally preceded by a millisecond time stamp
+    RTXCCalibrator calibrator;
+    RTXCCalibrator::TPhase phase = RTXCCalibrator::PhaseMid;
+    qint64 msecs = 0;
+    quint32 values = 0;
+    while (!file.atEnd() && phase != RTXCCalibrator::PhaseDone) {
+        const QStringList f = QString::fromLatin1(file.readLine()).simplified().split(QChar(' '));
+        bool ok = false;
+        const uint value = f.last().toUInt(&ok, 0);
+        if (!ok || value > 0xff) {
+            continue;
+        }
+        msecs = (f.size() == 2 ? f[0].toLongLong() : msecs + 1);
+        values++;
+
+        const RTXCCalibrator::TPhase next = calibrator.add(value, msecs);
+        if (next != phase) {
+            const RTXCCalibrator::TProgress p = calibrator.progress();
+            printf("%8lld ms %6u values  phase %d  mid=%d max=%d min=%d rejected=%u\n", //
+                   (long long) msecs,
+                   values,
+                   next,
+                   p.mid,
+                   p.max,
+                   p.min,
+                   p.rejected);
+            phase = next;
+        }
+    }
+
+    if (phase != RTXCCalibrator::PhaseDone) {
+        fprintf(stderr, "rtyonctl: calibration did not finish\n");
+        return RTCTL_FAILED;
+    }
+    return RTCTL_OK;
+}
+
+static int doMacro(const QStringList &args)
+{
+    bool ok = (args.size() == 1 || args.size() == 2);
+    int repeats = 10;
+    if (ok && args.size() == 2) {
+        repeats = toNumber(args[1], 1, 10000, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl macro <file> [repeats]\n");
+        return RTCTL_USAGE;
+    }
+
+    QFile file(args[0]);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        fprintf(stderr, "rtyonctl: %s: %s\n", qPrintable(args[0]), qPrintable(file.errorString()));
+        return RTCTL_FAILED;
+    }
+    RTMacroPlayer::TMacro macro;
+    QString error;
+    if (!RTMacroPlayer::compile(QString::fromUtf8(file.readAll()), &macro, &error)) {
+        fprintf(stderr, "rtyonctl: %s: %s\n", qPrintable(args[0]), qPrintable(error));
+        return RTCTL_FAILED;
+    }
+
+    // CPU, priority and spin time as configured for the GUI and rtyond
+    RTMacroPlayer::TConfig config;
+    loadSettings<RTMacroPlayer>(&config);
+
+    RTMacroPlayer player;
+    if (!player.open({macro}, config, &error)) {
+        fprintf(stderr, "rtyonctl: %s\n", qPrintable(error));
+        return RTCTL_FAILED;
+    }
+
+    printf("playing %lld events %d times (%.3f ms each)\n", (long long) macro.count(), repeats, macro.last().atNs / 1e6);
+    // a play that does not finish within a second after the last event hangs
+    const qint64 timeoutMs = macro.last().atNs / 1000000 + 1000;
+    for (int r = 0; r < repeats; r++) {
+        if (!player.trigger(0)) {
+            fprintf(stderr, "rtyonctl: macro trigger %d failed\n", r + 1);
+            player.close();
+            return RTCTL_FAILED;
+        }
+        const QDeadlineTimer deadline(timeoutMs, Qt::PreciseTimer);
+        while (player.statistics().plays <= (quint64) r) {
+            if (deadline.hasExpired()) {
+                fprintf(stderr, "rtyonctl: macro play %d did not finish within %lld ms\n", r + 1, (long long) timeoutMs);
+                player.close();
+                return RTCTL_FAILED;
+            }
+            QThread::msleep(1);
+        }
+    }
+    player.close();
+
+    const RTMacroPlayer::TStatistics s = player.statistics();
+    printf("events %llu, failures %llu, %s\n", //
+           (unsigned long long) s.events,
+           (unsigned long long) s.failures,
+           s.realtime ? "SCHED_FIFO" : "normal scheduling");
+    printf("timing error: mean %.1f us, p50 %.0f us, p99 %.0f us, max %.1f us\n", s.meanUs, s.p50Us, s.p99Us, s.maxUs);
+    return (s.failures > 0 ? RTCTL_FAILED : RTCTL_OK);
+}
+
+static void printPollRate(const RTPollRateAnalyzer *analyzer)
+{
+    const RTPollRateAnalyzer::TStatistics s = analyzer->statistics();
+    printf("reports %llu, intervals %llu, pauses %llu\n", //
+           (unsigned long long) s.reports,
+           (unsigned long long) s.intervals,
+           (unsigned long long) s.gaps);
+    if (s.intervals == 0) {
+        return;
+    }
+    printf("rate %.1f Hz on a %d Hz grid, missed %llu, early %llu\n", //
+           s.rateHz,
+           s.nominalHz,
+           (unsigned long long) s.late,
+           (unsigned long long) s.early);
+    printf("interval: mean %.1f us, sd %.1f us, min %.1f us, p1 %.0f us, p50 %.0f us, p99 %.0f us, p99.9 %.0f us, max %.1f us\n",
+           s.meanUs,
+           s.stddevUs,
+           s.minUs,
+           s.p1Us,
+           s.p50Us,
+           s.p99Us,
+           s.p999Us,
+           s.maxUs);
+    printf("jitter: p50 %.0f us, p99 %.0f us, max %.0f us\n", s.jitterP50Us, s.jitterP99Us, s.jitterMaxUs);
+
+    // +-10 % around the polling period
+    const int period = 1000000 / s.nominalHz;
+    const int binUs = qMax(period / 100, 1);
+    const QList<quint64> bins = analyzer->histogram(period - 10 * binUs - binUs / 2, binUs, 21);
+    quint64 peak = 1;
+    for (quint64 n : bins) {
+        peak = qMax(peak, n);
+    }
+    for (qsizetype b = 0; b < bins.count(); b++) {
+        printf("%6d us %10llu %s\n", //
+               period + (int) (b - 10) * binUs,
+               (unsigned long long) bins[b],
+               qPrintable(QString((qsizetype) (bins[b] * 50 / peak), QChar('#'))));
+    }
+}
+
+static int doPollRate(const QStringList &args)
+{
+    bool ok = (args.size() <= 1);
+    int seconds = 10;
+    if (ok && args.size() == 1) {
+        seconds = toNumber(args[0], 1, 86400, ok);
+    }
+    if (!ok) {
+        fprintf(stderr, "usage: rtyonctl pollrate [seconds]\n");
+        return RTCTL_USAGE;
+    }
+
+    RTPollRateAnalyzer analyzer;
+    QString error;
+    if (!analyzer.open(QString(), &error)) {
+        fprintf(stderr, "rtyonctl: %s\n", qPrintable(error));
+        return RTCTL_FAILED;
+    }
+
+    printf("move the mouse fast for %d s\n", seconds);
+    QEventLoop loop;
+    QTimer::singleShot(seconds * 1000, &loop, &QEventLoop::quit);
+    loop.exec();
+    analyzer.close();
+
+    printPollRate(&analyzer);
+    return (analyzer.statistics().intervals > 0 ? RTCTL_OK : RTCTL_FAILED);
+}
+
+static int doPollReplay(const QStringList &args)
+{
+    if (args.isEmpty()) {
+        fprintf(stderr, "usage: rtyonctl pollreplay <file>...\n");
+        return RTCTL_USAGE;
+    }
+
+    int rc = RTCTL_OK;
+    for (const QString &fileName : args) {
+        RTPollRateAnalyzer analyzer;
+        QString error;
+        if (!analyzer.replay(fileName, &error)) {
+            fprintf(stderr, "rtyonctl: %s\n", qPrintable(error));
+            rc = RTCTL_FAILED;
+            continue;
+        }
+        if (args.size() > 1) {
+            printf("%s:\n", qPrintable(fileName));
+        }
+        printPollRate(&analyzer);
+    }
+    return rc;
+}
+
+static int doAnalyze(const QStringList &args, bool showMap)
+{
+    if (args.isEmpty()) {
+        fprintf(stderr, "usage: rtyonctl [--map] analyze <file.rtfl>...\n");
+        return RTCTL_USAGE;
+    }
+
+    int rc = RTCTL_OK;
+    printf("%-24s %7s %7s %6s %7s %7s %7s %7s %9s %8s %4s %4s\n",
+           "log", "frames", "secs", "fps", "mean", "median", "spatial", "tempor.", "drift/s", "drift", "dcu", "tcu");
+    for (const QString &fileName : args) {
+        RTFrameLog log;
+        RTFrameAnalyzer::TResult r;
+        if (!log.openRead(fileName)) {
+            fprintf(stderr, "rtyonctl: %s\n", qPrintable(log.errorString()));
+            rc = RTCTL_FAILED;
+            continue;
+        }
+        if (!RTFrameAnalyzer::analyze(log, &r)) {
+            fprintf(stderr, "rtyonctl: %s: no frames\n", qPrintable(fileName));
+            rc = RTCTL_FAILED;
+            continue;
+        }
+        const RTFrameAnalyzer::TFrameSummary &last = r.perFrame.last();
+        printf("%-24s %7llu %7.1f %6.1f %7.2f %7.2f %7.3f %7.3f %9.4f %8.3f %4d %4d\n",
+               qPrintable(QFileInfo(fileName).fileName()),
+               (unsigned long long) r.frames,
+               r.duration,
+               r.fps,
+               r.mean,
+               r.median,
+               r.spatialNoise,
+               r.temporalNoise,
+               r.drift,
+               r.driftTotal,
+               last.dcu,
+               last.tcu);
+
+        if (showMap) {
+            printf("per-pixel variance:\n");
+            for (int y = 0; y < TYON_SENSOR_IMAGE_SIZE; y++) {
+                for (int x = 0; x < TYON_SENSOR_IMAGE_SIZE; x++) {
+                    printf("%6.2f", r.pixelVariance[y * TYON_SENSOR_IMAGE_SIZE + x]);
+                }
+                printf("\n");
+            }
+        }
+    }
+    return rc;
+}
+
+// -------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    RTTiming timing;
+
+    // same names as the GUI to share profiles.rtpf
+    QCoreApplication::setOrganizationName(QStringLiteral("EoF Software Labs"));
+    QCoreApplication::setApplicationName(QStringLiteral("ROCCAT Tyon Control"));
+    QCoreApplication::setApplicationVersion(QStringLiteral("1.0.0"));
+
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("ROCCAT Tyon command line control"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOption({QStringLiteral("timing"), QStringLiteral("Print a timing breakdown to stderr.")});
+    parser.addOption({QStringLiteral("profile"), QStringLiteral("Target profile 1-5."), QStringLiteral("index")});
+    parser.addOption({QStringLiteral("map"), QStringLiteral("analyze: print the per-pixel variance map.")});
+    parser.addOption({QStringLiteral("store"), QStringLiteral("sweep: store the recommended DCU/TCU setting.")});
+    parser.addOption({QStringLiteral("fast"), QStringLiteral("Write single reports without the status check before.")});
+    parser.addPositionalArgument(QStringLiteral("command"),
+                                 QStringLiteral("apply <file> | switch <n> | set dpi <slot> <value> | set active-dpi <slot> | dump"
+                                                " | record <file> [frames] | analyze <file>... | sweep [frames]"
+                                                " | regs [dump | diff <file> | get <reg>... | set <reg> <value>...]"
+                                                " | xcreplay <file> | joystick [seconds] | events [seconds]"
+                                                " | hotkeys [seconds] | talkfx [seconds] | macro <file> [repeats]"
+                                                " | focusreplay <file>"
+                                                " | pollrate [seconds] | pollreplay <file>..."));
+    parser.process(a);
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        parser.showHelp(RTCTL_USAGE);
+    }
+    const QString command = args.takeFirst();
+    timing.setEnabled(parser.isSet(QStringLiteral("timing")));
+
+    int profile = 0;
+    if (parser.isSet(QStringLiteral("profile"))) {
+        bool ok = false;
+        profile = toNumber(parser.value(QStringLiteral("profile")), 1, TYON_PROFILE_NUM, ok);
+        if (!ok) {
+            fprintf(stderr, "rtyonctl: invalid profile\n");
+            return RTCTL_USAGE;
+        }
+    }
+
+    // offline, no device needed
+    if (command == QStringLiteral("analyze")) {
+        return finish(timing, "analyze", doAnalyze(args, parser.isSet(QStringLiteral("map"))));
+    }
+    if (command == QStringLiteral("xcreplay")) {
+        return finish(timing, "xcreplay", doXcReplay(args));
+    }
+    if (command == QStringLiteral("macro")) {
+        return finish(timing, "macro", doMacro(args));
+    }
+    // reads the mouse event node, not the HID control interface
+    if (command == QStringLiteral("pollrate")) {
+        return finish(timing, "pollrate", doPollRate(args));
+    }
+    if (command == QStringLiteral("pollreplay")) {
+        return finish(timing, "pollreplay", doPollReplay(args));
+    }
+
+    RTController controller;
+    controller.setSyncOnConnect(false);
+    controller.setAutoSave(false);
+    controller.setFastWrites(parser.isSet(QStringLiteral("fast")));
+    timing.mark("init");
+
+    int rc = RTCTL_NODEVICE;
+    bool found = false;
+    bool failed = false;
+
+    // errors are printed right away, a lookup failure ends the event loop
+    QObject::connect(&controller, &RTController::deviceError, &a, [&](int error, const QString &message) {
+        fprintf(stderr, "rtyonctl: %s (0x%x)\n", qPrintable(message), error);
+        failed = true;
+    });
+    QObject::connect(
+        &controller,
+        &RTController::deviceError,
+        &a,
+        [&]() {
+            if (!found) {
+                a.exit(RTCTL_NODEVICE);
+            }
+        },
+        Qt::QueuedConnection);
+    QObject::connect(
+        &controller,
+        &RTController::deviceFound,
+        &a,
+        [&]() {
+            if (found) {
+                return;
+            }
+            found = true;
+            timing.mark("lookup");
+            if (command == QStringLiteral("switch")) {
+                rc = doSwitch(&controller, args);
+            } else if (command == QStringLiteral("set")) {
+                rc = doSet(&controller, args, profile);
+            } else if (command == QStringLiteral("apply")) {
+                rc = doApply(&controller, args, profile, failed);
+            } else if (command == QStringLiteral("dump")) {
+                rc = doDump(&controller);
+            } else if (command == QStringLiteral("record")) {
+                rc = doRecord(&controller, args);
+            } else if (command == QStringLiteral("events")) {
+                rc = doEvents(&controller, args);
+            } else if (command == QStringLiteral("joystick")) {
+                rc = doJoystick(&controller, args);
+            } else if (command == QStringLiteral("hotkeys")) {
+                rc = doHotkeys(&controller, args);
+            } else if (command == QStringLiteral("focusreplay")) {
+                rc = doFocusReplay(&controller, args);
+            } else if (command == QStringLiteral("talkfx")) {
+                rc = doTalkFx(&controller, args);
+            } else if (command == QStringLiteral("regs")) {
+                rc = doRegs(&controller, args);
+            } else if (command == QStringLiteral("sweep")) {
+                rc = doSweep(&controller, args, parser.isSet(QStringLiteral("store")));
+            } else {
+                fprintf(stderr, "rtyonctl: unknown command '%s'\n", qPrintable(command));
+                rc = RTCTL_USAGE;
+            }
+            timing.mark(qPrintable(command));
+            a.exit(rc);
+        },
+        Qt::QueuedConnection);
+
+    // Linux finishes the lookup right away, macOS reports the device
+    // from its run loop and a missing one by the deadline only
+    auto noDevice = [&a, &found]() {
+        if (!found) {
+            fprintf(stderr, "rtyonctl: no ROCCAT Tyon found\n");
+            a.exit(RTCTL_NODEVICE);
+        }
+    };
+    QObject::connect(
+        &controller,
+        &RTController::lookupFinished,
+        &a,
+        [noDevice](bool ok) {
+            if (!ok) {
+                noDevice();
+            }
+        },
+        Qt::QueuedConnection);
+    QTimer::singleShot(3000, &a, noDevice);
+
+    controller.lookupDevice();
+    rc = a.exec();
+
+    if (timing.isEnabled()) {
+        const RTTransaction::TStatistics stats = controller.transactionStatistics();
+        timing.print();
+        fprintf(stderr,
+                "timing: %u round trips in %u transactions (%u with a check per select and write)\n",
+                stats.checks + stats.reports,
+                stats.transactions,
+                stats.legacy);
+        if (controller.fastWrites()) {
+            fprintf(stderr, "timing: %u speculative writes, %u retried\n", stats.speculative, stats.retries);
+        }
+        const RTRequestScheduler::TStatistics sched = controller.requestStatistics();
+        for (int p = RTRequestScheduler::Interactive; p < RTRequestScheduler::PriorityCount; p++) {
+            const RTRequestScheduler::TClassStatistics &c = sched.classes[p];
+            if (c.steps == 0) {
+                continue;
+            }
+            fprintf(stderr,
+                    "timing: %-11s %4u steps, wait avg %.2f max %.2f ms, step max %.2f ms\n",
+                    RTRequestScheduler::name((RTRequestScheduler::TPriority) p),
+                    c.steps,
+                    c.waitTotal / 1000.0 / c.steps,
+                    c.waitMax / 1000.0,
+                    c.holdMax / 1000.0);
+        }
+    }
+    return rc;
+}
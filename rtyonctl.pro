@@ -0,0 +1,29 @@
+# ROCCAT Tyon one-shot command line tool
+# Usage: rtyonctl [--timing] apply <file> | switch <n> | set dpi <slot> <value> | dump
+QT  = core
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = rtyonctl
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+include(rtcore.pri)
+
+target.path = /usr/local/bin
+INSTALLS += target
+
+SOURCES += \
+    rtcalibrationsweep.cpp \
+    rtframeanalyzer.cpp \
+    rtpollrateanalyzer.cpp \
+    rtprofilerules.cpp \
+    rtyonctl.cpp
+
+HEADERS += \
+    rtcalibrationsweep.h \
+    rtframeanalyzer.h \
+    rtpollrateanalyzer.h \
+    rtprofilerules.h
@@ -0,0 +1,171 @@
+// ********************************************************************
+// Copyright © 2025 by EoF Software Labs
+// Copyright © 2024 Apple Inc. (some copied parts)
+// Copyright by libgaminggear Project (some copied parts)
+// Copyright by roccat-tools Project (some copied parts)
+// SPDX-License-Identifier: GPL-3.0
+// ********************************************************************
+#include "rtcontroller.h"
+#include "rtdbusadaptor.h"
+#include "rtfocuswatcher.h"
+#include "rtnotificationbridge.h"
+#include "rtprofilerules.h"
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusError>
+#include <QDir>
+#include <QSettings>
+#include <QSocketNotifier>
+#include <QStandardPaths>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// SIGTERM/SIGINT are forwarded through a socket pair into the event
+// loop, so the controller can save profiles on the way out.
+static int s_signalFd[2] = {-1, -1};
+
+static void signalHandler(int)
+{
+    char c = 1;
+    if (::write(s_signalFd[0], &c, sizeof(c)) < 0) {
+        // nothing we can do in a signal handler
+    }
+}
+
+static bool installSignalHandlers(QCoreApplication *app)
+{
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, s_signalFd)) {
+        return false;
+    }
+
+    QSocketNotifier *sn = new QSocketNotifier(s_signalFd[1], QSocketNotifier::Read, app);
+    QObject::connect(sn, &QSocketNotifier::activated, app, [sn]() { //
+        char c;
+        sn->setEnabled(false);
+        if (::read(s_signalFd[1], &c, sizeof(c)) > 0) {
+            QCoreApplication::quit();
+        }
+    });
+
+    struct sigaction sa = {};
+    sa.sa_handler = signalHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT, &sa, nullptr);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    setenv("QT_MESSAGE_PATTERN", "[T:%{threadid}] %{message}", 0);
+
+    // same names as the GUI, both share profiles.rtpf and settings.conf
+    QCoreApplication::setOrganizationName(QStringLiteral("EoF Software Labs"));
+    QCoreApplication::setApplicationName(QStringLiteral("ROCCAT Tyon Control"));
+    QCoreApplication::setApplicationVersion(QStringLiteral("1.0.0"));
+
+    QCoreApplication a(argc, argv);
+    installSignalHandlers(&a);
+
+    qRegisterMetaType<TyonLight>();
+
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    if (!bus.isConnected()) {
+        qCritical("[TYOND] Unable to connect to session bus: %s", qPrintable(bus.lastError().message()));
+        return 1;
+    }
+
+    RTController controller;
+    new RTDBusAdaptor(&controller);
+
+    if (!bus.registerObject(QStringLiteral(RT_DBUS_PATH), &controller, QDBusConnection::ExportAdaptors)) {
+        qCritical("[TYOND] Unable to register object %s", RT_DBUS_PATH);
+        return 1;
+    }
+    if (!bus.registerService(QStringLiteral(RT_DBUS_SERVICE))) {
+        qCritical("[TYOND] Service %s already running? %s", RT_DBUS_SERVICE, qPrintable(bus.lastError().message()));
+        return 1;
+    }
+
+    // optional automatic profile switching
+    QString fpath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+    QSettings settings(QDir::toNativeSeparators(fpath + "/settings.conf"), QSettings::Format::NativeFormat);
+    RTProfileRules rules;
+    rules.load(&settings);
+
+    // single report writes without the status check before (opt-in)
+    controller.setFastWrites(settings.value("device/fastWrites", false).toBool());
+
+    // X-Celerator as virtual gamepad axis
+    RTXCJoystick::TConfig joystick;
+    if (RTXCJoystick::loadConfig(&settings, &joystick)) {
+        controller.setXcJoystick(true, joystick);
+    }
+
+    // keyboard triggered Easyshift and EasyAim
+    RTHotkeyListener::TConfig hotkeys;
+    if (RTHotkeyListener::loadConfig(&settings, &hotkeys)) {
+        controller.setHotkeys(true, hotkeys);
+    }
+
+    // host macros on Quick launch buttons
+    RTMacroPlayer::TConfig macros;
+    if (RTMacroPlayer::loadConfig(&settings, &macros)) {
+        controller.setMacros(true, macros);
+    }
+
+    // host driven TalkFX lights, the external level is set over D-Bus
+    RTTalkFxEngine::TConfig talkFx;
+    if (RTTalkFxEngine::loadConfig(&settings, &talkFx)) {
+        controller.setTalkFx(true, talkFx);
+    }
+
+    // TalkFX flashes for desktop notifications and custom signals
+    RTNotificationBridge bridge(&controller);
+    RTNotificationBridge::TConfig notify;
+    if (RTNotificationBridge::loadConfig(&settings, &notify)) {
+        if (!controller.isTalkFxRunning()) {
+            // flashes only, the profile lights stay in between
+            RTTalkFxEngine::TConfig flashes = RTTalkFxEngine::defaultConfig();
+            flashes.source = RTTalkFxEngine::Events;
+            controller.setTalkFx(true, flashes);
+        }
+        QString error;
+        if (!bridge.open(notify, &error)) {
+            qWarning("[TYOND] Notification flashes disabled: %s", qPrintable(error));
+        }
+    }
+
+    RTFocusWatcher *watcher = nullptr;
+    if (!rules.isEmpty() && (watcher = RTFocusWatcher::create(&a))) {
+        QObject::connect(watcher, &RTFocusWatcher::focusChanged, &controller, [&controller, &rules](qint64, const QString &program, qint64 timestamp) {
+            const int pix = rules.profileOf(program);
+            if (pix >= 0 && controller.hasDevice() && pix != controller.activeProfileIndex()) {
+                controller.activateProfile(pix, timestamp);
+            }
+        });
+        watcher->start();
+    }
+
+    qInfo("[TYOND] Service %s ready", RT_DBUS_SERVICE);
+    controller.lookupDevice();
+
+    int rc = a.exec();
+
+    if (watcher) {
+        watcher->stop();
+    }
+    const RTNotificationBridge::TStatistics ns = bridge.statistics();
+    if (ns.received > 0) {
+        qInfo("[TYOND] Notifications: %llu received, %llu merged, %llu dropped, %llu flashes", //
+              (unsigned long long) ns.received,
+              (unsigned long long) ns.merged,
+              (unsigned long long) ns.dropped,
+              (unsigned long long) ns.flashes);
+    }
+    bridge.close();
+    bus.unregisterService(QStringLiteral(RT_DBUS_SERVICE));
+    return rc;
+}
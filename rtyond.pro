@@ -0,0 +1,45 @@
+# ROCCAT Tyon resident daemon, D-Bus service org.eof.tools.RoccatTyon
+# Runs RTController on a QCoreApplication, no QtGui and no QtWidgets.
+QT  = core
+QT += dbus
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = rtyond
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+include(rtcore.pri)
+
+mac {
+    target.path = /usr/local/bin
+    INSTALLS += target
+}
+
+linux {
+    LIBS += -lxcb
+    SOURCES += rtfocuswatcherx11.cpp
+    HEADERS += rtfocuswatcherx11.h
+
+    service.files = $$PWD/assets/dbus/org.eof.tools.RoccatTyon.service
+    service.path = /usr/share/dbus-1/services
+    INSTALLS += service
+
+    target.path = /usr/local/bin
+    INSTALLS += target
+}
+
+SOURCES += \
+    rtdbusadaptor.cpp \
+    rtfocuswatcher.cpp \
+    rtnotificationbridge.cpp \
+    rtprofilerules.cpp \
+    rtyond.cpp
+
+HEADERS += \
+    rtdbusadaptor.h \
+    rtfocuswatcher.h \
+    rtnotificationbridge.h \
+    rtprofilerules.h